@@ -23,18 +23,62 @@
 
 #include <fty_asset_dto.h>
 #include <fty/expected.h>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace fty
 {
+    /// Requests to the asset agent
+    ///
+    /// All the requests of the process share one persistent message bus connection, many of them may be in
+    /// flight at the same time. Asynchronous variants return a future or call back from the message bus
+    /// thread; callbacks must not wait for another request. Requests fail after 5 seconds without reply.
     class AssetAccessor
     {
     public:
         static fty::Expected<uint32_t> assetInameToID(const std::string& iname);
+        static std::future<fty::Expected<uint32_t>> assetInameToIDAsync(const std::string& iname);
+        static void assetInameToIDAsync(const std::string& iname, std::function<void(fty::Expected<uint32_t>)> callback);
+
         static fty::Expected<fty::Asset> getAsset(const std::string& iname);
+        /// encoding is ENCODING_JSON or ENCODING_PROTOBUF, reply is decoded from the encoding the agent used
+        static fty::Expected<fty::Asset> getAsset(const std::string& iname, const std::string& encoding);
+        static std::future<fty::Expected<fty::Asset>> getAssetAsync(const std::string& iname,
+            const std::string& encoding = ENCODING_JSON);
+        static void getAssetAsync(const std::string& iname, const std::string& encoding,
+            std::function<void(fty::Expected<fty::Asset>)> callback);
+
+        /// one request for many assets, assets not found are missing from the result
+        static fty::Expected<std::map<std::string, uint32_t>> assetInamesToIDs(const std::vector<std::string>& inames);
+        static fty::Expected<std::vector<fty::Asset>> getAssets(const std::vector<std::string>& inames,
+            const std::string& encoding = ENCODING_JSON);
+
         static void notifyStatusUpdate(const std::string& iname, const std::string& oldStatus, const std::string& newStatus);
         static void notifyAssetUpdate(const Asset& oldAsset, const Asset& newAsset);
+
+        struct CacheStats
+        {
+            uint64_t hits          = 0;
+            uint64_t misses        = 0;
+            uint64_t invalidations = 0;
+            uint64_t evictions     = 0;
+            size_t   size          = 0;
+        };
+
+        /// Opt-in cache of getAsset() and assetInameToID() replies, by internal name
+        ///
+        /// Keeps at most `capacity` assets, least recently used first out. Entries are invalidated by the
+        /// asset notifications (FTY.T.ASSET_LIGHT.*) and are kept at most `maxAge`, for changes made
+        /// without notification. Fails if the notifications cannot be subscribed: the cache stays disabled.
+        static fty::Expected<void> enableCache(
+            size_t capacity = 1024, std::chrono::seconds maxAge = std::chrono::seconds(300));
+        static void disableCache();
+        static CacheStats cacheStats();
     };
 
 } // namespace fty
@@ -0,0 +1,157 @@
+/*  =========================================================================
+    accessor-cache - Client side cache of asset agent replies
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "accessor-cache.h"
+
+namespace fty
+{
+    AccessorCache::AccessorCache(size_t capacity, Clock::duration maxAge)
+        : m_capacity(capacity ? capacity : 1)
+        , m_maxAge(maxAge)
+    {
+    }
+
+    std::optional<uint32_t> AccessorCache::findId(const std::string& iname)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry* entry = find(iname);
+        if (entry && entry->id && Clock::now() - entry->idTime < m_maxAge)
+        {
+            ++m_stats.hits;
+            return entry->id;
+        }
+        ++m_stats.misses;
+        return std::nullopt;
+    }
+
+    std::optional<fty::Asset> AccessorCache::findAsset(const std::string& iname)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry* entry = find(iname);
+        if (entry && entry->asset && Clock::now() - entry->assetTime < m_maxAge)
+        {
+            ++m_stats.hits;
+            return entry->asset;
+        }
+        ++m_stats.misses;
+        return std::nullopt;
+    }
+
+    uint64_t AccessorCache::epoch() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_epoch;
+    }
+
+    void AccessorCache::storeId(const std::string& iname, uint32_t id, uint64_t epoch)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (Entry* entry = store(iname, epoch))
+        {
+            entry->id     = id;
+            entry->idTime = Clock::now();
+        }
+    }
+
+    void AccessorCache::storeAsset(const std::string& iname, const fty::Asset& asset, uint64_t epoch)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (Entry* entry = store(iname, epoch))
+        {
+            entry->asset     = asset;
+            entry->assetTime = Clock::now();
+        }
+    }
+
+    void AccessorCache::invalidate(const std::string& iname)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_epoch;
+        auto found = m_index.find(iname);
+        if (found != m_index.end())
+        {
+            ++m_stats.invalidations;
+            m_entries.erase(found->second);
+            m_index.erase(found);
+        }
+    }
+
+    void AccessorCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_epoch;
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    AssetAccessor::CacheStats AccessorCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        AssetAccessor::CacheStats stats = m_stats;
+        stats.size = m_index.size();
+        return stats;
+    }
+
+    AccessorCache::Entry* AccessorCache::find(const std::string& iname)
+    {
+        auto found = m_index.find(iname);
+        if (found == m_index.end())
+        {
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return &*found->second;
+    }
+
+    AccessorCache::Entry* AccessorCache::store(const std::string& iname, uint64_t epoch)
+    {
+        // invalidated while the request was in flight, the reply may be older than the notification
+        if (epoch != m_epoch)
+        {
+            return nullptr;
+        }
+
+        if (Entry* entry = find(iname))
+        {
+            return entry;
+        }
+
+        m_entries.push_front(Entry{iname, std::nullopt, {}, std::nullopt, {}});
+        m_index.emplace(iname, m_entries.begin());
+
+        if (m_index.size() > m_capacity)
+        {
+            ++m_stats.evictions;
+            m_index.erase(m_entries.back().iname);
+            m_entries.pop_back();
+        }
+
+        return &m_entries.front();
+    }
+
+} // namespace fty
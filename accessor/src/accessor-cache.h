@@ -0,0 +1,82 @@
+/*  =========================================================================
+    accessor-cache - Client side cache of asset agent replies
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "fty_asset_accessor.h"
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace fty
+{
+    /// Bounded LRU cache of assets and asset ids, by internal name
+    ///
+    /// Entries are invalidated by the asset notifications and expire after maxAge, as a safety net for
+    /// changes which are not notified. A reply is stored only if no invalidation happened since its request
+    /// was sent (see epoch()): the notification may have been received before a stale reply.
+    class AccessorCache
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        AccessorCache(size_t capacity, Clock::duration maxAge);
+
+        std::optional<uint32_t>   findId(const std::string& iname);
+        std::optional<fty::Asset> findAsset(const std::string& iname);
+
+        /// to be taken before sending a request, and passed to store
+        uint64_t epoch() const;
+
+        void storeId(const std::string& iname, uint32_t id, uint64_t epoch);
+        void storeAsset(const std::string& iname, const fty::Asset& asset, uint64_t epoch);
+
+        void invalidate(const std::string& iname);
+        void clear();
+
+        AssetAccessor::CacheStats stats() const;
+
+    private:
+        struct Entry
+        {
+            std::string                iname;
+            std::optional<uint32_t>    id;
+            Clock::time_point          idTime;
+            std::optional<fty::Asset>  asset;
+            Clock::time_point          assetTime;
+        };
+        using Entries = std::list<Entry>;
+
+        Entry* find(const std::string& iname);
+        Entry* store(const std::string& iname, uint64_t epoch);
+
+        size_t                                             m_capacity;
+        Clock::duration                                    m_maxAge;
+        mutable std::mutex                                 m_mutex;
+        Entries                                            m_entries; // most recently used first
+        std::unordered_map<std::string, Entries::iterator> m_index;
+        uint64_t                                           m_epoch = 0;
+        AssetAccessor::CacheStats                          m_stats;
+    };
+
+} // namespace fty
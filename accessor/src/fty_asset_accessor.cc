@@ -20,16 +20,25 @@
 */
 
 #include "fty_asset_accessor.h"
+#include "accessor-cache.h"
 
+#include <cxxtools/base64codec.h>
 #include <cxxtools/serializationinfo.h>
 
 #include <fty_common.h>
 #include <fty_common_messagebus.h>
 #include <fty/convert.h>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 #define RECV_TIMEOUT 5  // messagebus request timeout
 
@@ -40,108 +49,686 @@ namespace fty
     static constexpr const char *ACCESSOR_NAME = "fty-asset-accessor";
     static constexpr const char *ENDPOINT = "ipc://@/malamute";
 
-    /// static helper to send a MessageBus synchronous request
-    static messagebus::Message sendSyncReq(const std::string& command, messagebus::UserData data)
+    // light notifications carry only the internal name
+    static constexpr const char *ASSET_TOPICS[] = {
+        "FTY.T.ASSET_LIGHT.CREATED", "FTY.T.ASSET_LIGHT.UPDATED", "FTY.T.ASSET_LIGHT.DELETED"};
+
+    using ReplyCallback = std::function<void(fty::Expected<messagebus::Message>)>;
+
+    /// Message bus session shared by all the requests of the process
+    ///
+    /// The connection is opened on first use and kept. Requests are sent without waiting, replies are
+    /// dispatched to the pending request with the same correlation id. Requests without reply after
+    /// RECV_TIMEOUT seconds get a timeout error. The connection is dropped when a send fails or a request
+    /// times out, the next request reconnects.
+    class AccessorSession
     {
-        // generate unique ID interface
-        std::stringstream ss;
-        ss << ACCESSOR_NAME << "-" << std::setfill('0') << std::setw(sizeof(pid_t)*2) << std::hex << std::this_thread::get_id();
+    public:
+        static AccessorSession& instance()
+        {
+            static AccessorSession session;
+            return session;
+        }
+
+        /// sends a request, onReply is called once with the reply or an error
+        /// it is called from the message bus thread: it must not wait for another request
+        void request(const std::string& command, messagebus::UserData data, const messagebus::MetaData& metaData,
+            ReplyCallback onReply)
+        {
+            messagebus::Message msg = buildMessage(command, std::move(data), metaData);
+            const std::string corrId = msg.metaData().at(messagebus::Message::CORRELATION_ID);
+
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                m_pending.emplace(corrId,
+                    Pending{std::chrono::steady_clock::now() + std::chrono::seconds(RECV_TIMEOUT), std::move(onReply)});
+            }
+            m_pendingCond.notify_one();
+
+            try
+            {
+                send(msg);
+            }
+            catch (const std::exception &e)
+            {
+                if (ReplyCallback callback = takePending(corrId))
+                {
+                    callback(fty::unexpected(e.what()));
+                }
+            }
+        }
+
+        /// sends a request without waiting for a reply
+        void notify(const std::string& command, messagebus::UserData data)
+        {
+            send(buildMessage(command, std::move(data), {}));
+        }
+
+        /// subscribes to a topic on the session connection, connects if needed
+        void subscribe(const std::string& topic, messagebus::MessageListener listener)
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+
+            if (m_interface)
+            {
+                m_interface->subscribe(topic, listener);
+            }
+            m_subscriptions.emplace_back(topic, std::move(listener));
+            if (!m_interface)
+            {
+                try
+                {
+                    connect();
+                }
+                catch (...)
+                {
+                    m_subscriptions.pop_back();
+                    throw;
+                }
+            }
+        }
+
+        /// cache of the replies, null if disabled
+        std::shared_ptr<AccessorCache> cache() const
+        {
+            return std::atomic_load(&m_cache);
+        }
+
+        void setCache(std::shared_ptr<AccessorCache> cache)
+        {
+            std::atomic_store(&m_cache, std::move(cache));
+        }
+
+    private:
+        struct Pending
+        {
+            std::chrono::steady_clock::time_point deadline;
+            ReplyCallback                         onReply;
+        };
+
+        AccessorSession()
+            : m_clientName(std::string(ACCESSOR_NAME) + "-" + std::to_string(getpid()))
+            , m_timeouts([this]() { expirePending(); })
+        {
+        }
+
+        ~AccessorSession()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                m_stop = true;
+            }
+            m_pendingCond.notify_one();
+            m_timeouts.join();
+
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            m_interface.reset();
+        }
+
+        messagebus::Message buildMessage(const std::string& command, messagebus::UserData data,
+            const messagebus::MetaData& metaData) const
+        {
+            messagebus::Message msg;
+
+            msg.metaData().emplace(messagebus::Message::CORRELATION_ID, messagebus::generateUuid());
+            msg.metaData().emplace(messagebus::Message::SUBJECT, command);
+            msg.metaData().emplace(messagebus::Message::FROM, m_clientName);
+            msg.metaData().emplace(messagebus::Message::TO, ASSET_AGENT);
+            msg.metaData().emplace(messagebus::Message::REPLY_TO, m_clientName);
+            msg.metaData().insert(metaData.begin(), metaData.end());
 
-        std::string clientName = ss.str();
+            msg.userData() = std::move(data);
 
-        std::unique_ptr<messagebus::MessageBus> interface(messagebus::MlmMessageBus(ENDPOINT, clientName));
-        messagebus::Message msg;
+            return msg;
+        }
 
-        interface->connect();
+        /// with m_sendMutex locked
+        void connect()
+        {
+            std::unique_ptr<messagebus::MessageBus> interface(messagebus::MlmMessageBus(ENDPOINT, m_clientName));
+            interface->connect();
+            // all the replies come to the client mailbox
+            interface->receive(m_clientName, [this](messagebus::Message reply) { dispatch(reply); });
+            for (const auto& subscription : m_subscriptions)
+            {
+                interface->subscribe(subscription.first, subscription.second);
+            }
+            // kept only once connected, next request retries otherwise
+            m_interface = std::move(interface);
+        }
+
+        void send(const messagebus::Message& msg)
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+
+            // a request timed out, the connection may be broken
+            if (m_reconnect.exchange(false))
+            {
+                m_interface.reset();
+            }
+
+            if (!m_interface)
+            {
+                connect();
+            }
+
+            try
+            {
+                m_interface->sendRequest(ASSET_AGENT_QUEUE, msg);
+            }
+            catch (...)
+            {
+                m_interface.reset();
+                throw;
+            }
+        }
 
-        msg.metaData().emplace(messagebus::Message::CORRELATION_ID, messagebus::generateUuid());
-        msg.metaData().emplace(messagebus::Message::SUBJECT, command);
-        msg.metaData().emplace(messagebus::Message::FROM, clientName);
-        msg.metaData().emplace(messagebus::Message::TO, ASSET_AGENT);
-        msg.metaData().emplace(messagebus::Message::REPLY_TO, clientName);
+        ReplyCallback takePending(const std::string& corrId)
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+            auto it = m_pending.find(corrId);
+            if (it == m_pending.end())
+            {
+                return {};
+            }
+            ReplyCallback callback = std::move(it->second.onReply);
+            m_pending.erase(it);
+            return callback;
+        }
 
-        msg.userData() = data;
+        void dispatch(const messagebus::Message& reply)
+        {
+            auto it = reply.metaData().find(messagebus::Message::CORRELATION_ID);
+            if (it == reply.metaData().end())
+            {
+                log_debug("Reply without correlation id dropped");
+                return;
+            }
+
+            if (ReplyCallback callback = takePending(it->second))
+            {
+                // the callback decodes the reply: an exception here would leave the bus thread
+                try
+                {
+                    callback(reply);
+                }
+                catch (const std::exception& e)
+                {
+                    log_error("Reply %s not handled: %s", it->second.c_str(), e.what());
+                }
+            }
+            else
+            {
+                // late reply of a timed out request, or reply to a notification
+                log_debug("No pending request for reply %s", it->second.c_str());
+            }
+        }
 
-        return interface->request(ASSET_AGENT_QUEUE, msg, RECV_TIMEOUT);
+        void expirePending()
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+
+            while (!m_stop)
+            {
+                if (m_pending.empty())
+                {
+                    m_pendingCond.wait(lock);
+                    continue;
+                }
+
+                auto now = std::chrono::steady_clock::now();
+                auto next = std::chrono::steady_clock::time_point::max();
+                std::vector<ReplyCallback> expired;
+
+                for (auto it = m_pending.begin(); it != m_pending.end();)
+                {
+                    if (it->second.deadline <= now)
+                    {
+                        expired.push_back(std::move(it->second.onReply));
+                        it = m_pending.erase(it);
+                    }
+                    else
+                    {
+                        next = std::min(next, it->second.deadline);
+                        ++it;
+                    }
+                }
+
+                if (!expired.empty())
+                {
+                    m_reconnect = true;
+                    lock.unlock();
+                    for (auto& callback : expired)
+                    {
+                        callback(fty::unexpected("Request timed out"));
+                    }
+                    lock.lock();
+                    continue;
+                }
+
+                m_pendingCond.wait_until(lock, next);
+            }
+        }
+
+        const std::string                       m_clientName;
+
+        std::mutex                                                          m_sendMutex;
+        std::unique_ptr<messagebus::MessageBus>                             m_interface;
+        std::atomic<bool>                                                   m_reconnect{false};
+        std::vector<std::pair<std::string, messagebus::MessageListener>>  m_subscriptions;
+
+        std::shared_ptr<AccessorCache> m_cache;
+
+        std::mutex                               m_pendingMutex;
+        std::condition_variable                  m_pendingCond;
+        std::unordered_map<std::string, Pending> m_pending;
+        bool                                     m_stop = false;
+        std::thread                              m_timeouts;
+    };
+
+    /// checks the status and payload of a reply
+    /// decoders run in the reply callback on the bus thread: they report errors, they never throw
+    static fty::Expected<void> checkReply(const fty::Expected<messagebus::Message>& ret, const std::string& failure)
+    {
+        if (!ret)
+        {
+            return fty::unexpected("MessageBus request failed: {}", ret.error());
+        }
+
+        auto status = ret->metaData().find(messagebus::Message::STATUS);
+        if (status == ret->metaData().end() || status->second != messagebus::STATUS_OK)
+        {
+            return fty::unexpected(failure);
+        }
+
+        if (ret->userData().empty())
+        {
+            return fty::unexpected("{}: empty reply", failure);
+        }
+
+        return {};
     }
 
-    /// static helper to send a MessageBus asynch request
-    static void sendAsyncReq(const std::string& command, messagebus::UserData data)
+    /// decodes the reply of a GET_ID request
+    static fty::Expected<uint32_t> idFromReply(const fty::Expected<messagebus::Message>& ret)
     {
-        // generate unique ID interface
-        std::stringstream ss;
-        ss << ACCESSOR_NAME << "-" << std::setfill('0') << std::setw(sizeof(pid_t)*2) << std::hex << std::this_thread::get_id();
+        auto checked = checkReply(ret, "Request of ID from iname failed");
+        if (!checked)
+        {
+            return fty::unexpected(checked.error());
+        }
 
-        std::string clientName = ss.str();
+        try
+        {
+            cxxtools::SerializationInfo si;
+            JSON::readFromString(ret->userData().front(), si);
 
-        std::unique_ptr<messagebus::MessageBus> interface(messagebus::MlmMessageBus(ENDPOINT, clientName));
-        messagebus::Message msg;
+            std::string data;
 
-        interface->connect();
+            si >>= data;
 
-        msg.metaData().emplace(messagebus::Message::CORRELATION_ID, messagebus::generateUuid());
-        msg.metaData().emplace(messagebus::Message::SUBJECT, command);
-        msg.metaData().emplace(messagebus::Message::FROM, clientName);
-        msg.metaData().emplace(messagebus::Message::TO, ASSET_AGENT);
-        msg.metaData().emplace(messagebus::Message::REPLY_TO, clientName);
+            return fty::convert<uint32_t>(data);
+        }
+        catch (const std::exception& e)
+        {
+            return fty::unexpected("Invalid ID in reply: {}", e.what());
+        }
+    }
 
-        msg.userData() = data;
+    /// decodes the reply of a GET request
+    static fty::Expected<fty::Asset> assetFromReply(const fty::Expected<messagebus::Message>& ret)
+    {
+        auto checked = checkReply(ret, "Request of fty::FullAsset from iname failed");
+        if (!checked)
+        {
+            return fty::unexpected(checked.error());
+        }
 
-        return interface->sendRequest(ASSET_AGENT_QUEUE, msg);
+        Asset asset;
+        try
+        {
+            // older agents ignore the requested encoding and reply with JSON, protobuf is base64 encoded
+            auto it = ret->metaData().find(METADATA_ENCODING);
+            if (it != ret->metaData().end() && it->second == ENCODING_PROTOBUF)
+            {
+                fty::Asset::fromBinary(cxxtools::decode<cxxtools::Base64Codec>(ret->userData().front()), asset);
+            }
+            else
+            {
+                fty::Asset::fromJson(ret->userData().front(), asset);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            return fty::unexpected("Invalid asset in reply: {}", e.what());
+        }
+
+        return fty::Expected<fty::Asset>(std::move(asset));
     }
 
-    /// returns the asset database ID, given the internal name
-    fty::Expected<uint32_t> AssetAccessor::assetInameToID(const std::string &iname)
+    /// decodes the reply of a GET_ID_BATCH request
+    static fty::Expected<std::map<std::string, uint32_t>> idsFromReply(const fty::Expected<messagebus::Message>& ret)
+    {
+        auto checked = checkReply(ret, "Request of IDs from inames failed");
+        if (!checked)
+        {
+            return fty::unexpected(checked.error());
+        }
+
+        std::map<std::string, uint32_t> ids;
+        try
+        {
+            cxxtools::SerializationInfo si;
+            JSON::readFromString(ret->userData().front(), si);
+
+            for (const auto& member : si)
+            {
+                uint32_t id = 0;
+                member >>= id;
+                ids.emplace(member.name(), id);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            return fty::unexpected("Invalid IDs in reply: {}", e.what());
+        }
+
+        return fty::Expected<std::map<std::string, uint32_t>>(std::move(ids));
+    }
+
+    /// decodes the reply of a GET_BATCH request
+    static fty::Expected<std::vector<fty::Asset>> assetsFromReply(const fty::Expected<messagebus::Message>& ret)
     {
-        messagebus::Message ret;
+        auto checked = checkReply(ret, "Request of assets from inames failed");
+        if (!checked)
+        {
+            return fty::unexpected(checked.error());
+        }
 
+        std::vector<fty::Asset> assets;
         try
         {
-            ret = sendSyncReq("GET_ID", {iname});
+            auto it = ret->metaData().find(METADATA_ENCODING);
+            if (it != ret->metaData().end() && it->second == ENCODING_PROTOBUF)
+            {
+                fty::Asset::fromBinary(cxxtools::decode<cxxtools::Base64Codec>(ret->userData().front()), assets);
+            }
+            else
+            {
+                cxxtools::SerializationInfo si;
+                JSON::readFromString(ret->userData().front(), si);
+                assets.reserve(si.memberCount());
+                for (const auto& member : si)
+                {
+                    assets.emplace_back();
+                    member >>= assets.back();
+                }
+            }
         }
-        catch (messagebus::MessageBusException &e)
+        catch (const std::exception& e)
         {
-            return fty::unexpected("MessageBus request failed: {}", e.what());
+            return fty::unexpected("Invalid asset in reply: {}", e.what());
         }
 
-        if (ret.metaData().at(messagebus::Message::STATUS) != messagebus::STATUS_OK)
+        return fty::Expected<std::vector<fty::Asset>>(std::move(assets));
+    }
+
+    static messagebus::MetaData encodingMetaData(const std::string& encoding)
+    {
+        messagebus::MetaData metaData;
+        if (encoding != ENCODING_JSON)
         {
-            return fty::unexpected("Request of ID from iname failed");
+            metaData.emplace(METADATA_ENCODING, encoding);
         }
+        return metaData;
+    }
 
-        cxxtools::SerializationInfo si;
-        JSON::readFromString(ret.userData().front(), si);
+    /// returns the asset database ID, given the internal name
+    fty::Expected<uint32_t> AssetAccessor::assetInameToID(const std::string &iname)
+    {
+        return assetInameToIDAsync(iname).get();
+    }
 
-        std::string data;
+    std::future<fty::Expected<uint32_t>> AssetAccessor::assetInameToIDAsync(const std::string& iname)
+    {
+        auto promise = std::make_shared<std::promise<fty::Expected<uint32_t>>>();
+        assetInameToIDAsync(iname, [promise](fty::Expected<uint32_t> id) {
+            promise->set_value(std::move(id));
+        });
+        return promise->get_future();
+    }
 
-        si >>= data;
+    void AssetAccessor::assetInameToIDAsync(const std::string& iname, std::function<void(fty::Expected<uint32_t>)> callback)
+    {
+        auto     cache = AccessorSession::instance().cache();
+        uint64_t epoch = 0;
+        if (cache)
+        {
+            if (auto id = cache->findId(iname))
+            {
+                callback(*id);
+                return;
+            }
+            epoch = cache->epoch();
+        }
 
-        return fty::convert<uint32_t>(data);
+        AccessorSession::instance().request("GET_ID", {iname}, {},
+            [callback = std::move(callback), cache, epoch, iname](fty::Expected<messagebus::Message> ret) {
+                auto id = idFromReply(ret);
+                if (id && cache)
+                {
+                    cache->storeId(iname, *id, epoch);
+                }
+                callback(std::move(id));
+            });
     }
 
     /// returns the full fty::Asset, given the internal name
     fty::Expected<fty::Asset> AssetAccessor::getAsset(const std::string& iname)
     {
-        messagebus::Message ret;
+        return getAsset(iname, ENCODING_JSON);
+    }
 
-        try
+    /// returns the full fty::Asset, given the internal name, requested in the given payload encoding
+    fty::Expected<fty::Asset> AssetAccessor::getAsset(const std::string& iname, const std::string& encoding)
+    {
+        return getAssetAsync(iname, encoding).get();
+    }
+
+    std::future<fty::Expected<fty::Asset>> AssetAccessor::getAssetAsync(const std::string& iname, const std::string& encoding)
+    {
+        auto promise = std::make_shared<std::promise<fty::Expected<fty::Asset>>>();
+        getAssetAsync(iname, encoding, [promise](fty::Expected<fty::Asset> asset) {
+            promise->set_value(std::move(asset));
+        });
+        return promise->get_future();
+    }
+
+    void AssetAccessor::getAssetAsync(const std::string& iname, const std::string& encoding,
+        std::function<void(fty::Expected<fty::Asset>)> callback)
+    {
+        // the encoding is only the one of the transfer, cached assets are decoded
+        auto     cache = AccessorSession::instance().cache();
+        uint64_t epoch = 0;
+        if (cache)
         {
-            ret = sendSyncReq("GET", {iname});
+            if (auto asset = cache->findAsset(iname))
+            {
+                callback(std::move(*asset));
+                return;
+            }
+            epoch = cache->epoch();
         }
-        catch (messagebus::MessageBusException &e)
+
+        AccessorSession::instance().request("GET", {iname}, encodingMetaData(encoding),
+            [callback = std::move(callback), cache, epoch, iname](fty::Expected<messagebus::Message> ret) {
+                auto asset = assetFromReply(ret);
+                if (asset && cache)
+                {
+                    cache->storeAsset(iname, *asset, epoch);
+                }
+                callback(std::move(asset));
+            });
+    }
+
+    /// returns the asset database IDs, given the internal names
+    fty::Expected<std::map<std::string, uint32_t>> AssetAccessor::assetInamesToIDs(const std::vector<std::string>& inames)
+    {
+        std::map<std::string, uint32_t> ids;
+        messagebus::UserData            missing;
+
+        auto     cache = AccessorSession::instance().cache();
+        uint64_t epoch = cache ? cache->epoch() : 0;
+        for (const auto& iname : inames)
         {
-            return fty::unexpected("MessageBus request failed: {}", e.what());
+            std::optional<uint32_t> id = cache ? cache->findId(iname) : std::nullopt;
+            if (id)
+            {
+                ids.emplace(iname, *id);
+            }
+            else
+            {
+                missing.push_back(iname);
+            }
         }
+        if (missing.empty())
+        {
+            return fty::Expected<std::map<std::string, uint32_t>>(std::move(ids));
+        }
+
+        // the callback may still run after a timeout: it must not refer to this frame
+        auto promise = std::make_shared<std::promise<fty::Expected<std::map<std::string, uint32_t>>>>();
+        auto future  = promise->get_future();
+        AccessorSession::instance().request("GET_ID_BATCH", std::move(missing), {},
+            [promise](fty::Expected<messagebus::Message> ret) {
+                promise->set_value(idsFromReply(ret));
+            });
 
-        if (ret.metaData().at(messagebus::Message::STATUS) != messagebus::STATUS_OK)
+        auto found = future.get();
+        if (!found)
         {
-            return fty::unexpected("Request of fty::FullAsset from iname failed");
+            return found;
+        }
+        for (const auto& it : *found)
+        {
+            if (cache)
+            {
+                cache->storeId(it.first, it.second, epoch);
+            }
+            ids.insert(it);
         }
 
-        Asset asset;
-        fty::Asset::fromJson(ret.userData().front(), asset);
+        return fty::Expected<std::map<std::string, uint32_t>>(std::move(ids));
+    }
+
+    /// returns the full fty::Asset of each internal name, in the order of the names
+    fty::Expected<std::vector<fty::Asset>> AssetAccessor::getAssets(
+        const std::vector<std::string>& inames, const std::string& encoding)
+    {
+        std::map<std::string, fty::Asset> assets;
+        messagebus::UserData              missing;
+
+        auto     cache = AccessorSession::instance().cache();
+        uint64_t epoch = cache ? cache->epoch() : 0;
+        for (const auto& iname : inames)
+        {
+            std::optional<fty::Asset> asset = cache ? cache->findAsset(iname) : std::nullopt;
+            if (asset)
+            {
+                assets.emplace(iname, std::move(*asset));
+            }
+            else
+            {
+                missing.push_back(iname);
+            }
+        }
+
+        if (!missing.empty())
+        {
+            auto promise = std::make_shared<std::promise<fty::Expected<std::vector<fty::Asset>>>>();
+            auto future  = promise->get_future();
+            AccessorSession::instance().request("GET_BATCH", std::move(missing), encodingMetaData(encoding),
+                [promise](fty::Expected<messagebus::Message> ret) {
+                    promise->set_value(assetsFromReply(ret));
+                });
+
+            auto found = future.get();
+            if (!found)
+            {
+                return fty::unexpected(found.error());
+            }
+            for (auto& asset : *found)
+            {
+                if (cache)
+                {
+                    cache->storeAsset(asset.getInternalName(), asset, epoch);
+                }
+                std::string iname = asset.getInternalName();
+                assets.emplace(std::move(iname), std::move(asset));
+            }
+        }
+
+        std::vector<fty::Asset> list;
+        list.reserve(assets.size());
+        for (const auto& iname : inames)
+        {
+            auto it = assets.find(iname);
+            if (it != assets.end())
+            {
+                list.push_back(std::move(it->second));
+                assets.erase(it);
+            }
+        }
 
-        return asset;
+        return fty::Expected<std::vector<fty::Asset>>(std::move(list));
+    }
+
+    fty::Expected<void> AssetAccessor::enableCache(size_t capacity, std::chrono::seconds maxAge)
+    {
+        AccessorSession& session = AccessorSession::instance();
+        if (session.cache())
+        {
+            return {};
+        }
+
+        auto cache = std::make_shared<AccessorCache>(capacity, maxAge);
+
+        // notifications go to the cache enabled at the time they are received
+        static std::once_flag subscribed;
+        try
+        {
+            std::call_once(subscribed, [&session]() {
+                for (const char* topic : ASSET_TOPICS)
+                {
+                    session.subscribe(topic, [&session](messagebus::Message msg) {
+                        auto current = session.cache();
+                        if (current && !msg.userData().empty())
+                        {
+                            current->invalidate(msg.userData().front());
+                        }
+                    });
+                }
+            });
+        }
+        catch (const std::exception& e)
+        {
+            return fty::unexpected("Subscription to asset notifications failed: {}", e.what());
+        }
+
+        session.setCache(std::move(cache));
+        return {};
+    }
+
+    void AssetAccessor::disableCache()
+    {
+        AccessorSession::instance().setCache(nullptr);
+    }
+
+    AssetAccessor::CacheStats AssetAccessor::cacheStats()
+    {
+        auto cache = AccessorSession::instance().cache();
+        return cache ? cache->stats() : CacheStats();
     }
 
     /// triggers an update notification. It receives the DTOs of the asset before and after the update
@@ -165,7 +752,7 @@ namespace fty
 
             std::string json = JSON::writeToString(si, false);
 
-            sendAsyncReq("STATUS_UPDATE", {json});
+            AccessorSession::instance().notify("STATUS_UPDATE", {json});
         } else {
             log_error("Invalid data. Update status notification will not be requested");
         }
@@ -196,6 +783,6 @@ namespace fty
 
         std::string json = JSON::writeToString(si, false);
 
-        sendAsyncReq("NOTIFY", {json});
+        AccessorSession::instance().notify("NOTIFY", {json});
     }
 } // namespace fty
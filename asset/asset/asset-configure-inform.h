@@ -2,10 +2,67 @@
 
 #include "asset-db.h"
 #include <fty_common_asset_types.h>
+#include <map>
+#include <set>
 #include <vector>
 
+typedef struct _mlm_client_t mlm_client_t;
+typedef struct _zmsg_t       zmsg_t;
+
+namespace fty::db {
+class Connection;
+}
+
 namespace fty::asset {
 
+/// Sends ASSETS stream notifications through one producer connection kept for the batcher lifetime.
+/// Notifications are queued and sent on flush() or when the queue is full, the owner must flush before the
+/// batcher is destroyed (errors could not be reported). Repeated notifications of the same asset are coalesced
+/// into one, an asset created and deleted before the flush is not notified at all. UPS lists of datacenters are
+/// read once per flush.
+class ConfigureBatcher
+{
+public:
+    explicit ConfigureBatcher(const std::string& agentName, size_t maxPending = 256);
+    virtual ~ConfigureBatcher();
+
+    ConfigureBatcher(const ConfigureBatcher&) = delete;
+    ConfigureBatcher& operator=(const ConfigureBatcher&) = delete;
+
+    /// Queues notification, flushes the queue if it is full
+    /// @param row asset to notify about
+    /// @param operation asset operation
+    /// @return nothing or error of connection/sending
+    Expected<void> add(const db::AssetElement& row, persist::asset_operation operation);
+
+    /// Sends all queued notifications
+    /// @return nothing or error of connection/sending
+    Expected<void> flush();
+
+protected:
+    /// Sends one message on the ASSETS stream, message is destroyed
+    virtual Expected<void> publish(const std::string& subject, zmsg_t** msg);
+
+    /// Asks fty-asset to republish the asset, so we would get its UUID
+    virtual void requestRepublish(const std::string& assetName);
+
+private:
+    using Pending = std::pair<db::AssetElement, persist::asset_operation>;
+
+    Expected<void> connect();
+    Expected<void> send(const Pending& row, std::set<std::string>& upsDcs);
+    Expected<void> sendDcInventory(fty::db::Connection& conn, const std::string& dcName);
+    void           disconnect();
+
+private:
+    std::string                m_agentName;
+    size_t                     m_maxPending;
+    mlm_client_t*              m_client = nullptr;
+    std::vector<Pending>       m_pending;
+    std::map<uint32_t, size_t> m_index; // asset id -> position in m_pending
+    bool                       m_sent = false;
+};
+
 Expected<void> sendConfigure(
     const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows, const std::string& agentName);
 
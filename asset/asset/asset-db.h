@@ -392,4 +392,17 @@ Expected<std::vector<std::string>> selectGroupNames(uint32_t id);
 /// @param assetId asset id
 /// @param parentType parent type
 Expected<WebAssetElement> findParentByType(uint32_t assetId, uint16_t parentType);
+
+/// Selects ext attributes of all assets at once
+/// @return map of asset element id to its attributes or error
+Expected<std::map<uint32_t, Attributes>> selectExtAttributesAll();
+
+/// Selects all links of given type
+/// @param linkTypeId link type id
+/// @return list of links or error
+Expected<std::vector<AssetLink>> selectAssetLinksAll(uint8_t linkTypeId);
+
+/// Selects all group memberships
+/// @return map of asset element id to ids of its groups or error
+Expected<std::map<uint32_t, std::set<uint32_t>>> selectAssetGroupsAll();
 } // namespace fty::asset::db
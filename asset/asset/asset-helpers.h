@@ -3,6 +3,7 @@
 #include <fty/expected.h>
 #include <string>
 #include <uuid/uuid.h>
+#include <vector>
 
 namespace fty {
 class FullAsset;
@@ -56,6 +57,12 @@ namespace activation {
     AssetExpected<bool> isActivable(const std::string& assetJson);
     AssetExpected<void> activate(const std::string& assetJson);
     AssetExpected<void> deactivate(const std::string& assetJson);
+
+    // Batch variants: one request for all the assets, results are in the order of the input.
+    // Falls back to one request per asset if licensing agent does not support batches (detected once),
+    // any other failure of the request is the error of every asset.
+    std::vector<AssetExpected<bool>> isActivable(const std::vector<std::string>& assetsJson);
+    std::vector<AssetExpected<void>> activate(const std::vector<std::string>& assetsJson);
 } // namespace activation
 
 AssetExpected<std::string> normName(const std::string& name, uint32_t maxLen, uint32_t assetId = 0);
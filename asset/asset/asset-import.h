@@ -4,6 +4,7 @@
 #include <fty_common_asset_types.h>
 #include <map>
 #include <set>
+#include <tuple>
 
 namespace tntdb {
 class Connection;
@@ -16,20 +17,77 @@ namespace db {
     struct AssetLink;
 }
 
+/// Changes which import of one csv row would do
+struct ImportDiff
+{
+    enum class Action
+    {
+        Insert,
+        Update,
+        NoOp
+    };
+
+    struct Change
+    {
+        std::string before;
+        std::string after;
+    };
+
+    struct Link
+    {
+        std::string source; //!< internal name of the power source
+        std::string srcOut; //!< outlet in source
+        std::string destIn; //!< inlet in asset
+
+        bool operator<(const Link& other) const
+        {
+            return std::tie(source, srcOut, destIn) < std::tie(other.source, other.srcOut, other.destIn);
+        }
+    };
+
+    Action                        action = Action::NoOp;
+    std::string                   iname;  //!< internal name, empty for new asset
+    std::string                   name;   //!< external name
+    std::map<std::string, Change> fields; //!< changed location, status, priority, asset_tag
+    std::map<std::string, Change> ext;    //!< changed ext attributes, empty 'after' means removed
+    std::vector<Link>             linksAdded;
+    std::vector<Link>             linksRemoved;
+    std::vector<std::string>      groupsAdded;
+    std::vector<std::string>      groupsRemoved;
+};
+
 class Import
 {
 public:
     using ImportResMap = std::map<size_t, Expected<db::AssetElement>>;
+    using DiffResMap   = std::map<size_t, AssetExpected<ImportDiff>>;
 
     Import(const CsvMap& cm);
     AssetExpected<void>      process(bool checkLic);
     const ImportResMap&      items() const;
     persist::asset_operation operation() const;
 
+    /// Dry run of process(): rows are validated as by process(), against a snapshot of the database loaded in
+    /// bulk, and compared with it. Nothing is written and no notification is sent. Licensing is not checked.
+    AssetExpected<void> diff();
+    const DiffResMap&   diffs() const;
+
 private:
+    class Lookup;
+    class DbLookup;
+    struct Snapshot;
+    struct Row;
+
+    /// checks a row and resolves its names, without writing anything
+    AssetExpected<Row> validateRow(size_t row, Lookup& lookup, const std::set<uint32_t>& ids, bool sanitize) const;
+
+    AssetExpected<ImportDiff> diffRow(size_t row, Snapshot& snap, const std::set<uint32_t>& ids) const;
+
     std::string                        mandatoryMissing() const;
-    std::map<std::string, std::string> sanitizeRowExtNames(size_t row, bool sanitize) const;
-    AssetExpected<db::AssetElement>    processRow(size_t row, const std::set<uint32_t>& ids, bool sanitize, bool checkLic);
+    std::map<std::string, std::string> sanitizeRowExtNames(size_t row, bool sanitize, Lookup& lookup) const;
+    AssetExpected<db::AssetElement>    processRow(
+           size_t row, DbLookup& lookup, const std::set<uint32_t>& ids, bool sanitize, bool checkLic);
+    void                               activatePending();
     uint16_t                           getPriority(const std::string& s) const;
     bool                               isDate(const std::string& key) const;
     std::string                        matchExtAttr(const std::string& value, const std::string& key) const;
@@ -59,7 +117,11 @@ private:
 private:
     const CsvMap&            m_cm;
     ImportResMap             m_el;
+    DiffResMap               m_diff;
     persist::asset_operation m_operation;
+
+    /// row -> asset json of devices waiting for activation
+    std::map<size_t, std::string> m_toActivate;
 };
 
 } // namespace fty::asset
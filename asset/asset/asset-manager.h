@@ -2,16 +2,21 @@
 
 #include "asset-db.h"
 #include "asset-dto.h"
+#include "asset-import.h"
 #include "error.h"
 #include <fty/expected.h>
 #include <fty/translate.h>
 #include <fty_common_db_asset.h>
 #include <fty_common_db_exception.h>
+#include <functional>
+#include <iosfwd>
 #include <map>
 #include <string>
 
 namespace fty::asset {
 
+class ConfigureBatcher;
+
 enum class OrderDir
 {
     Asc,
@@ -21,8 +26,12 @@ enum class OrderDir
 class AssetManager
 {
 public:
-    using AssetList  = std::vector<std::pair<uint32_t, std::string>>;
-    using ImportList = std::map<size_t, Expected<uint32_t>>;
+    using AssetList      = std::vector<std::pair<uint32_t, std::string>>;
+    using ImportList     = std::map<size_t, Expected<uint32_t>>;
+    using ImportDiffList = Import::DiffResMap;
+    using ExportSink     = std::function<void(const std::string& chunk)>;
+
+    static constexpr size_t ExportChunkSize = 64 * 1024;
 
 public:
     static AssetExpected<Dto> getDto(const std::string& iname);
@@ -47,9 +56,31 @@ public:
     static AssetExpected<uint32_t> createAsset(
         const cxxtools::SerializationInfo& serializationInfo, const std::string& user, bool sendNotify = true);
 
-    static AssetExpected<ImportList> importCsv(const std::string& csv, const std::string& user, bool sendNotify = true);
+    /// Imports assets from csv. sendNotify enables licensing checks and activation. ASSETS notifications of
+    /// imported assets are queued into notify when given, the caller flushes it (and can keep it for several
+    /// imports to reuse one connection).
+    static AssetExpected<ImportList> importCsv(const std::string& csv, const std::string& user, bool sendNotify = true,
+        ConfigureBatcher* notify = nullptr);
+
+    /// Dry run of importCsv: tells for every row if it would be inserted, updated or left as is, and what differs.
+    /// Database is read once in bulk, nothing is written and no notification is sent.
+    static AssetExpected<ImportDiffList> importCsvDryRun(const std::string& csv);
     static AssetExpected<std::string> exportCsv(const std::optional<db::AssetElement>& dc = std::nullopt);
 
+    /// Streams exported csv into the given stream, row by row
+    static AssetExpected<void> exportCsv(std::ostream& out, const std::optional<db::AssetElement>& dc = std::nullopt);
+
+    /// Streams exported csv into the sink by chunks of (at least) chunkSize bytes, last chunk can be smaller.
+    /// On error the sink could already have received a part of the csv.
+    static AssetExpected<void> exportCsv(const ExportSink& sink, const std::optional<db::AssetElement>& dc = std::nullopt,
+        size_t chunkSize = ExportChunkSize);
+
+    /// Exports all datacenters concurrently, one datacenter subtree per job on a pool of workers (0 means one per
+    /// cpu). Rows are in deterministic order: assets outside of datacenters first, then datacenters ordered by id,
+    /// except that a part powering another one is moved before it (parts powering each other are one job).
+    static AssetExpected<void> exportCsvParallel(
+        const ExportSink& sink, unsigned workers = 0, size_t chunkSize = ExportChunkSize);
+
 private:
     static AssetExpected<db::AssetElement> deleteDcRoomRowRack(const db::AssetElement& element);
     static AssetExpected<db::AssetElement> deleteGroup(const db::AssetElement& element);
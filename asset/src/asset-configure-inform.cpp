@@ -24,7 +24,6 @@
 #include <fty_common_db.h>
 #include <fty_common_mlm_utils.h>
 #include <fty_proto.h>
-#include <thread>
 #include <malamute.h>
 #include <thread>
 #include <fty_log.h>
@@ -78,121 +77,245 @@ static void* voidify(const std::string& str)
     return reinterpret_cast<void*>(const_cast<char*>(str.c_str()));
 }
 
-Expected<void> sendConfigure(
-    const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows, const std::string& agentName)
+// =====================================================================================================================
+
+ConfigureBatcher::ConfigureBatcher(const std::string& agentName, size_t maxPending)
+    : m_agentName(agentName)
+    , m_maxPending(maxPending ? maxPending : 1)
+{
+}
+
+ConfigureBatcher::~ConfigureBatcher()
 {
-    mlm_client_t* client = mlm_client_new();
+    if (!m_pending.empty()) {
+        logWarn("{} asset notifications were not flushed and are dropped", m_pending.size());
+    }
+    disconnect();
+}
 
-    if (!client) {
+Expected<void> ConfigureBatcher::connect()
+{
+    if (m_client) {
+        return {};
+    }
+
+    m_client = mlm_client_new();
+    if (!m_client) {
         return unexpected("mlm_client_new () failed.");
     }
 
-    int r = mlm_client_connect(client, MLM_ENDPOINT, 1000, agentName.c_str());
-    if (r == -1) {
-        mlm_client_destroy(&client);
+    if (mlm_client_connect(m_client, MLM_ENDPOINT, 1000, m_agentName.c_str()) == -1) {
+        mlm_client_destroy(&m_client);
         return unexpected("mlm_client_connect () failed.");
     }
 
-    r = mlm_client_set_producer(client, FTY_PROTO_STREAM_ASSETS);
-    if (r == -1) {
-        mlm_client_destroy(&client);
+    if (mlm_client_set_producer(m_client, FTY_PROTO_STREAM_ASSETS) == -1) {
+        mlm_client_destroy(&m_client);
         return unexpected(" mlm_client_set_producer () failed.");
     }
+    return {};
+}
 
-    fty::db::Connection conn;
-    for (const auto& oneRow : rows) {
+void ConfigureBatcher::disconnect()
+{
+    if (m_client) {
+        if (m_sent) {
+            zclock_sleep(500); // ensure that everything was send before we destroy the client
+        }
+        mlm_client_destroy(&m_client);
+    }
+}
 
-        std::string s_priority    = std::to_string(oneRow.first.priority);
-        std::string s_parent      = std::to_string(oneRow.first.parentId);
-        std::string s_asset_name  = oneRow.first.name;
-        std::string s_asset_type  = persist::typeid_to_type(oneRow.first.typeId);
-        std::string s_subtypeName = persist::subtypeid_to_subtype(oneRow.first.subtypeId);
-
-        std::string subject;
-        subject = persist::typeid_to_type(oneRow.first.typeId);
-        subject.append(".");
-        subject.append(persist::subtypeid_to_subtype(oneRow.first.subtypeId));
-        subject.append("@");
-        subject.append(oneRow.first.name);
-
-        zhash_t* aux = zhash_new();
-        zhash_autofree(aux);
-        zhash_insert(aux, "priority", voidify(s_priority));
-        zhash_insert(aux, "type", voidify(s_asset_type));
-        zhash_insert(aux, "subtype", voidify(s_subtypeName));
-        zhash_insert(aux, "parent", voidify(s_parent));
-        zhash_insert(aux, "status", voidify(oneRow.first.status));
-
-        // this is a bit hack, but we now that our topology ends with datacenter (hopefully)
-        std::string dc_name;
-
-        auto cb = [aux, &dc_name](const fty::db::Row& row) {
-            for (const auto& name : {"parent_name1", "parent_name2", "parent_name3", "parent_name4", "parent_name5",
-                     "parent_name6", "parent_name7", "parent_name8", "parent_name9", "parent_name10"}) {
-                std::string foo       = row.get(name);
-                std::string hash_name = name;
-                // 11 == strlen ("parent_name")
-                hash_name.insert(11, 1, '.');
-                if (!foo.empty()) {
-                    zhash_insert(aux, hash_name.c_str(), voidify(foo));
-                    dc_name = foo;
+Expected<void> ConfigureBatcher::add(const db::AssetElement& row, persist::asset_operation operation)
+{
+    if (auto it = m_index.find(row.id); it != m_index.end()) {
+        size_t pos     = it->second;
+        auto&  pending = m_pending[pos];
+
+        // created and deleted: consumers never saw this asset, nothing to notify
+        if (pending.second == persist::asset_operation::INSERT && operation == persist::asset_operation::DELETE) {
+            m_pending.erase(m_pending.begin() + ptrdiff_t(pos));
+            m_index.erase(it);
+            for (auto& idx : m_index) {
+                if (idx.second > pos) {
+                    --idx.second;
                 }
             }
-        };
-        auto res = db::selectAssetElementSuperParent(oneRow.first.id, cb);
-        if (!res) {
-            logError("selectAssetElementSuperParent error: {}", res.error());
-            zhash_destroy(&aux);
-            mlm_client_destroy(&client);
-            return unexpected("persist::select_asset_element_super_parent () failed.");
+            return {};
+        }
+
+        // coalesce: create followed by update is still a create, anything else is the last operation
+        if (!(pending.second == persist::asset_operation::INSERT && operation == persist::asset_operation::UPDATE)) {
+            pending.second = operation;
         }
+        pending.first = row;
+        return {};
+    }
+
+    m_index.emplace(row.id, m_pending.size());
+    m_pending.emplace_back(row, operation);
 
-        zhash_t* ext = s_map2zhash(oneRow.first.ext);
+    if (m_pending.size() >= m_maxPending) {
+        // backpressure: the producer waits until queue is sent
+        return flush();
+    }
+    return {};
+}
 
-        zmsg_t* msg = fty_proto_encode_asset(aux, oneRow.first.name.c_str(), operation2str(oneRow.second).c_str(), ext);
+Expected<void> ConfigureBatcher::flush()
+{
+    if (m_pending.empty()) {
+        return {};
+    }
 
-        r = mlm_client_send(client, subject.c_str(), &msg);
-        if (r != 0) {
-            mlm_client_destroy(&client);
-            return unexpected("mlm_client_send () failed.");
+    std::vector<Pending> pending;
+    pending.swap(m_pending);
+    m_index.clear();
+
+    std::set<std::string> upsDcs;
+    for (const auto& row : pending) {
+        if (auto ret = send(row, upsDcs); !ret) {
+            return unexpected(ret.error());
         }
+    }
 
-        zhash_destroy(&aux);
-        zhash_destroy(&ext);
-
-        // ask fty-asset to republish so we would get UUID
-        if (streq(operation2str(oneRow.second).c_str(), FTY_PROTO_ASSET_OP_CREATE) ||
-            streq(operation2str(oneRow.second).c_str(), FTY_PROTO_ASSET_OP_UPDATE)) {
-            zmsg_t* republish = zmsg_new();
-            zmsg_addstr(republish, s_asset_name.c_str());
-            mlm_client_sendto(client, "asset-agent", "REPUBLISH", nullptr, 5000, &republish);
+    // data for uptime, once per datacenter
+    if (!upsDcs.empty()) {
+        fty::db::Connection conn;
+        for (const auto& dcName : upsDcs) {
+            if (auto ret = sendDcInventory(conn, dcName); !ret) {
+                return unexpected(ret.error());
+            }
         }
+    }
 
-        // data for uptime
-        if (oneRow.first.subtypeId == persist::asset_subtype::UPS) {
-            zhash_t* aux1 = zhash_new();
-
-            if (!getDcUPSes(conn, dc_name, aux1))
-                log_error("Cannot read upses for dc with id = %s", dc_name.c_str());
-
-            zhash_update(aux1, "type", reinterpret_cast<void*>(const_cast<char*>("datacenter")));
-            zmsg_t*     msg1     = fty_proto_encode_asset(aux1, dc_name.c_str(), "inventory", nullptr);
-            std::string subject1 = "datacenter.unknown@";
-            subject.append(dc_name);
-            r = mlm_client_send(client, subject.c_str(), &msg1);
-            zhash_destroy(&aux1);
-            if (r != 0) {
-                mlm_client_destroy(&client);
-                return unexpected("mlm_client_send () failed.");
+    return {};
+}
+
+Expected<void> ConfigureBatcher::send(const Pending& oneRow, std::set<std::string>& upsDcs)
+{
+    std::string s_priority    = std::to_string(oneRow.first.priority);
+    std::string s_parent      = std::to_string(oneRow.first.parentId);
+    std::string s_asset_name  = oneRow.first.name;
+    std::string s_asset_type  = persist::typeid_to_type(oneRow.first.typeId);
+    std::string s_subtypeName = persist::subtypeid_to_subtype(oneRow.first.subtypeId);
+    std::string s_operation   = operation2str(oneRow.second);
+
+    std::string subject;
+    subject = s_asset_type;
+    subject.append(".");
+    subject.append(s_subtypeName);
+    subject.append("@");
+    subject.append(oneRow.first.name);
+
+    zhash_t* aux = zhash_new();
+    zhash_autofree(aux);
+    zhash_insert(aux, "priority", voidify(s_priority));
+    zhash_insert(aux, "type", voidify(s_asset_type));
+    zhash_insert(aux, "subtype", voidify(s_subtypeName));
+    zhash_insert(aux, "parent", voidify(s_parent));
+    zhash_insert(aux, "status", voidify(oneRow.first.status));
+
+    // this is a bit hack, but we now that our topology ends with datacenter (hopefully)
+    std::string dc_name;
+
+    auto cb = [aux, &dc_name](const fty::db::Row& row) {
+        for (const auto& name : {"parent_name1", "parent_name2", "parent_name3", "parent_name4", "parent_name5",
+                 "parent_name6", "parent_name7", "parent_name8", "parent_name9", "parent_name10"}) {
+            std::string foo       = row.get(name);
+            std::string hash_name = name;
+            // 11 == strlen ("parent_name")
+            hash_name.insert(11, 1, '.');
+            if (!foo.empty()) {
+                zhash_insert(aux, hash_name.c_str(), voidify(foo));
+                dc_name = foo;
             }
         }
+    };
+    auto res = db::selectAssetElementSuperParent(oneRow.first.id, cb);
+    if (!res) {
+        logError("selectAssetElementSuperParent error: {}", res.error());
+        zhash_destroy(&aux);
+        return unexpected("persist::select_asset_element_super_parent () failed.");
+    }
+
+    zhash_t* ext = s_map2zhash(oneRow.first.ext);
+
+    zmsg_t* msg = fty_proto_encode_asset(aux, oneRow.first.name.c_str(), s_operation.c_str(), ext);
+    zhash_destroy(&aux);
+    zhash_destroy(&ext);
+
+    if (auto ret = publish(subject, &msg); !ret) {
+        return ret;
+    }
+
+    // ask fty-asset to republish so we would get UUID
+    if (streq(s_operation.c_str(), FTY_PROTO_ASSET_OP_CREATE) || streq(s_operation.c_str(), FTY_PROTO_ASSET_OP_UPDATE)) {
+        requestRepublish(s_asset_name);
     }
 
-    zclock_sleep(500); // ensure that everything was send before we destroy the client
-    mlm_client_destroy(&client);
+    if (oneRow.first.subtypeId == persist::asset_subtype::UPS) {
+        upsDcs.insert(dc_name);
+    }
     return {};
 }
 
+Expected<void> ConfigureBatcher::sendDcInventory(fty::db::Connection& conn, const std::string& dcName)
+{
+    zhash_t* aux = zhash_new();
+
+    if (!getDcUPSes(conn, dcName, aux)) {
+        log_error("Cannot read upses for dc with id = %s", dcName.c_str());
+    }
+
+    zhash_update(aux, "type", reinterpret_cast<void*>(const_cast<char*>("datacenter")));
+    zmsg_t*     msg     = fty_proto_encode_asset(aux, dcName.c_str(), "inventory", nullptr);
+    std::string subject = "datacenter.unknown@" + dcName;
+    zhash_destroy(&aux);
+
+    return publish(subject, &msg);
+}
+
+Expected<void> ConfigureBatcher::publish(const std::string& subject, zmsg_t** msg)
+{
+    if (auto ret = connect(); !ret) {
+        zmsg_destroy(msg);
+        return unexpected(ret.error());
+    }
+
+    if (mlm_client_send(m_client, subject.c_str(), msg) != 0) {
+        zmsg_destroy(msg);
+        return unexpected("mlm_client_send () failed.");
+    }
+    m_sent = true;
+    return {};
+}
+
+void ConfigureBatcher::requestRepublish(const std::string& assetName)
+{
+    if (!m_client) {
+        return;
+    }
+
+    zmsg_t* republish = zmsg_new();
+    zmsg_addstr(republish, assetName.c_str());
+    mlm_client_sendto(m_client, "asset-agent", "REPUBLISH", nullptr, 5000, &republish);
+}
+
+// =====================================================================================================================
+
+Expected<void> sendConfigure(
+    const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows, const std::string& agentName)
+{
+    ConfigureBatcher batcher(agentName, rows.size());
+    for (const auto& oneRow : rows) {
+        if (auto ret = batcher.add(oneRow.first, oneRow.second); !ret) {
+            return ret;
+        }
+    }
+    return batcher.flush();
+}
+
 Expected<void> sendConfigure(
     const db::AssetElement& row, persist::asset_operation actionType, const std::string& agentName)
 {
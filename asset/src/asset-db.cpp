@@ -1845,4 +1845,91 @@ Expected<WebAssetElement> findParentByType(uint32_t assetId, uint16_t parentType
 
 // =====================================================================================================================
 
+Expected<std::map<uint32_t, Attributes>> selectExtAttributesAll()
+{
+    static const std::string sql = R"(
+        SELECT
+            v.id_asset_element,
+            v.keytag,
+            v.value,
+            v.read_only
+        FROM
+            v_bios_asset_ext_attributes v
+    )";
+
+    try {
+        fty::db::Connection conn;
+
+        std::map<uint32_t, Attributes> ret;
+        for (const auto& row : conn.select(sql)) {
+            ExtAttrValue val;
+
+            row.get("value", val.value);
+            row.get("read_only", val.readOnly);
+
+            ret[row.get<uint32_t>("id_asset_element")].emplace(row.get("keytag"), val);
+        }
+        return std::move(ret);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::vector<AssetLink>> selectAssetLinksAll(uint8_t linkTypeId)
+{
+    static const std::string sql = R"(
+        SELECT
+            v.id_asset_element_src, v.id_asset_element_dest, v.src_out, v.dest_in
+        FROM
+            v_web_asset_link v
+        WHERE
+            v.id_asset_link_type = :idlinktype
+    )";
+
+    try {
+        fty::db::Connection conn;
+
+        std::vector<AssetLink> ret;
+        for (const auto& row : conn.select(sql, "idlinktype"_p = linkTypeId)) {
+            AssetLink& link = ret.emplace_back();
+            row.get("id_asset_element_src", link.src);
+            row.get("id_asset_element_dest", link.dest);
+            row.get("src_out", link.srcOut);
+            row.get("dest_in", link.destIn);
+            link.type = linkTypeId;
+        }
+        return std::move(ret);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, std::set<uint32_t>>> selectAssetGroupsAll()
+{
+    static const std::string sql = R"(
+        SELECT
+            v.id_asset_element, v.id_asset_group
+        FROM
+            v_bios_asset_group_relation v
+    )";
+
+    try {
+        fty::db::Connection conn;
+
+        std::map<uint32_t, std::set<uint32_t>> ret;
+        for (const auto& row : conn.select(sql)) {
+            ret[row.get<uint32_t>("id_asset_element")].insert(row.get<uint32_t>("id_asset_group"));
+        }
+        return std::move(ret);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
 } // namespace fty::asset::db
@@ -1,5 +1,7 @@
 #include "asset/asset-helpers.h"
 #include "asset/asset-db.h"
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <fty_asset_dto.h>
 #include <fty_common_agents.h>
@@ -12,10 +14,12 @@
 #include <utility>
 #include <uuid/uuid.h>
 
-#define AGENT_ASSET_ACTIVATOR      "etn-licensing-credits"
-#define COMMAND_IS_ASSET_ACTIVABLE "GET_IS_ASSET_ACTIVABLE"
-#define COMMAND_ACTIVATE_ASSET     "ACTIVATE_ASSET"
-#define COMMAND_DEACTIVATE_ASSET   "DEACTIVATE_ASSET"
+#define AGENT_ASSET_ACTIVATOR        "etn-licensing-credits"
+#define COMMAND_IS_ASSET_ACTIVABLE   "GET_IS_ASSET_ACTIVABLE"
+#define COMMAND_ACTIVATE_ASSET       "ACTIVATE_ASSET"
+#define COMMAND_DEACTIVATE_ASSET     "DEACTIVATE_ASSET"
+#define COMMAND_ARE_ASSETS_ACTIVABLE "GET_IS_ASSETS_ACTIVABLE"
+#define COMMAND_ACTIVATE_ASSETS      "ACTIVATE_ASSETS"
 
 namespace fty::asset {
 
@@ -205,16 +209,27 @@ AssetExpected<void> checkDuplicatedAsset(const AssetFilter& assetFilter)
     return {};
 }
 
-static AssetExpected<std::vector<std::string>> activateRequest(const std::string& command, const std::string& asset)
+// reply frames of the activator, throws on communication error
+static std::vector<std::string> activatorRequest(const std::string& command, const std::vector<std::string>& assets)
 {
-    try {
-        mlm::MlmSyncClient client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
+    mlm::MlmSyncClient client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
 
-        logDebug("Sending {} request to {}", command, AGENT_ASSET_ACTIVATOR);
+    logDebug("Sending {} request to {}", command, AGENT_ASSET_ACTIVATOR);
 
-        std::vector<std::string> payload = {command, asset};
+    std::vector<std::string> payload = {command};
+    payload.insert(payload.end(), assets.begin(), assets.end());
+
+    std::vector<std::string> receivedFrames = client.syncRequestWithReply(payload);
+    if (receivedFrames.empty()) {
+        throw std::runtime_error("Empty reply");
+    }
+    return receivedFrames;
+}
 
-        std::vector<std::string> receivedFrames = client.syncRequestWithReply(payload);
+static AssetExpected<std::vector<std::string>> activateRequest(const std::string& command, const std::string& asset)
+{
+    try {
+        std::vector<std::string> receivedFrames = activatorRequest(command, {asset});
 
         // check if the first frame we get is an error
         if (receivedFrames[0] == "ERROR") {
@@ -230,11 +245,80 @@ static AssetExpected<std::vector<std::string>> activateRequest(const std::string
     }
 }
 
+enum class BatchSupport
+{
+    Unknown,
+    Supported,
+    Unsupported
+};
+
+// detected on the first batch request which gets an answer, for the life of the process
+static std::atomic<BatchSupport> s_batchSupport{BatchSupport::Unknown};
+
+// error reply of an activator which does not know the command, as opposed to a refusal of the request
+static bool isUnknownCommand(const std::string& err)
+{
+    std::string lower = err;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower.find("command") != std::string::npos;
+}
+
+// one request for all the assets, reply is expected to carry one frame per asset
+// fallback is set when the assets have to be sent one by one: the activator does not know batch commands, or did
+// not answer (older ones ignore unknown commands). Any other error applies to all the assets.
+static AssetExpected<std::vector<std::string>> activateBatchRequest(
+    const std::string& command, const std::vector<std::string>& assets, bool& fallback)
+{
+    fallback = s_batchSupport == BatchSupport::Unsupported;
+    if (fallback) {
+        return unexpected("Batch requests are not supported");
+    }
+
+    std::vector<std::string> receivedFrames;
+    try {
+        receivedFrames = activatorRequest(command, assets);
+    } catch (const std::exception& e) {
+        // no answer tells nothing about batch support: only this request falls back
+        logWarn("Batch request {} failed ({}), using one request per asset", command, e.what());
+        fallback = true;
+        return unexpected(e.what());
+    }
+
+    if (receivedFrames[0] == "ERROR") {
+        std::string err = receivedFrames.size() == 2 ? receivedFrames[1] : "Missing data for error";
+        if (s_batchSupport == BatchSupport::Unknown && isUnknownCommand(err)) {
+            logInfo("Batch request {} refused ({}), using one request per asset", command, err);
+            s_batchSupport = BatchSupport::Unsupported;
+            fallback       = true;
+        }
+        return unexpected(err);
+    }
+    s_batchSupport = BatchSupport::Supported;
+
+    if (receivedFrames.size() != assets.size()) {
+        logError("Batch request {}: {} results for {} assets", command, receivedFrames.size(), assets.size());
+        return unexpected("Unexpected batch reply");
+    }
+    return receivedFrames;
+}
+
+// activator answers "true" or "false" for each asset
+static AssetExpected<bool> activableFromFrame(const std::string& frame)
+{
+    if (frame == "true") {
+        return true;
+    }
+    if (frame == "false") {
+        return false;
+    }
+    return unexpected("Unexpected activator reply '{}'"_tr.format(frame));
+}
+
 AssetExpected<bool> activation::isActivable(const std::string& asset)
 {
     if (auto ret = activateRequest(COMMAND_IS_ASSET_ACTIVABLE, asset)) {
         logDebug("asset is activable = {}", ret->at(0));
-        return fty::convert<bool>(ret->at(0));
+        return activableFromFrame(ret->at(0));
     } else {
         return unexpected(ret.error());
     }
@@ -271,6 +355,59 @@ AssetExpected<void> activation::deactivate(const FullAsset& asset)
     return deactivate(asset.toJson());
 }
 
+std::vector<AssetExpected<bool>> activation::isActivable(const std::vector<std::string>& assets)
+{
+    std::vector<AssetExpected<bool>> result;
+    result.reserve(assets.size());
+
+    if (assets.empty()) {
+        return result;
+    }
+
+    bool fallback = false;
+    if (auto ret = activateBatchRequest(COMMAND_ARE_ASSETS_ACTIVABLE, assets, fallback)) {
+        for (const auto& frame : *ret) {
+            result.push_back(activableFromFrame(frame));
+        }
+    } else if (fallback) {
+        for (const auto& asset : assets) {
+            result.push_back(isActivable(asset));
+        }
+    } else {
+        result.assign(assets.size(), unexpected(ret.error()));
+    }
+    return result;
+}
+
+std::vector<AssetExpected<void>> activation::activate(const std::vector<std::string>& assets)
+{
+    std::vector<AssetExpected<void>> result;
+    result.reserve(assets.size());
+
+    if (assets.empty()) {
+        return result;
+    }
+
+    bool fallback = false;
+    if (auto ret = activateBatchRequest(COMMAND_ACTIVATE_ASSETS, assets, fallback)) {
+        // "OK" or the reason of the failure for each asset
+        for (const auto& frame : *ret) {
+            if (frame == "OK") {
+                result.emplace_back();
+            } else {
+                result.emplace_back(unexpected(frame));
+            }
+        }
+    } else if (fallback) {
+        for (const auto& asset : assets) {
+            result.push_back(activate(asset));
+        }
+    } else {
+        result.assign(assets.size(), unexpected(ret.error()));
+    }
+    return result;
+}
+
 AssetExpected<std::string> normName(const std::string& origName, uint32_t maxLen, uint32_t assetId)
 {
     if (origName.length() < maxLen) {
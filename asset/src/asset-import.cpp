@@ -4,15 +4,22 @@
 #include "asset/csv.h"
 #include "asset/json.h"
 #include <fty/string-utils.h>
+#include <fty_common_db_asset.h>
 #include <fty_common_db_connection.h>
 #include <fty_common_db_dbpath.h>
 #include <fty_log.h>
+#include <algorithm>
+#include <iterator>
+#include <optional>
 #include <regex>
+#include <unordered_map>
 
 #define AGENT_ASSET_ACTIVATOR "etn-licensing-credits"
 
 namespace fty::asset {
 
+using namespace fmt::literals;
+
 // template <typename KT, typename VT>
 // std::vector<KT> keys(const std::map<KT, VT>& map)
 //{
@@ -31,6 +38,114 @@ static std::string strip(const std::string& st)
     return std::regex_replace(std::regex_replace(st, re2, "\""), re, "'");
 }
 
+// Database access of row validation, the dry run reads a snapshot instead
+class Import::Lookup
+{
+public:
+    virtual ~Lookup() = default;
+
+    virtual Expected<std::map<std::string, int>> types()    = 0;
+    virtual Expected<std::map<std::string, int>> subtypes() = 0;
+
+    /// id of an internal name
+    virtual Expected<uint32_t> assetId(const std::string& name) = 0;
+
+    /// internal name of an external name
+    virtual Expected<std::string> assetName(const std::string& extName) = 0;
+
+    /// element by internal name, then by external name
+    virtual Expected<db::AssetElement>    element(const std::string& name) = 0;
+    virtual Expected<db::WebAssetElement> element(uint32_t id)             = 0;
+
+    /// datacenter of an element (itself if it is one), 0 if none
+    virtual uint32_t datacenter(uint32_t id) = 0;
+
+    /// checks that an asset fits in a rack, as tryToPlaceAsset()
+    virtual AssetExpected<void> place(uint32_t id, uint32_t parentId, uint32_t size, uint32_t loc) = 0;
+};
+
+class Import::DbLookup : public Import::Lookup
+{
+public:
+    Expected<std::map<std::string, int>> types() override
+    {
+        if (!m_types) {
+            m_types = db::readElementTypes();
+        }
+        return *m_types;
+    }
+
+    Expected<std::map<std::string, int>> subtypes() override
+    {
+        if (!m_subtypes) {
+            m_subtypes = db::readDeviceTypes();
+        }
+        return *m_subtypes;
+    }
+
+    Expected<uint32_t> assetId(const std::string& name) override
+    {
+        return db::nameToAssetId(name);
+    }
+
+    Expected<std::string> assetName(const std::string& extName) override
+    {
+        return db::extNameToAssetName(extName);
+    }
+
+    Expected<db::AssetElement> element(const std::string& name) override
+    {
+        return db::selectAssetElementByName(name);
+    }
+
+    Expected<db::WebAssetElement> element(uint32_t id) override
+    {
+        return db::selectAssetElementWebById(id);
+    }
+
+    uint32_t datacenter(uint32_t id) override
+    {
+        if (auto el = db::selectAssetElementWebById(id); el && el->typeId == persist::DATACENTER) {
+            return el->id;
+        }
+        if (auto dc = db::findParentByType(id, persist::DATACENTER)) {
+            return dc->id;
+        }
+        return 0;
+    }
+
+    AssetExpected<void> place(uint32_t id, uint32_t parentId, uint32_t size, uint32_t loc) override
+    {
+        return tryToPlaceAsset(id, parentId, size, loc);
+    }
+
+private:
+    // read once per import
+    std::optional<Expected<std::map<std::string, int>>> m_types;
+    std::optional<Expected<std::map<std::string, int>>> m_subtypes;
+};
+
+// Validated content of a csv row
+struct Import::Row
+{
+    std::string                        idStr; // internal name of the updated asset, empty for a new one
+    uint32_t                           id = 0;
+    std::string                        ename;
+    std::string                        name; // internal name owning the external name, if any
+    std::string                        type;
+    uint16_t                           typeId = 0;
+    std::string                        subtype;
+    uint16_t                           subtypeId        = 0;
+    int                                rackControllerId = 0;
+    std::string                        status;
+    std::string                        assetTag;
+    uint16_t                           priority = 0;
+    uint32_t                           parentId = 0;
+    std::set<uint32_t>                 groups;
+    std::vector<db::AssetLink>         links;
+    std::map<std::string, std::string> extattributes;
+};
+
 Import::Import(const CsvMap& cm)
     : m_cm(cm)
 {
@@ -60,7 +175,7 @@ std::string Import::mandatoryMissing() const
     return "";
 }
 
-std::map<std::string, std::string> Import::sanitizeRowExtNames(size_t row, bool sanitize) const
+std::map<std::string, std::string> Import::sanitizeRowExtNames(size_t row, bool sanitize, Lookup& lookup) const
 {
     static std::vector<std::string>    sanitizeList = {"location", "logical_asset", "power_source.", "group."};
     std::map<std::string, std::string> result;
@@ -81,7 +196,7 @@ std::map<std::string, std::string> Import::sanitizeRowExtNames(size_t row, bool
                         break;
                     }
 
-                    auto name = db::extNameToAssetName(strip(it->second));
+                    auto name = lookup.assetName(strip(it->second));
                     if (!name) {
                         logError(name.error());
                     } else {
@@ -93,7 +208,7 @@ std::map<std::string, std::string> Import::sanitizeRowExtNames(size_t row, bool
                 // simple name
                 auto it = result.find(item);
                 if (it != result.end()) {
-                    auto name = db::extNameToAssetName(strip(it->second));
+                    auto name = lookup.assetName(strip(it->second));
                     if (!name) {
                         logError(name.error());
                     } else {
@@ -163,6 +278,7 @@ AssetExpected<void> Import::process(bool checkLic)
         return unexpected(error(Errors::ParamRequired).format(m));
     }
 
+    DbLookup           lookup;
     std::set<uint32_t> ids;
     if (checkLic) {
         if (auto limitations = getLicensingLimitation(); !limitations) {
@@ -174,7 +290,7 @@ AssetExpected<void> Import::process(bool checkLic)
             }
 
             for (size_t row = 1; row != m_cm.rows(); ++row) {
-                if (auto it = processRow(row, ids, true, checkLic)) {
+                if (auto it = processRow(row, lookup, ids, true, checkLic)) {
                     ids.insert(it->id);
                     m_el.emplace(row, *it);
                 } else {
@@ -184,7 +300,7 @@ AssetExpected<void> Import::process(bool checkLic)
         }
     } else {
         for (size_t row = 1; row != m_cm.rows(); ++row) {
-            if (auto it = processRow(row, ids, true, checkLic)) {
+            if (auto it = processRow(row, lookup, ids, true, checkLic)) {
                 ids.insert(it->id);
                 m_el.emplace(row, *it);
             } else {
@@ -192,30 +308,56 @@ AssetExpected<void> Import::process(bool checkLic)
             }
         }
     }
+
+    activatePending();
     return {};
 }
 
-
-AssetExpected<db::AssetElement> Import::processRow(
-    size_t row, const std::set<uint32_t>& ids, bool sanitize, bool checkLic)
+void Import::activatePending()
 {
-    LOG_START;
+    if (m_toActivate.empty()) {
+        return;
+    }
 
-    logDebug("################ Row number is {}", row);
+    std::vector<std::string> assetsJson;
+    assetsJson.reserve(m_toActivate.size());
+    for (const auto& it : m_toActivate) {
+        assetsJson.push_back(it.second);
+    }
+
+    auto results = activation::activate(assetsJson);
+
+    auto res = results.begin();
+    for (const auto& it : m_toActivate) {
+        if (!*res) {
+            logError("Error during asset activation - {}", res->error());
+            AssetExpected<db::AssetElement> failed = unexpected("licensing-err", res->error());
+            m_el.erase(it.first);
+            m_el.emplace(it.first, unexpected(failed.error()));
+        }
+        ++res;
+    }
+    m_toActivate.clear();
+}
+
+
+AssetExpected<Import::Row> Import::validateRow(
+    size_t row, Lookup& lookup, const std::set<uint32_t>& ids, bool sanitize) const
+{
     static const std::set<std::string> statuses = {"active", "nonactive", "spare", "retired"};
 
-    auto types = db::readElementTypes();
+    auto types = lookup.types();
     if (!types) {
         return unexpected(error(Errors::InternalError).format(types.error()));
     }
 
-    auto subtypes = db::readDeviceTypes();
+    auto subtypes = lookup.subtypes();
     if (!subtypes) {
         return unexpected(error(Errors::InternalError).format(subtypes.error()));
     }
 
     // get location, powersource etc as name from ext.name
-    auto sanitizedAssetNames = sanitizeRowExtNames(row, sanitize);
+    auto sanitizedAssetNames = sanitizeRowExtNames(row, sanitize, lookup);
 
     auto unusedColumns = m_cm.getTitles();
     if (unusedColumns.empty()) {
@@ -254,11 +396,10 @@ AssetExpected<db::AssetElement> Import::processRow(
     }
 
     unusedColumns.erase("id");
-    m_operation = persist::asset_operation::INSERT;
     uint32_t id = 0;
 
     if (!idStr.empty()) {
-        if (auto tmp = db::nameToAssetId(idStr)) {
+        if (auto tmp = lookup.assetId(idStr)) {
             id = *tmp;
         } else {
             return unexpected(error(Errors::ElementNotFound).format(idStr));
@@ -267,7 +408,6 @@ AssetExpected<db::AssetElement> Import::processRow(
             return unexpected(
                 error(Errors::BadRequestDocument).format("Element id '{}' found twice, aborting"_tr.format(idStr)));
         }
-        m_operation = persist::asset_operation::UPDATE;
     }
 
     auto ename = strip(m_cm.get(row, "name"));
@@ -279,7 +419,7 @@ AssetExpected<db::AssetElement> Import::processRow(
             error(Errors::BadParams).format("name", "too long string"_tr, "unique string from 1 to 50 characters"_tr));
     }
 
-    auto nameRes = db::extNameToAssetName(ename);
+    auto nameRes = lookup.assetName(ename);
     if (!idStr.empty() && nameRes) {
         // internal name from DB must be the same as internal name from CSV
         if (*nameRes != idStr) {
@@ -337,7 +477,7 @@ AssetExpected<db::AssetElement> Import::processRow(
     logDebug("location = '{}'", location);
     uint32_t parentId = 0;
     if (!location.empty()) {
-        auto ret = db::selectAssetElementByName(location);
+        auto ret = lookup.element(location);
         if (ret) {
             parentId = ret->id;
         } else {
@@ -384,7 +524,7 @@ AssetExpected<db::AssetElement> Import::processRow(
     // now we have read all basic information about element
     // if id is set, then it is right time to check what is going on in DB
     if (!idStr.empty()) {
-        auto elementInDb = db::selectAssetElementWebById(id);
+        auto elementInDb = lookup.element(id);
         if (!elementInDb) {
             return unexpected(elementInDb.error());
         } else {
@@ -419,7 +559,7 @@ AssetExpected<db::AssetElement> Import::processRow(
         // if group was not specified, just skip it
         if (!group.empty()) {
             // find an id from DB
-            if (auto ret = db::selectAssetElementByName(group)) {
+            if (auto ret = lookup.element(group)) {
                 groups.insert(ret->id); // if OK, then take ID
             } else {
                 return unexpected(ret.error());
@@ -462,7 +602,7 @@ AssetExpected<db::AssetElement> Import::processRow(
         if (!linkSource.empty()) // if power source is not specified
         {
             // find an id from DB
-            if (auto ret = db::selectAssetElementByName(linkSource)) {
+            if (auto ret = lookup.element(linkSource)) {
                 oneLink.src = ret->id; // if OK, then take ID
             } else {
                 return unexpected(ret.error());
@@ -470,22 +610,12 @@ AssetExpected<db::AssetElement> Import::processRow(
 
             // check that power source in same dc as parentId
             if (parentId) {
-                uint64_t dcId = 0;
-                if (auto ret = db::selectAssetElementWebById(parentId)) {
-                    if (ret->typeId == persist::DATACENTER) {
-                        dcId = ret->id;
-                    } else {
-                        if (auto dc = db::findParentByType(parentId, persist::DATACENTER)) {
-                            dcId = dc->id;
-                        }
-                    }
-                }
-
-                auto fdc = db::findParentByType(oneLink.src, persist::DATACENTER);
-                if (!fdc) {
+                uint32_t dcId  = lookup.datacenter(parentId);
+                uint32_t srcDc = lookup.datacenter(oneLink.src);
+                if (!srcDc) {
                     return unexpected("Power source is not in DC");
                 }
-                if (dcId && dcId != fdc->id) {
+                if (dcId && dcId != srcDc) {
                     return unexpected("Power source is not in same DC");
                 }
             }
@@ -589,7 +719,7 @@ AssetExpected<db::AssetElement> Import::processRow(
             // check, that this asset exists
             value = sanitizedAssetNames.at("logical_asset");
 
-            if (auto ret = db::selectAssetElementByName(value); !ret) {
+            if (auto ret = lookup.element(value); !ret) {
                 return unexpected(ret.error());
             }
         } else if ((key == "calibration_offset_t" || key == "calibration_offset_h") && !value.empty()) {
@@ -665,13 +795,63 @@ AssetExpected<db::AssetElement> Import::processRow(
     }
 
     if (extattributes.count("u_size") && extattributes.count("location_u_pos")) {
-        auto ret = tryToPlaceAsset(id, parentId, convert<uint32_t>(extattributes["u_size"]),
+        auto ret = lookup.place(id, parentId, convert<uint32_t>(extattributes["u_size"]),
             convert<uint32_t>(extattributes["location_u_pos"]));
         if (!ret) {
             return unexpected(error(Errors::InternalError).format(ret.error()));
         }
     }
 
+    Row valid;
+    valid.idStr            = idStr;
+    valid.id               = id;
+    valid.ename            = ename;
+    valid.name             = name;
+    valid.type             = type;
+    valid.typeId           = typeId;
+    valid.subtype          = subtype;
+    valid.subtypeId        = subtypeId;
+    valid.rackControllerId = rackControllerId;
+    valid.status           = status;
+    valid.assetTag         = assetTag;
+    valid.priority         = priority;
+    valid.parentId         = parentId;
+    valid.groups           = std::move(groups);
+    valid.links            = std::move(links);
+    valid.extattributes    = std::move(extattributes);
+    return valid;
+}
+
+AssetExpected<db::AssetElement> Import::processRow(
+    size_t row, DbLookup& lookup, const std::set<uint32_t>& ids, bool sanitize, bool checkLic)
+{
+    LOG_START;
+
+    logDebug("################ Row number is {}", row);
+
+    auto valid = validateRow(row, lookup, ids, sanitize);
+    if (!valid) {
+        return unexpected(valid.error());
+    }
+
+    const std::string&                        idStr            = valid->idStr;
+    const std::string&                        ename            = valid->ename;
+    const std::string&                        name             = valid->name;
+    const std::string&                        type             = valid->type;
+    const std::string&                        status           = valid->status;
+    const std::string&                        assetTag         = valid->assetTag;
+    const std::set<uint32_t>&                 groups           = valid->groups;
+    const std::vector<db::AssetLink>&         links            = valid->links;
+    const std::map<std::string, std::string>& extattributes    = valid->extattributes;
+    uint32_t                                  id               = valid->id;
+    uint32_t                                  parentId         = valid->parentId;
+    uint16_t                                  priority         = valid->priority;
+    uint16_t                                  typeId           = valid->typeId;
+    uint16_t                                  subtypeId        = valid->subtypeId;
+    int                                       rackControllerId = valid->rackControllerId;
+
+    m_operation = idStr.empty() ? persist::asset_operation::INSERT : persist::asset_operation::UPDATE;
+
     fty::db::Connection conn;
 
     db::AssetElement el;
@@ -714,12 +894,8 @@ AssetExpected<db::AssetElement> Import::processRow(
                 }
 
                 if (type == "device" && status == "active" && subtypeId != rackControllerId && checkLic) {
-                    // check if we may activate the device
-                    std::string assetJson = getJsonAsset(el.id);
-                    if (auto res = activation::activate(assetJson); !res) {
-                        logError("Error during asset activation - {}", res.error());
-                        return unexpected("licensing-err", res.error());
-                    }
+                    // activated in one batch once all the rows are processed
+                    m_toActivate.emplace(row, getJsonAsset(el.id));
                 }
             } else {
                 fty::db::Transaction trans(conn);
@@ -774,12 +950,8 @@ AssetExpected<db::AssetElement> Import::processRow(
                 el.id = *ret;
 
                 if (type == "device" && status == "active" && subtypeId != rackControllerId && checkLic) {
-                    // check if we may activate the device
-                    std::string assetJson = getJsonAsset(el.id);
-                    if (auto res = activation::activate(assetJson); !res) {
-                        logError("Error during asset activation - {}", res.error());
-                        return unexpected("licensing-err", res.error());
-                    }
+                    // activated in one batch once all the rows are processed
+                    m_toActivate.emplace(row, getJsonAsset(el.id));
                 }
             } else {
                 // this is a transaction
@@ -1096,4 +1268,380 @@ Expected<uint32_t> Import::insertDevice(fty::db::Connection& conn, const std::ve
     return elementId;
 }
 
+// =====================================================================================================================
+// Dry run
+// =====================================================================================================================
+
+struct Import::Snapshot : public Import::Lookup
+{
+    std::map<std::string, int>                        elementTypes;
+    std::map<std::string, int>                        deviceTypes;
+    std::unordered_map<uint32_t, db::WebAssetElement> elements;
+    std::unordered_map<std::string, uint32_t>         byName;
+    std::unordered_map<std::string, uint32_t>         byExtName;
+    std::unordered_map<uint32_t, std::set<uint32_t>>  children;
+    std::map<uint32_t, db::Attributes>                ext;
+    std::map<uint32_t, std::set<ImportDiff::Link>>    links;
+    std::map<uint32_t, std::set<uint32_t>>            groups;
+    uint32_t                                          nextId = 1;
+
+    AssetExpected<void> load()
+    {
+        if (auto ret = db::readElementTypes()) {
+            elementTypes = *ret;
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        if (auto ret = db::readDeviceTypes()) {
+            deviceTypes = *ret;
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        if (auto ret = db::selectAssetElementAll()) {
+            for (auto& el : *ret) {
+                add(std::move(el));
+            }
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        if (auto ret = db::selectExtAttributesAll()) {
+            ext = std::move(*ret);
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        if (auto ret = db::selectAssetLinksAll(INPUT_POWER_CHAIN)) {
+            for (const auto& lnk : *ret) {
+                if (auto src = elements.find(lnk.src); src != elements.end()) {
+                    links[lnk.dest].insert({src->second.name, lnk.srcOut, lnk.destIn});
+                }
+            }
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        if (auto ret = db::selectAssetGroupsAll()) {
+            groups = std::move(*ret);
+        } else {
+            return unexpected(error(Errors::InternalError).format(ret.error()));
+        }
+
+        return {};
+    }
+
+    void add(db::WebAssetElement&& el)
+    {
+        nextId = std::max(nextId, el.id + 1);
+        byName[el.name] = el.id;
+        if (!el.extName.empty()) {
+            byExtName[el.extName] = el.id;
+        }
+        children[el.parentId].insert(el.id);
+        uint32_t id  = el.id;
+        elements[id] = std::move(el);
+    }
+
+    // same lookup order as db::selectAssetElementByName: internal name first, then external one
+    const db::WebAssetElement* find(const std::string& name) const
+    {
+        auto it = byName.find(name);
+        if (it == byName.end()) {
+            it = byExtName.find(name);
+            if (it == byExtName.end()) {
+                return nullptr;
+            }
+        }
+        return &elements.at(it->second);
+    }
+
+    const db::WebAssetElement* find(uint32_t id) const
+    {
+        auto it = elements.find(id);
+        return it != elements.end() ? &it->second : nullptr;
+    }
+
+    std::string extName(uint32_t id) const
+    {
+        auto el = find(id);
+        return el ? el->extName : std::string{};
+    }
+
+    Expected<std::map<std::string, int>> types() override
+    {
+        return elementTypes;
+    }
+
+    Expected<std::map<std::string, int>> subtypes() override
+    {
+        return deviceTypes;
+    }
+
+    Expected<uint32_t> assetId(const std::string& name) override
+    {
+        if (auto it = byName.find(name); it != byName.end()) {
+            return it->second;
+        }
+        return unexpected(error(Errors::ElementNotFound).format(name));
+    }
+
+    Expected<std::string> assetName(const std::string& extName) override
+    {
+        if (auto it = byExtName.find(extName); it != byExtName.end()) {
+            return elements.at(it->second).name;
+        }
+        return unexpected(error(Errors::ElementNotFound).format(extName));
+    }
+
+    Expected<db::AssetElement> element(const std::string& name) override
+    {
+        if (auto el = find(name)) {
+            return db::AssetElement(*el);
+        }
+        return unexpected(error(Errors::ElementNotFound).format(name));
+    }
+
+    Expected<db::WebAssetElement> element(uint32_t id) override
+    {
+        if (auto el = find(id)) {
+            return *el;
+        }
+        return unexpected(error(Errors::ElementNotFound).format(id));
+    }
+
+    uint32_t datacenter(uint32_t id) override
+    {
+        for (auto el = find(id); el; el = find(el->parentId)) {
+            if (el->typeId == persist::DATACENTER) {
+                return el->id;
+            }
+        }
+        return 0;
+    }
+
+    // tryToPlaceAsset() on the snapshot
+    AssetExpected<void> place(uint32_t id, uint32_t parentId, uint32_t size, uint32_t loc) override
+    {
+        if (!loc) {
+            return unexpected("Position is wrong, should be greater than 0"_tr);
+        }
+
+        if (!size) {
+            return unexpected("Size is wrong, should be greater than 0"_tr);
+        }
+
+        const db::Attributes& attr = attributes(parentId);
+        if (!attr.count("u_size")) {
+            return unexpected("Size is not set"_tr);
+        }
+
+        std::vector<bool> place;
+        place.resize(convert<size_t>(attr.at("u_size").value), false);
+
+        for (uint32_t child : children[parentId]) {
+            if (child == id) {
+                continue;
+            }
+
+            const db::Attributes& chAttr = attributes(child);
+            if (!chAttr.count("u_size") || !chAttr.count("location_u_pos")) {
+                continue;
+            }
+
+            size_t isize = convert<size_t>(chAttr.at("u_size").value);
+            size_t iloc  = convert<size_t>(chAttr.at("location_u_pos").value) - 1;
+
+            for (size_t i = iloc; i < iloc + isize; ++i) {
+                if (i < place.size()) {
+                    place[i] = true;
+                }
+            }
+        }
+
+        for (size_t i = loc - 1; i < loc + size - 1; ++i) {
+            if (i >= place.size()) {
+                return unexpected("Asset is out bounds"_tr);
+            }
+            if (place[i]) {
+                return unexpected("Asset place is occupied"_tr);
+            }
+        }
+
+        return {};
+    }
+
+    const db::Attributes& attributes(uint32_t id) const
+    {
+        static const db::Attributes empty;
+
+        auto it = ext.find(id);
+        return it != ext.end() ? it->second : empty;
+    }
+
+    // what the import of a row writes, seen by the following rows
+    void apply(uint32_t id, const Row& row, const std::set<ImportDiff::Link>& rowLinks)
+    {
+        db::WebAssetElement& el = elements.at(id);
+        if (el.parentId != row.parentId) {
+            children[el.parentId].erase(id);
+            children[row.parentId].insert(id);
+            el.parentId = row.parentId;
+        }
+        el.status   = row.status;
+        el.priority = row.priority;
+        el.assetTag = row.assetTag;
+
+        // read-write attributes are replaced
+        db::Attributes& attrs = ext[id];
+        for (auto it = attrs.begin(); it != attrs.end();) {
+            it = it->second.readOnly ? std::next(it) : attrs.erase(it);
+        }
+        for (const auto& [key, value] : row.extattributes) {
+            attrs[key] = {value, false};
+        }
+
+        links[id]  = rowLinks;
+        groups[id] = row.groups;
+    }
+};
+
+const Import::DiffResMap& Import::diffs() const
+{
+    return m_diff;
+}
+
+AssetExpected<void> Import::diff()
+{
+    auto m = mandatoryMissing();
+    if (m != "") {
+        logError("column '{}' is missing, dry run is aborted", m);
+        return unexpected(error(Errors::ParamRequired).format(m));
+    }
+
+    Snapshot snap;
+    if (auto ret = snap.load(); !ret) {
+        return unexpected(ret.error());
+    }
+
+    std::set<uint32_t> ids;
+    for (size_t row = 1; row != m_cm.rows(); ++row) {
+        auto it = diffRow(row, snap, ids);
+        if (it && !it->iname.empty()) {
+            ids.insert(snap.byName.at(it->iname));
+        }
+        m_diff.emplace(row, std::move(it));
+    }
+    return {};
+}
+
+AssetExpected<ImportDiff> Import::diffRow(size_t row, Snapshot& snap, const std::set<uint32_t>& ids) const
+{
+    auto valid = validateRow(row, snap, ids, true);
+    if (!valid) {
+        return unexpected(valid.error());
+    }
+
+    // insert fails in database if the name exists
+    if (valid->idStr.empty() && !valid->name.empty()) {
+        return unexpected(
+            "Element '{}' cannot be processed because of conflict. Most likely duplicate entry."_tr.format(valid->ename));
+    }
+
+    std::set<ImportDiff::Link> rowLinks;
+    for (const auto& link : valid->links) {
+        rowLinks.insert({snap.find(link.src)->name, link.srcOut, link.destIn});
+    }
+
+    const auto& extattributes = valid->extattributes;
+    const auto& groups        = valid->groups;
+    std::string priority      = "P{}"_format(valid->priority);
+
+    ImportDiff diff;
+    diff.name = valid->ename;
+
+    if (valid->idStr.empty()) {
+        // register new asset, so following rows can refer to it
+        db::WebAssetElement el;
+        el.id        = snap.nextId;
+        el.name      = "{}-{}"_format(valid->type, el.id);
+        el.extName   = valid->ename;
+        el.typeId    = valid->typeId;
+        el.subtypeId = valid->subtypeId;
+        el.parentId  = valid->parentId;
+        uint32_t id  = el.id;
+        snap.add(std::move(el));
+        snap.apply(id, *valid, rowLinks);
+
+        diff.action = ImportDiff::Action::Insert;
+        diff.fields["location"]  = {{}, snap.extName(valid->parentId)};
+        diff.fields["status"]    = {{}, valid->status};
+        diff.fields["priority"]  = {{}, priority};
+        diff.fields["asset_tag"] = {{}, valid->assetTag};
+        for (const auto& [key, value] : extattributes) {
+            diff.ext[key] = {{}, value};
+        }
+        diff.linksAdded.assign(rowLinks.begin(), rowLinks.end());
+        for (auto grp : groups) {
+            diff.groupsAdded.push_back(snap.extName(grp));
+        }
+        return diff;
+    }
+
+    const db::WebAssetElement& current = *snap.find(valid->id);
+    diff.iname = current.name;
+
+    auto compare = [&](const std::string& field, const std::string& before, const std::string& after) {
+        if (before != after) {
+            diff.fields[field] = {before, after};
+        }
+    };
+    compare("location", snap.extName(current.parentId), snap.extName(valid->parentId));
+    compare("status", current.status, valid->status);
+    compare("priority", "P{}"_format(current.priority), priority);
+    compare("asset_tag", current.assetTag, valid->assetTag);
+
+    // import replaces all read-write attributes, read-only ones are kept unless overwritten
+    const db::Attributes& before = snap.attributes(current.id);
+    for (const auto& [key, value] : extattributes) {
+        auto it = before.find(key);
+        if (it == before.end() || it->second.value != value) {
+            diff.ext[key] = {it == before.end() ? std::string{} : it->second.value, value};
+        }
+    }
+    for (const auto& [key, value] : before) {
+        if (!value.readOnly && !extattributes.count(key)) {
+            diff.ext[key] = {value.value, {}};
+        }
+    }
+
+    static const std::set<ImportDiff::Link> noLinks;
+    auto                                    lnkIt    = snap.links.find(current.id);
+    const std::set<ImportDiff::Link>&       oldLinks = lnkIt != snap.links.end() ? lnkIt->second : noLinks;
+    std::set_difference(rowLinks.begin(), rowLinks.end(), oldLinks.begin(), oldLinks.end(), std::back_inserter(diff.linksAdded));
+    std::set_difference(oldLinks.begin(), oldLinks.end(), rowLinks.begin(), rowLinks.end(), std::back_inserter(diff.linksRemoved));
+
+    static const std::set<uint32_t> noGroups;
+    auto                            grpIt     = snap.groups.find(current.id);
+    const std::set<uint32_t>&       oldGroups = grpIt != snap.groups.end() ? grpIt->second : noGroups;
+    for (auto grp : groups) {
+        if (!oldGroups.count(grp)) {
+            diff.groupsAdded.push_back(snap.extName(grp));
+        }
+    }
+    for (auto grp : oldGroups) {
+        if (!groups.count(grp)) {
+            diff.groupsRemoved.push_back(snap.extName(grp));
+        }
+    }
+
+    bool changed = !diff.fields.empty() || !diff.ext.empty() || !diff.linksAdded.empty() ||
+                   !diff.linksRemoved.empty() || !diff.groupsAdded.empty() || !diff.groupsRemoved.empty();
+    diff.action = changed ? ImportDiff::Action::Update : ImportDiff::Action::NoOp;
+
+    snap.apply(current.id, *valid, rowLinks);
+    return diff;
+}
+
 } // namespace fty::asset
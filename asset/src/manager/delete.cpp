@@ -3,6 +3,7 @@
 #include "asset/asset-manager.h"
 #include <fty_common_db_connection.h>
 #include "asset/json.h"
+#include <fty_asset_id_resolver.h>
 #include <fty_common_asset_types.h>
 #include "asset/asset-helpers.h"
 #include <fty_log.h>
@@ -199,6 +200,11 @@ AssetExpected<db::AssetElement> AssetManager::deleteAsset(const db::AssetElement
         }
     }
 
+    if (ret) {
+        // the name may be reused by a new asset, with a new id
+        AssetIdResolver::instance().invalidate(asset.name);
+    }
+
     if (sendNotify) {
         try {
             logDebug("Deleting all mappings for asset {}", asset.name);
@@ -1,26 +1,42 @@
 #include "asset/asset-manager.h"
-#include <cxxtools/csvserializer.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <fty/string-utils.h>
+#include <future>
+#include <limits>
+#include <ostream>
+#include <set>
+#include <thread>
 
 namespace fty::asset {
 
 using namespace fmt::literals;
 
+// Writes csv rows into one reusable buffer and passes it to the sink once it holds at least chunkSize bytes.
+// Quoting follows cxxtools::CsvSerializer: a field is quoted only if it contains delimiter, quote or line break.
 class LineCsvSerializer
 {
 public:
-    explicit LineCsvSerializer(std::ostream& out)
-        : _cs{out}
+    LineCsvSerializer(const AssetManager::ExportSink& sink, size_t chunkSize)
+        : _sink(sink)
+        , _chunkSize(chunkSize)
     {
+        _buf.reserve(chunkSize + 1024);
     }
 
     void add(const std::string& s)
     {
+        if (!_firstInRow) {
+            _buf += Delimiter;
+        }
+        _firstInRow = false;
+
         // escap = if it's the first char to avoid excel command -> Do not care when reimporting
         if (!s.empty() && (s[0] == '=')) {
-            _buf.push_back("'" + s);
+            append("'" + s);
         } else {
-            _buf.push_back(s);
+            append(s);
         }
     }
 
@@ -31,15 +47,49 @@ public:
 
     void serialize()
     {
-        std::vector<std::vector<std::string>> aux{};
-        aux.push_back(_buf);
-        _cs.serialize(aux);
-        _buf.clear();
+        _buf += LineEnding;
+        _firstInRow = true;
+        if (_buf.size() >= _chunkSize) {
+            flush();
+        }
     }
 
-protected:
-    cxxtools::CsvSerializer  _cs;
-    std::vector<std::string> _buf;
+    void flush()
+    {
+        if (!_buf.empty()) {
+            _sink(_buf);
+            _buf.clear();
+        }
+    }
+
+private:
+    void append(const std::string& s)
+    {
+        if (s.find_first_of(NeedsQuote) == std::string::npos) {
+            _buf += s;
+            return;
+        }
+
+        _buf += Quote;
+        for (char ch : s) {
+            if (ch == Quote) {
+                _buf += Quote;
+            }
+            _buf += ch;
+        }
+        _buf += Quote;
+    }
+
+private:
+    static constexpr char        Delimiter  = ',';
+    static constexpr char        Quote      = '"';
+    static constexpr char        LineEnding = '\n';
+    static constexpr const char* NeedsQuote = ",\"\r\n";
+
+    const AssetManager::ExportSink& _sink;
+    size_t                          _chunkSize;
+    std::string                     _buf;
+    bool                            _firstInRow = true;
 };
 
 namespace {
@@ -58,31 +108,17 @@ namespace {
         std::vector<Element>       children;
         std::vector<Element*>      links;
         bool                       isExported = false;
+        size_t                     job        = 0; // parallel export: index of the job which owns this element
     };
 } // namespace
 
 class Exporter
 {
 public:
-    AssetExpected<std::string> exportCsv(const std::optional<db::AssetElement>& dc)
+    AssetExpected<void> exportCsv(
+        const std::optional<db::AssetElement>& dc, const AssetManager::ExportSink& sink, size_t chunkSize)
     {
-        std::stringstream ss;
-        LineCsvSerializer lcs(ss);
-
-        if (auto ret = db::maxNumberOfPowerLinks()) {
-            m_maxPowerLinks = *ret;
-        } else {
-            return unexpected(ret.error());
-        }
-
-        if (auto ret = db::maxNumberOfAssetGroups()) {
-            m_maxGroups = *ret;
-        } else {
-            return unexpected(ret.error());
-        }
-
-        // put all remaining keys from the database
-        if (auto ret = updateKeytags(m_keytags); !ret) {
+        if (auto ret = fetchLayout(); !ret) {
             return unexpected(ret.error());
         }
 
@@ -91,6 +127,8 @@ public:
             return unexpected(ret.error());
         }
 
+        LineCsvSerializer lcs(sink, chunkSize);
+
         // print the first row with names
         createHeader(lcs);
 
@@ -101,7 +139,129 @@ public:
             }
         }
 
-        return ss.str();
+        lcs.flush();
+        return {};
+    }
+
+    AssetExpected<void> exportCsvParallel(const AssetManager::ExportSink& sink, size_t chunkSize, unsigned workers)
+    {
+        if (auto ret = fetchLayout(); !ret) {
+            return unexpected(ret.error());
+        }
+
+        if (auto ret = fetchElements(std::nullopt); !ret) {
+            return unexpected(ret.error());
+        }
+
+        // job 0: assets outside of datacenters (groups, unlocated devices), then one job per datacenter by id
+        std::vector<std::vector<Element*>> jobs(1);
+        std::vector<Element*>              dcs;
+        for (auto& it : m_root.children) {
+            if (it.element->typeId == persist::asset_type::DATACENTER) {
+                dcs.push_back(&it);
+            } else {
+                jobs[0].push_back(&it);
+            }
+        }
+        std::sort(dcs.begin(), dcs.end(), [](const Element* l, const Element* r) {
+            return l->element->id < r->element->id;
+        });
+        for (auto dc : dcs) {
+            setJob(*dc, jobs.size());
+            jobs.push_back({dc});
+        }
+        jobs = orderJobs(std::move(jobs));
+
+        {
+            LineCsvSerializer lcs(sink, chunkSize);
+            createHeader(lcs);
+            lcs.flush();
+        }
+
+        std::vector<std::promise<AssetExpected<std::string>>> promises(jobs.size());
+        std::vector<std::future<AssetExpected<std::string>>>  results;
+        for (auto& promise : promises) {
+            results.push_back(promise.get_future());
+        }
+
+        std::atomic<size_t> next{0};
+        std::atomic<bool>   cancel{false};
+
+        // every job writes only its own elements, the tree itself is read only at this point
+        auto worker = [&]() {
+            for (size_t i = next++; i < jobs.size(); i = next++) {
+                if (cancel) {
+                    promises[i].set_value(std::string{});
+                    continue;
+                }
+                try {
+                    std::string                    out;
+                    const AssetManager::ExportSink jobSink = [&](const std::string& chunk) {
+                        out += chunk;
+                    };
+                    LineCsvSerializer lcs(jobSink, chunkSize);
+
+                    std::optional<Translate> err;
+                    for (auto el : jobs[i]) {
+                        if (auto ret = exportRow(*el, lcs); !ret) {
+                            err = ret.error();
+                            break;
+                        }
+                    }
+
+                    if (err) {
+                        promises[i].set_value(unexpected(*err));
+                    } else {
+                        lcs.flush();
+                        promises[i].set_value(std::move(out));
+                    }
+                } catch (const std::exception& e) {
+                    promises[i].set_value(unexpected(error(Errors::InternalError).format(e.what())));
+                } catch (...) {
+                    promises[i].set_value(unexpected(error(Errors::InternalError).format("unknown exception")));
+                }
+            }
+        };
+
+        if (!workers) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < std::min<size_t>(workers, jobs.size()); ++i) {
+            pool.emplace_back(worker);
+        }
+
+        // concatenate in job order, as soon as every job is done
+        std::optional<Translate> err;
+        try {
+            for (auto& res : results) {
+                auto out = res.get();
+                if (!out) {
+                    err = out.error();
+                    break;
+                }
+                if (!out->empty()) {
+                    sink(*out);
+                }
+            }
+        } catch (...) {
+            cancel = true;
+            for (auto& th : pool) {
+                th.join();
+            }
+            throw;
+        }
+
+        cancel = true;
+        for (auto& th : pool) {
+            th.join();
+        }
+
+        if (err) {
+            return unexpected(*err);
+        }
+        return {};
     }
 
 private:
@@ -112,6 +272,10 @@ private:
         }
 
         for (auto& ch : el.links) {
+            // power source from other part of parallel export is exported there, by an earlier job
+            if (ch->job != el.job) {
+                continue;
+            }
             if (auto ret = exportRow(*ch, lcs); !ret) {
                 return unexpected(ret.error());
             }
@@ -238,6 +402,112 @@ private:
         return {};
     }
 
+    AssetExpected<void> fetchLayout()
+    {
+        if (auto ret = db::maxNumberOfPowerLinks()) {
+            m_maxPowerLinks = *ret;
+        } else {
+            return unexpected(ret.error());
+        }
+
+        if (auto ret = db::maxNumberOfAssetGroups()) {
+            m_maxGroups = *ret;
+        } else {
+            return unexpected(ret.error());
+        }
+
+        // put all remaining keys from the database
+        return updateKeytags(m_keytags);
+    }
+
+    void setJob(Element& el, size_t job)
+    {
+        el.job = job;
+        for (auto& ch : el.children) {
+            setJob(ch, job);
+        }
+    }
+
+    void collectSources(const Element& el, std::vector<std::set<size_t>>& sources)
+    {
+        for (auto src : el.links) {
+            if (src->job != el.job) {
+                sources[el.job].insert(src->job);
+            }
+        }
+        for (auto& ch : el.children) {
+            collectSources(ch, sources);
+        }
+    }
+
+    // Orders jobs so that every power source is exported before the assets it powers, as the import expects.
+    // Jobs powering each other are merged into one, power links are then followed inside it as in serial export.
+    // Without power links between jobs, the order is kept.
+    std::vector<std::vector<Element*>> orderJobs(std::vector<std::vector<Element*>> jobs)
+    {
+        std::vector<std::set<size_t>> sources(jobs.size());
+        for (const auto& job : jobs) {
+            for (auto el : job) {
+                collectSources(*el, sources);
+            }
+        }
+
+        // strongly connected components (Tarjan) of the jobs graph, walked from powered jobs to their sources:
+        // every component is complete once all its sources are, so sources come first
+        constexpr size_t                   unvisited = std::numeric_limits<size_t>::max();
+        std::vector<std::vector<Element*>> ordered;
+        std::vector<size_t>                index(jobs.size(), unvisited);
+        std::vector<size_t>                low(jobs.size(), 0);
+        std::vector<bool>                  onStack(jobs.size(), false);
+        std::vector<size_t>                stack;
+        size_t                             counter = 0;
+
+        std::function<void(size_t)> visit = [&](size_t job) {
+            index[job] = low[job] = counter++;
+            stack.push_back(job);
+            onStack[job] = true;
+
+            for (size_t src : sources[job]) {
+                if (index[src] == unvisited) {
+                    visit(src);
+                    low[job] = std::min(low[job], low[src]);
+                } else if (onStack[src]) {
+                    low[job] = std::min(low[job], index[src]);
+                }
+            }
+
+            if (low[job] != index[job]) {
+                return;
+            }
+
+            std::vector<size_t> component;
+            size_t              member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                component.push_back(member);
+            } while (member != job);
+            std::sort(component.begin(), component.end());
+
+            std::vector<Element*> merged;
+            for (size_t it : component) {
+                for (auto el : jobs[it]) {
+                    setJob(*el, ordered.size());
+                    merged.push_back(el);
+                }
+            }
+            ordered.push_back(std::move(merged));
+        };
+
+        for (size_t job = 0; job < jobs.size(); ++job) {
+            if (index[job] == unvisited) {
+                visit(job);
+            }
+        }
+        return ordered;
+    }
+
     void createHeader(LineCsvSerializer& lcs)
     {
         // names from asset element table itself
@@ -393,9 +663,44 @@ private:
 // =====================================================================================================================
 
 AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::AssetElement>& dc)
+{
+    std::string out;
+    if (auto ret = exportCsv(
+            [&](const std::string& chunk) {
+                out += chunk;
+            },
+            dc);
+        !ret) {
+        return unexpected(ret.error());
+    }
+    return out;
+}
+
+AssetExpected<void> AssetManager::exportCsv(std::ostream& out, const std::optional<db::AssetElement>& dc)
+{
+    auto ret = exportCsv(
+        [&](const std::string& chunk) {
+            out.write(chunk.data(), std::streamsize(chunk.size()));
+        },
+        dc);
+
+    if (ret && !out) {
+        return unexpected(error(Errors::InternalError).format("Cannot write exported csv"));
+    }
+    return ret;
+}
+
+AssetExpected<void> AssetManager::exportCsv(
+    const ExportSink& sink, const std::optional<db::AssetElement>& dc, size_t chunkSize)
+{
+    Exporter ex;
+    return ex.exportCsv(dc, sink, chunkSize);
+}
+
+AssetExpected<void> AssetManager::exportCsvParallel(const ExportSink& sink, unsigned workers, size_t chunkSize)
 {
     Exporter ex;
-    return ex.exportCsv(dc);
+    return ex.exportCsvParallel(sink, chunkSize, workers);
 }
 
 } // namespace fty::asset
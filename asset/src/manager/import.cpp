@@ -1,7 +1,9 @@
+#include "asset/asset-configure-inform.h"
 #include "asset/asset-import.h"
 #include "asset/asset-manager.h"
 #include "asset/csv.h"
 #include <fty/string-utils.h>
+#include <fty_log.h>
 
 #define CREATE_MODE_CSV 2
 
@@ -51,11 +53,16 @@ static std::string sanitize(const std::string& csvStr)
     return implode(out, "\n");
 }
 
-AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
-    const std::string& csvStr, const std::string& user, bool sendNotify)
+static CsvMap readCsv(const std::string& csvStr)
 {
     std::stringstream ss(sanitize(csvStr));
-    CsvMap            csv = CsvMap_from_istream(ss);
+    return CsvMap_from_istream(ss);
+}
+
+AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
+    const std::string& csvStr, const std::string& user, bool sendNotify, ConfigureBatcher* notify)
+{
+    CsvMap csv = readCsv(csvStr);
 
     csv.setCreateMode(CREATE_MODE_CSV);
     csv.setCreateUser(user);
@@ -68,6 +75,13 @@ AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
         for(const auto&[row, el]: list) {
             if (el) {
                 res.emplace(row, el->id);
+                if (notify) {
+                    auto op = csv.hasTitle("id") && !csv.get(row, "id").empty() ? persist::asset_operation::UPDATE
+                                                                                  : persist::asset_operation::INSERT;
+                    if (auto sent = notify->add(*el, op); !sent) {
+                        logError("Cannot send asset notifications: {}", sent.error());
+                    }
+                }
             } else {
                 res.emplace(row, unexpected(el.error()));
             }
@@ -78,4 +92,16 @@ AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
     }
 }
 
+AssetExpected<AssetManager::ImportDiffList> AssetManager::importCsvDryRun(const std::string& csvStr)
+{
+    CsvMap csv = readCsv(csvStr);
+
+    Import import(csv);
+    if (auto ret = import.diff()) {
+        return import.diffs();
+    } else {
+        return unexpected(ret.error());
+    }
+}
+
 } // namespace fty::asset
@@ -0,0 +1,190 @@
+#include "asset/asset-configure-inform.h"
+#include "asset/asset-db.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <fty_proto.h>
+#include <map>
+#include <test-db/sample-db.h>
+
+namespace {
+
+// Keeps sent messages instead of publishing them
+class TestBatcher : public fty::asset::ConfigureBatcher
+{
+public:
+    struct Sent
+    {
+        std::string subject;
+        std::string name;
+        std::string operation;
+        std::vector<std::string> upses;
+    };
+
+    TestBatcher(size_t maxPending = 256)
+        : fty::asset::ConfigureBatcher("configure-test", maxPending)
+    {
+    }
+
+    std::vector<Sent> sent;
+
+protected:
+    fty::Expected<void> publish(const std::string& subject, zmsg_t** msg) override
+    {
+        fty_proto_t* proto = fty_proto_decode(msg);
+        REQUIRE(proto);
+
+        Sent one;
+        one.subject   = subject;
+        one.name      = fty_proto_name(proto);
+        one.operation = fty_proto_operation(proto);
+        for (int i = 0;; ++i) {
+            const char* ups = fty_proto_aux_string(proto, ("ups" + std::to_string(i)).c_str(), nullptr);
+            if (!ups) {
+                break;
+            }
+            one.upses.push_back(ups);
+        }
+        fty_proto_destroy(&proto);
+
+        sent.push_back(one);
+        return {};
+    }
+
+    void requestRepublish(const std::string& /*assetName*/) override
+    {
+    }
+};
+
+} // namespace
+
+static fty::asset::db::AssetElement element(fty::SampleDb& db, const std::string& name)
+{
+    auto ret = fty::asset::db::selectAssetElementWebById(db.idByName(name));
+    REQUIRE(ret);
+    return *ret;
+}
+
+TEST_CASE("Configure / Coalescing")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type : Feed
+                    name : feed1
+                  - type : Feed
+                    name : feed2
+                  - type : Feed
+                    name : feed3
+    )");
+
+    using persist::asset_operation;
+
+    TestBatcher batcher;
+
+    // created then updated: one create
+    REQUIRE(batcher.add(element(db, "feed1"), asset_operation::INSERT));
+    REQUIRE(batcher.add(element(db, "feed1"), asset_operation::UPDATE));
+
+    // created then deleted: nothing
+    REQUIRE(batcher.add(element(db, "feed2"), asset_operation::INSERT));
+    REQUIRE(batcher.add(element(db, "feed2"), asset_operation::UPDATE));
+    REQUIRE(batcher.add(element(db, "feed2"), asset_operation::DELETE));
+
+    // updated then deleted: delete, after the removed entry
+    REQUIRE(batcher.add(element(db, "feed3"), asset_operation::UPDATE));
+    REQUIRE(batcher.add(element(db, "feed3"), asset_operation::DELETE));
+
+    // coalesced with its pending notification, not with the dropped one
+    REQUIRE(batcher.add(element(db, "feed3"), asset_operation::UPDATE));
+
+    CHECK(batcher.sent.empty());
+    REQUIRE(batcher.flush());
+
+    REQUIRE(batcher.sent.size() == 2);
+    CHECK(batcher.sent[0].name == "feed1");
+    CHECK(batcher.sent[0].operation == FTY_PROTO_ASSET_OP_CREATE);
+    CHECK(batcher.sent[1].name == "feed3");
+    CHECK(batcher.sent[1].operation == FTY_PROTO_ASSET_OP_UPDATE);
+
+    // flushed: the same asset is notified again
+    REQUIRE(batcher.add(element(db, "feed1"), asset_operation::DELETE));
+    REQUIRE(batcher.flush());
+    REQUIRE(batcher.sent.size() == 3);
+    CHECK(batcher.sent[2].name == "feed1");
+    CHECK(batcher.sent[2].operation == FTY_PROTO_ASSET_OP_DELETE);
+}
+
+TEST_CASE("Configure / Queue full")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type : Feed
+                    name : feed1
+                  - type : Feed
+                    name : feed2
+    )");
+
+    TestBatcher batcher(2);
+    REQUIRE(batcher.add(element(db, "feed1"), persist::asset_operation::UPDATE));
+    CHECK(batcher.sent.empty());
+    REQUIRE(batcher.add(element(db, "feed2"), persist::asset_operation::UPDATE));
+    CHECK(batcher.sent.size() == 2);
+}
+
+TEST_CASE("Configure / UPS inventory per datacenter")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter1
+              ext-name : Data Center 1
+              items :
+                  - type : Ups
+                    name : ups1
+                  - type : Ups
+                    name : ups2
+                  - type : Feed
+                    name : feed1
+            - type     : Datacenter
+              name     : datacenter2
+              ext-name : Data Center 2
+              items :
+                  - type : Ups
+                    name : ups3
+    )");
+
+    using persist::asset_operation;
+
+    TestBatcher batcher;
+    REQUIRE(batcher.add(element(db, "ups1"), asset_operation::UPDATE));
+    REQUIRE(batcher.add(element(db, "ups2"), asset_operation::UPDATE));
+    REQUIRE(batcher.add(element(db, "ups3"), asset_operation::UPDATE));
+    REQUIRE(batcher.add(element(db, "feed1"), asset_operation::UPDATE));
+    REQUIRE(batcher.flush());
+
+    // 4 assets, then one inventory per datacenter with ups
+    REQUIRE(batcher.sent.size() == 6);
+
+    std::map<std::string, TestBatcher::Sent> inventory;
+    for (const auto& it : batcher.sent) {
+        if (it.operation == "inventory") {
+            inventory.emplace(it.name, it);
+        }
+    }
+    REQUIRE(inventory.size() == 2);
+
+    auto dc1 = inventory.at("datacenter1");
+    CHECK(dc1.subject == "datacenter.unknown@datacenter1");
+    std::sort(dc1.upses.begin(), dc1.upses.end());
+    CHECK(dc1.upses == std::vector<std::string>{"ups1", "ups2"});
+
+    auto dc2 = inventory.at("datacenter2");
+    CHECK(dc2.upses == std::vector<std::string>{"ups3"});
+}
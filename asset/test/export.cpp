@@ -112,3 +112,191 @@ TEST_CASE("Export asset / Wrong power order")
 
     CHECK(*exp == csvTrim(data));
 }
+
+TEST_CASE("Export asset / Stream")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type     : Server
+                    name     : srv
+                    ext-name : Server
+                  - type     : Server
+                    name     : srv1
+                    ext-name : Server, "quoted"
+    )");
+
+    auto exp = fty::asset::AssetManager::exportCsv();
+    REQUIRE_EXP(exp);
+    CHECK(exp->find(R"("Server, ""quoted""")") != std::string::npos);
+
+    std::stringstream ss;
+    REQUIRE_EXP(fty::asset::AssetManager::exportCsv(ss));
+    CHECK(ss.str() == *exp);
+
+    std::vector<std::string> chunks;
+    auto ret = fty::asset::AssetManager::exportCsv(
+        [&](const std::string& chunk) {
+            chunks.push_back(chunk);
+        },
+        std::nullopt, 10);
+    REQUIRE_EXP(ret);
+    // every row is flushed as soon as it is over chunk size
+    CHECK(chunks.size() == 4);
+    CHECK(fty::implode(chunks, "") == *exp);
+}
+
+TEST_CASE("Export asset / Parallel")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type     : Server
+                    name     : srv
+                    ext-name : Server
+            - type     : Datacenter
+              name     : datacenter1
+              ext-name : Data Center 1
+              items :
+                  - type     : Feed
+                    name     : feed
+                    ext-name : Feed
+                  - type     : Server
+                    name     : srv1
+                    ext-name : Server 1
+        links:
+            - dest : srv1
+              src  : feed
+              type : power chain
+    )");
+
+    auto serial = fty::asset::AssetManager::exportCsv();
+    REQUIRE_EXP(serial);
+
+    std::string parallel;
+    auto        ret = fty::asset::AssetManager::exportCsvParallel(
+        [&](const std::string& chunk) {
+            parallel += chunk;
+        },
+        2);
+    REQUIRE_EXP(ret);
+
+    // datacenters are exported by id, so it is the same order as serial one
+    CHECK(parallel == *serial);
+}
+
+// ids (last column) of the parallel export rows
+static std::vector<std::string> exportParallelIds()
+{
+    std::string parallel;
+    auto        ret = fty::asset::AssetManager::exportCsvParallel(
+        [&](const std::string& chunk) {
+            parallel += chunk;
+        },
+        2);
+    REQUIRE_EXP(ret);
+
+    std::vector<std::string> ids;
+    for (const std::string& line : fty::split(parallel, "\n")) {
+        if (!line.empty()) {
+            ids.push_back(line.substr(line.rfind(',') + 1));
+        }
+    }
+    return ids;
+}
+
+static bool exportedBefore(const std::vector<std::string>& ids, const std::string& first, const std::string& second)
+{
+    auto f = std::find(ids.begin(), ids.end(), first);
+    auto s = std::find(ids.begin(), ids.end(), second);
+    REQUIRE(f != ids.end());
+    REQUIRE(s != ids.end());
+    return f < s;
+}
+
+TEST_CASE("Export asset / Parallel power between datacenters")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type     : Server
+                    name     : srv
+                    ext-name : Server
+            - type     : Datacenter
+              name     : datacenter1
+              ext-name : Data Center 1
+              items :
+                  - type     : Feed
+                    name     : feed
+                    ext-name : Feed
+                  - type     : Feed
+                    name     : feed1
+                    ext-name : Feed 1
+            - type     : Server
+              name     : srv2
+              ext-name : Server 2
+        links:
+            - dest : srv
+              src  : feed
+              type : power chain
+            - dest : srv2
+              src  : feed1
+              type : power chain
+    )");
+
+    // source in a datacenter with bigger id, destination outside of any datacenter
+    auto ids = exportParallelIds();
+    REQUIRE(ids.size() == 7);
+    CHECK(exportedBefore(ids, "feed", "srv"));
+    CHECK(exportedBefore(ids, "feed1", "srv2"));
+    CHECK(exportedBefore(ids, "datacenter1", "feed"));
+    CHECK(exportedBefore(ids, "datacenter", "srv"));
+}
+
+TEST_CASE("Export asset / Parallel datacenters powering each other")
+{
+    fty::SampleDb db(R"(
+        items:
+            - type     : Datacenter
+              name     : datacenter
+              ext-name : Data Center
+              items :
+                  - type     : Server
+                    name     : srv
+                    ext-name : Server
+                  - type     : Feed
+                    name     : feed
+                    ext-name : Feed
+            - type     : Datacenter
+              name     : datacenter1
+              ext-name : Data Center 1
+              items :
+                  - type     : Feed
+                    name     : feed1
+                    ext-name : Feed 1
+                  - type     : Server
+                    name     : srv1
+                    ext-name : Server 1
+        links:
+            - dest : srv
+              src  : feed1
+              type : power chain
+            - dest : srv1
+              src  : feed
+              type : power chain
+    )");
+
+    auto ids = exportParallelIds();
+    REQUIRE(ids.size() == 7);
+    CHECK(exportedBefore(ids, "feed1", "srv"));
+    CHECK(exportedBefore(ids, "feed", "srv1"));
+}
@@ -59,3 +59,115 @@ UPS-DUMMY,device,ups,dc,active,P3,,feed,,56,,127.0.0.1,,,,,,,,,6,,,,,,,,16,horiz
     }
     REQUIRE(ret);
 }
+
+TEST_CASE("Import asset / Dry run")
+{
+    fty::SampleDb db(R"(
+        items:
+          - type     : Datacenter
+            name     : datacenter
+            ext-name : dc
+            items:
+              - type     : Feed
+                name     : feed
+                ext-name : Feed
+              - type     : Server
+                name     : srv
+                ext-name : Server
+                attrs    :
+                    description : old
+              - type     : Server
+                name     : srv1
+                ext-name : Server 1
+    )");
+
+    // clang-format off
+    static std::string data = R"(name,type,sub_type,location,status,priority,asset_tag,power_source.1,power_plug_src.1,power_input.1,description,id
+Server,device,server,dc,active,P1,,Feed,,1,new,srv
+Server 1,device,server,dc,active,P1,,,,,,srv1
+Room1,room,,dc,active,P2,,,,,,)";
+    // clang-format on
+
+    auto ret = fty::asset::AssetManager::importCsvDryRun(data);
+    REQUIRE_EXP(ret);
+    REQUIRE(ret->size() == 3);
+
+    using Action = fty::asset::ImportDiff::Action;
+
+    auto& srv = ret->at(1);
+    REQUIRE_EXP(srv);
+    CHECK(srv->action == Action::Update);
+    CHECK(srv->fields.empty());
+    CHECK(srv->ext.at("description").before == "old");
+    CHECK(srv->ext.at("description").after == "new");
+    REQUIRE(srv->linksAdded.size() == 1);
+    CHECK(srv->linksAdded[0].source == "feed");
+    CHECK(srv->linksAdded[0].destIn == "1");
+
+    auto& srv1 = ret->at(2);
+    REQUIRE_EXP(srv1);
+    CHECK(srv1->action == Action::NoOp);
+
+    auto& room = ret->at(3);
+    REQUIRE_EXP(room);
+    CHECK(room->action == Action::Insert);
+    CHECK(room->fields.at("priority").after == "P2");
+
+    // nothing was written
+    CHECK(!fty::asset::db::extNameToAssetName("Room1"));
+}
+
+TEST_CASE("Import asset / Dry run validates as import")
+{
+    fty::SampleDb db(R"(
+        items:
+          - type     : Datacenter
+            name     : datacenter
+            ext-name : dc
+            items:
+              - type     : Rack
+                name     : rack
+                ext-name : Rack
+                attrs    :
+                    u_size : 10
+                items:
+                  - type     : Server
+                    name     : srv
+                    ext-name : Server
+    )");
+
+    // 1: negative max_power, 2: same asset again, 3: u_size out of range, 4: placed in rack,
+    // 5: place taken by row 4
+    // clang-format off
+    static std::string data = R"(name,type,sub_type,location,status,priority,max_power,u_size,location_u_pos,id
+Server,device,server,Rack,active,P1,-5,,,srv
+Server,device,server,Rack,active,P1,,,,srv
+Server 2,device,server,Rack,active,P1,,100,1,
+Server 3,device,server,Rack,active,P1,,2,9,
+Server 4,device,server,Rack,active,P1,,1,10,)";
+    // clang-format on
+
+    const std::vector<bool> expected = {false, true, false, true, false};
+
+    auto dry = fty::asset::AssetManager::importCsvDryRun(data);
+    REQUIRE_EXP(dry);
+    REQUIRE(dry->size() == expected.size());
+
+    auto ret = fty::asset::AssetManager::importCsv(data, "dummy", false);
+    REQUIRE_EXP(ret);
+    REQUIRE(ret->size() == expected.size());
+
+    for (size_t row = 1; row <= expected.size(); ++row) {
+        INFO("row " << row);
+        CHECK(bool(dry->at(row)) == expected[row - 1]);
+        CHECK(bool(ret->at(row)) == expected[row - 1]);
+    }
+
+    if (auto& inserted = ret->at(4)) {
+        auto el = fty::asset::db::selectAssetElementWebById(*inserted);
+        REQUIRE_EXP(el);
+        if (auto res = fty::asset::AssetManager::deleteAsset(*el, false); !res) {
+            FAIL(res.error());
+        }
+    }
+}
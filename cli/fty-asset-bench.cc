@@ -0,0 +1,526 @@
+/*  =========================================================================
+    fty_asset_bench - Load generation and benchmark for fty-asset
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty-asset-bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cxxtools/base64codec.h>
+#include <fty_asset_dto.h>
+#include <fty_common.h>
+#include <fty_common_messagebus.h>
+#include <malamute.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fty {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr const char* ASSET_AGENT       = "asset-agent";
+static constexpr const char* ASSET_AGENT_NG    = "asset-agent-ng";
+static constexpr const char* ASSET_AGENT_QUEUE = "FTY.Q.ASSET.QUERY";
+static constexpr int         RECV_TIMEOUT      = 5; // seconds
+
+// subjects of the mix, new interface (GET, LIST, CREATE, UPDATE) and mailbox (TOPOLOGY, ASSET_DETAIL)
+enum Subject
+{
+    GET,
+    LIST,
+    TOPOLOGY,
+    ASSET_DETAIL,
+    CREATE,
+    UPDATE,
+    SUBJECT_COUNT
+};
+
+static constexpr const char* SUBJECT_NAMES[SUBJECT_COUNT] = {
+    "GET", "LIST", "TOPOLOGY", "ASSET_DETAIL", "CREATE", "UPDATE"};
+
+struct BenchOptions
+{
+    unsigned    weights[SUBJECT_COUNT] = {40, 10, 10, 20, 10, 10};
+    unsigned    concurrency            = 4;
+    double      rate                   = 0; // requests per second in total, 0 = closed loop
+    unsigned    duration               = 10;
+    std::string asset;
+    std::string encoding = ENCODING_JSON;
+    bool        keep     = false;
+};
+
+struct Samples
+{
+    std::vector<double> latencies; // ms
+    size_t              errors = 0;
+};
+
+using Results = std::vector<Samples>; // indexed by Subject
+
+static void s_usage()
+{
+    puts("fty-asset-cli bench [options]");
+    puts("  --mix SUBJECT=WEIGHT,...  request mix, subjects GET LIST TOPOLOGY ASSET_DETAIL CREATE UPDATE");
+    puts("                            (default GET=40,LIST=10,TOPOLOGY=10,ASSET_DETAIL=20,CREATE=10,UPDATE=10)");
+    puts("  --concurrency N           number of clients (default 4)");
+    puts("  --rate N                  target requests per second in total (default: as fast as possible)");
+    puts("  --duration S              run time in seconds (default 10)");
+    puts("  --asset INAME             asset for GET, TOPOLOGY and ASSET_DETAIL (default: first listed)");
+    puts("  --encoding json|protobuf  encoding of the new interface requests (default json)");
+    puts("  --keep                    do not delete the assets created by CREATE");
+}
+
+static bool s_parseMix(const std::string& mix, unsigned (&weights)[SUBJECT_COUNT])
+{
+    std::fill(std::begin(weights), std::end(weights), 0);
+
+    size_t pos = 0;
+    while (pos < mix.size()) {
+        size_t end = mix.find(',', pos);
+        if (end == std::string::npos) {
+            end = mix.size();
+        }
+        const std::string item = mix.substr(pos, end - pos);
+        pos                    = end + 1;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        auto found = std::find_if(std::begin(SUBJECT_NAMES), std::end(SUBJECT_NAMES), [&](const char* name) {
+            return item.compare(0, eq, name) == 0 && strlen(name) == eq;
+        });
+        if (found == std::end(SUBJECT_NAMES)) {
+            return false;
+        }
+        weights[found - std::begin(SUBJECT_NAMES)] = unsigned(atoi(item.c_str() + eq + 1));
+    }
+    return std::any_of(std::begin(weights), std::end(weights), [](unsigned w) {
+        return w > 0;
+    });
+}
+
+static bool s_parseOptions(int argn, int argc, char** argv, BenchOptions& opts)
+{
+    for (int i = argn + 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (streq(argv[i], "--keep")) {
+            opts.keep = true;
+        } else if (streq(argv[i], "--mix") && hasValue) {
+            if (!s_parseMix(argv[++i], opts.weights)) {
+                return false;
+            }
+        } else if (streq(argv[i], "--concurrency") && hasValue) {
+            opts.concurrency = unsigned(atoi(argv[++i]));
+        } else if (streq(argv[i], "--rate") && hasValue) {
+            opts.rate = atof(argv[++i]);
+        } else if (streq(argv[i], "--duration") && hasValue) {
+            opts.duration = unsigned(atoi(argv[++i]));
+        } else if (streq(argv[i], "--asset") && hasValue) {
+            opts.asset = argv[++i];
+        } else if (streq(argv[i], "--encoding") && hasValue) {
+            opts.encoding = argv[++i];
+            if (opts.encoding != ENCODING_JSON && opts.encoding != ENCODING_PROTOBUF) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return opts.concurrency > 0 && opts.duration > 0 && opts.rate >= 0;
+}
+
+/// One benchmark client, with its own mailbox and message bus connections (neither is thread safe)
+class BenchClient
+{
+public:
+    BenchClient(const char* endpoint, const std::string& name, const BenchOptions& opts)
+        : m_name(name)
+        , m_opts(opts)
+    {
+        m_mailbox = mlm_client_new();
+        if (mlm_client_connect(m_mailbox, endpoint, 1000, m_name.c_str()) == -1) {
+            mlm_client_destroy(&m_mailbox);
+            throw std::runtime_error("cannot connect to malamute on " + std::string(endpoint));
+        }
+        m_poller = zpoller_new(mlm_client_msgpipe(m_mailbox), NULL);
+
+        m_bus.reset(messagebus::MlmMessageBus(endpoint, m_name + "-ng"));
+        m_bus->connect();
+    }
+
+    ~BenchClient()
+    {
+        zpoller_destroy(&m_poller);
+        mlm_client_destroy(&m_mailbox);
+    }
+
+    BenchClient(const BenchClient&) = delete;
+    BenchClient& operator=(const BenchClient&) = delete;
+
+    /// sends one request and waits for its reply, returns false on error or timeout
+    bool request(Subject subject)
+    {
+        try {
+            switch (subject) {
+                case GET:
+                    return send(SUBJECT_NAMES[GET], m_opts.asset).metaData().at(messagebus::Message::STATUS) ==
+                           messagebus::STATUS_OK;
+                case LIST:
+                    return send(SUBJECT_NAMES[LIST], "").metaData().at(messagebus::Message::STATUS) ==
+                           messagebus::STATUS_OK;
+                case TOPOLOGY:
+                    return topology();
+                case ASSET_DETAIL:
+                    return assetDetail();
+                case CREATE:
+                    return create();
+                case UPDATE:
+                    return update();
+                default:
+                    return false;
+            }
+        } catch (const std::exception& e) {
+            log_debug("%s: %s failed: %s", m_name.c_str(), SUBJECT_NAMES[subject], e.what());
+            return false;
+        }
+    }
+
+    /// first asset of the inventory
+    std::string firstAsset()
+    {
+        messagebus::Message reply = send(SUBJECT_NAMES[LIST], "");
+        if (reply.metaData().at(messagebus::Message::STATUS) != messagebus::STATUS_OK || reply.userData().empty()) {
+            return {};
+        }
+
+        cxxtools::SerializationInfo si;
+        JSON::readFromString(reply.userData().front(), si);
+        std::vector<std::string> inames;
+        si >>= inames;
+        return inames.empty() ? std::string() : inames.front();
+    }
+
+    /// deletes the assets created by CREATE
+    void cleanup()
+    {
+        if (m_created.empty()) {
+            return;
+        }
+
+        std::vector<std::string> inames;
+        for (const auto& asset : m_created) {
+            inames.push_back(asset.getInternalName());
+        }
+        cxxtools::SerializationInfo si;
+        si <<= inames;
+
+        try {
+            m_bus->request(ASSET_AGENT_QUEUE, message("DELETE", JSON::writeToString(si, false)), RECV_TIMEOUT);
+        } catch (const std::exception& e) {
+            log_error("%s: cleanup of %zu assets failed: %s", m_name.c_str(), inames.size(), e.what());
+        }
+        m_created.clear();
+    }
+
+private:
+    messagebus::Message message(const std::string& subject, const std::string& data)
+    {
+        messagebus::Message msg;
+        msg.metaData().emplace(messagebus::Message::CORRELATION_ID, messagebus::generateUuid());
+        msg.metaData().emplace(messagebus::Message::SUBJECT, subject);
+        msg.metaData().emplace(messagebus::Message::FROM, m_name + "-ng");
+        msg.metaData().emplace(messagebus::Message::TO, ASSET_AGENT_NG);
+        msg.metaData().emplace(messagebus::Message::REPLY_TO, m_name + "-ng");
+        msg.metaData().emplace(METADATA_ENCODING, m_opts.encoding);
+        if (!data.empty()) {
+            msg.userData().push_back(data);
+        }
+        return msg;
+    }
+
+    messagebus::Message send(const std::string& subject, const std::string& data)
+    {
+        return m_bus->request(ASSET_AGENT_QUEUE, message(subject, data), RECV_TIMEOUT);
+    }
+
+    std::string encode(const Asset& asset) const
+    {
+        if (m_opts.encoding == ENCODING_PROTOBUF) {
+            return cxxtools::encode<cxxtools::Base64Codec>(Asset::toBinary(asset));
+        }
+        return Asset::toJson(asset);
+    }
+
+    void decode(const std::string& data, Asset& asset) const
+    {
+        if (m_opts.encoding == ENCODING_PROTOBUF) {
+            Asset::fromBinary(cxxtools::decode<cxxtools::Base64Codec>(data), asset);
+        } else {
+            Asset::fromJson(data, asset);
+        }
+    }
+
+    bool create()
+    {
+        Asset asset;
+        asset.setAssetType(TYPE_GROUP);
+        asset.setAssetStatus(AssetStatus::Nonactive);
+        asset.setFriendlyName("bench-" + m_name + "-" + std::to_string(++m_sequence));
+
+        messagebus::Message reply = send(SUBJECT_NAMES[CREATE], encode(asset));
+        if (reply.metaData().at(messagebus::Message::STATUS) != messagebus::STATUS_OK || reply.userData().empty()) {
+            return false;
+        }
+
+        Asset created;
+        decode(reply.userData().front(), created);
+        m_created.push_back(created);
+        return true;
+    }
+
+    bool update()
+    {
+        // updates one of our own assets, never the inventory under test
+        if (m_created.empty() && !create()) {
+            return false;
+        }
+
+        Asset& asset = m_created[m_sequence % m_created.size()];
+        asset.setExtEntry("description", "bench update " + std::to_string(++m_sequence));
+
+        messagebus::Message reply = send(SUBJECT_NAMES[UPDATE], encode(asset));
+        return reply.metaData().at(messagebus::Message::STATUS) == messagebus::STATUS_OK;
+    }
+
+    /// waits for the mailbox reply with given subject, replies of timed out requests are dropped
+    zmsg_t* receive(const char* subject)
+    {
+        auto deadline = Clock::now() + std::chrono::seconds(RECV_TIMEOUT);
+        while (true) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            if (left <= 0 || !zpoller_wait(m_poller, int(left))) {
+                return nullptr;
+            }
+            zmsg_t* reply = mlm_client_recv(m_mailbox);
+            if (reply && streq(mlm_client_subject(m_mailbox), subject)) {
+                return reply;
+            }
+            zmsg_destroy(&reply);
+        }
+    }
+
+    bool topology()
+    {
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "TOPOLOGY_POWER");
+        zmsg_addstr(msg, m_opts.asset.c_str());
+        if (mlm_client_sendto(m_mailbox, ASSET_AGENT, "TOPOLOGY", NULL, 1000, &msg) != 0) {
+            zmsg_destroy(&msg);
+            return false;
+        }
+
+        // TOPOLOGY_POWER/<asset>/OK|ERROR/...
+        zmsg_t* reply = receive("TOPOLOGY");
+        if (!reply) {
+            return false;
+        }
+        zframe_t* status = zmsg_first(reply);
+        status           = status ? zmsg_next(reply) : NULL;
+        status           = status ? zmsg_next(reply) : NULL;
+        bool ok          = status && zframe_streq(status, "OK");
+        zmsg_destroy(&reply);
+        return ok;
+    }
+
+    bool assetDetail()
+    {
+        const std::string uuid = messagebus::generateUuid();
+
+        zmsg_t* msg = zmsg_new();
+        zmsg_addstr(msg, "GET");
+        zmsg_addstr(msg, uuid.c_str());
+        zmsg_addstr(msg, m_opts.asset.c_str());
+        if (mlm_client_sendto(m_mailbox, ASSET_AGENT, "ASSET_DETAIL", NULL, 1000, &msg) != 0) {
+            zmsg_destroy(&msg);
+            return false;
+        }
+
+        // <uuid>/fty_proto asset or <uuid>/ERROR/<reason>
+        while (zmsg_t* reply = receive("ASSET_DETAIL")) {
+            char*     replyUuid = zmsg_popstr(reply);
+            bool      matches   = replyUuid && uuid == replyUuid;
+            zframe_t* next      = zmsg_first(reply);
+            bool      ok        = next && !zframe_streq(next, "ERROR");
+            zstr_free(&replyUuid);
+            zmsg_destroy(&reply);
+            if (matches) {
+                return ok;
+            }
+        }
+        return false;
+    }
+
+    std::string         m_name;
+    const BenchOptions& m_opts;
+    mlm_client_t*       m_mailbox = nullptr;
+    zpoller_t*          m_poller  = nullptr;
+
+    std::unique_ptr<messagebus::MessageBus> m_bus;
+
+    std::vector<Asset> m_created;
+    unsigned           m_sequence = 0;
+};
+
+/// Sends requests until the deadline, latencies in ms
+///
+/// With a target rate the client is open loop: request k is due at start + k * interval and its latency is
+/// counted from that time, so a slow agent shows up as latency instead of silently lowering the send rate.
+static void s_run(BenchClient& client, const BenchOptions& opts, unsigned seed, Clock::time_point start,
+    Clock::time_point deadline, Results& results)
+{
+    std::mt19937                 random(seed);
+    std::discrete_distribution<> pick(std::begin(opts.weights), std::end(opts.weights));
+
+    const bool paced    = opts.rate > 0;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(paced ? opts.concurrency / opts.rate : 0));
+
+    for (uint64_t k = 0;; k++) {
+        Clock::time_point sent = paced ? start + interval * int64_t(k) : Clock::now();
+        if (sent >= deadline) {
+            break;
+        }
+        if (paced) {
+            std::this_thread::sleep_until(sent);
+        }
+
+        Subject subject = Subject(pick(random));
+        bool    ok      = client.request(subject);
+
+        Samples& samples = results[subject];
+        samples.latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - sent).count());
+        if (!ok) {
+            samples.errors++;
+        }
+    }
+}
+
+static double s_percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = size_t(std::ceil(p * double(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static void s_printRow(const char* name, std::vector<double>& latencies, size_t errors, double seconds)
+{
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-14s %8zu %7zu %9.1f %9.2f %9.2f %9.2f %9.2f\n", name, latencies.size(), errors,
+        double(latencies.size()) / seconds, s_percentile(latencies, 0.50), s_percentile(latencies, 0.95),
+        s_percentile(latencies, 0.99), latencies.empty() ? 0. : latencies.back());
+}
+
+int benchmark(const char* endpoint, int argn, int argc, char** argv)
+{
+    BenchOptions opts;
+    if (!s_parseOptions(argn, argc, argv, opts)) {
+        s_usage();
+        return -1;
+    }
+
+    std::vector<std::unique_ptr<BenchClient>> clients;
+    try {
+        for (unsigned i = 0; i < opts.concurrency; i++) {
+            clients.emplace_back(new BenchClient(
+                endpoint, "fty-asset-bench-" + std::to_string(getpid()) + "-" + std::to_string(i), opts));
+        }
+        if (opts.asset.empty()) {
+            opts.asset = clients.front()->firstAsset();
+        }
+    } catch (const std::exception& e) {
+        printf("bench: %s\n", e.what());
+        return -1;
+    }
+    if (opts.asset.empty()) {
+        puts("bench: no asset in inventory, use --asset");
+        return -1;
+    }
+
+    printf("bench: %u clients, %s, %u s, asset %s\n", opts.concurrency,
+        opts.rate > 0 ? (std::to_string(opts.rate) + " req/s").c_str() : "closed loop", opts.duration,
+        opts.asset.c_str());
+
+    std::vector<Results>     results(opts.concurrency, Results(SUBJECT_COUNT));
+    std::vector<std::thread> threads;
+
+    const Clock::time_point start    = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::seconds(opts.duration);
+    for (unsigned i = 0; i < opts.concurrency; i++) {
+        threads.emplace_back(s_run, std::ref(*clients[i]), std::cref(opts), i + 1, start, deadline,
+            std::ref(results[i]));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    printf("%-14s %8s %7s %9s %9s %9s %9s %9s\n", "subject", "count", "errors", "req/s", "p50 ms", "p95 ms",
+        "p99 ms", "max ms");
+
+    std::vector<double> all;
+    size_t              allErrors = 0;
+    for (int subject = 0; subject < SUBJECT_COUNT; subject++) {
+        std::vector<double> latencies;
+        size_t              errors = 0;
+        for (auto& result : results) {
+            Samples& samples = result[size_t(subject)];
+            latencies.insert(latencies.end(), samples.latencies.begin(), samples.latencies.end());
+            errors += samples.errors;
+        }
+        if (latencies.empty()) {
+            continue;
+        }
+        all.insert(all.end(), latencies.begin(), latencies.end());
+        allErrors += errors;
+        s_printRow(SUBJECT_NAMES[subject], latencies, errors, seconds);
+    }
+    s_printRow("total", all, allErrors, seconds);
+
+    if (!opts.keep) {
+        for (auto& client : clients) {
+            client->cleanup();
+        }
+    }
+
+    return allErrors == 0 ? 0 : -1;
+}
+
+} // namespace fty
@@ -0,0 +1,33 @@
+/*  =========================================================================
+    fty_asset_bench - Load generation and benchmark for fty-asset
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+namespace fty {
+
+/// Runs the "bench" subcommand: sends a weighted mix of requests to the asset agent and prints throughput and
+/// latency percentiles per subject. argv [argn] is "bench", returns 0 if all requests succeeded.
+///
+/// Meant for a local malamute and a test database: CREATE and UPDATE write assets (groups named
+/// "bench-..."), which are deleted at the end unless --keep is given.
+int benchmark(const char* endpoint, int argn, int argc, char** argv);
+
+} // namespace fty
@@ -27,6 +27,10 @@
 @end
 */
 
+#include "fty-asset-bench.h"
+#include <cassert>
+#include <fty_log.h>
+#include <malamute.h>
 #include <time.h>
 
 const char *endpoint = "ipc://@/malamute";
@@ -46,6 +50,42 @@ s_republish (mlm_client_t *client, int argn, int argc, char** argv)
     mlm_client_sendto (client, "asset-agent", "REPUBLISH", NULL, 1000, &msg);
 }
 
+static int
+s_snapshot (mlm_client_t *client, int argn, int argc, char** argv)
+{
+    if (argc != argn + 3
+    ||  !(streq (argv [argn + 1], "save") || streq (argv [argn + 1], "load"))) {
+        puts ("fty-asset-cli snapshot save|load <name>  (file of /var/lib/fty/fty-asset/snapshots)");
+        return -1;
+    }
+
+    zmsg_t *msg = zmsg_new ();
+    zmsg_addstr (msg, streq (argv [argn + 1], "save") ? "SAVE" : "LOAD");
+    zmsg_addstr (msg, argv [argn + 2]);
+    mlm_client_sendto (client, "asset-agent", "SNAPSHOT", NULL, 1000, &msg);
+
+    // restore of a large inventory may take a while
+    poller = zpoller_new (mlm_client_msgpipe (client), NULL);
+    zmsg_t *reply = NULL;
+    if (zpoller_wait (poller, 10 * 60 * 1000))
+        reply = mlm_client_recv (client);
+    zpoller_destroy (&poller);
+
+    if (!reply) {
+        puts ("snapshot: no reply from asset-agent");
+        return -1;
+    }
+
+    char *status = zmsg_popstr (reply);
+    char *detail = zmsg_popstr (reply);
+    int rv = (status && streq (status, "OK")) ? 0 : -1;
+    printf ("snapshot %s: %s %s\n", argv [argn + 1], status ? status : "", detail ? detail : "");
+    zstr_free (&detail);
+    zstr_free (&status);
+    zmsg_destroy (&reply);
+    return rv;
+}
+
 
 int main (int argc, char *argv [])
 {
@@ -59,12 +99,15 @@ int main (int argc, char *argv [])
         return -1;
     }
 
+    int ret = 0;
     for (int argn = 1; argn < argc; argn++) {
         if (    streq (argv [argn], "--help")
              || streq (argv [argn], "-h"))
         {
             puts ("fty-asset-cli [options]");
             puts ("fty-asset-cli republish");
+            puts ("fty-asset-cli snapshot save|load <name>");
+            puts ("fty-asset-cli bench [--help]");
             break;
         }
         else
@@ -74,6 +117,18 @@ int main (int argc, char *argv [])
             s_republish (client, argn, argc, argv);
             break;
         }
+        else
+        if (streq (argv [argn], "snapshot"))
+        {
+            ret = s_snapshot (client, argn, argc, argv);
+            break;
+        }
+        else
+        if (streq (argv [argn], "bench"))
+        {
+            ret = fty::benchmark (endpoint, argn, argc, argv);
+            break;
+        }
     }
 
 
@@ -81,5 +136,5 @@ int main (int argc, char *argv [])
 
     zclock_sleep (200);
     mlm_client_destroy (&client);
-    return 0;
+    return ret;
 }
@@ -0,0 +1,72 @@
+/*  =========================================================================
+    asset_conversion_binary - asset/conversion/binary
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+// fwd declaration
+namespace fty {
+class Asset;
+} // namespace fty
+
+// Protobuf (proto3) wire format of assets, same content as the JSON representation:
+//
+// message ExtAttribute {
+//     string key       = 1;
+//     string value     = 2;
+//     bool   read_only = 3;
+//     bool   update    = 4;
+// }
+//
+// message AssetLink {
+//     string                source       = 1;
+//     int32                 link_type    = 2;
+//     string                src_out      = 3;
+//     string                dest_in      = 4;
+//     repeated ExtAttribute ext          = 5;
+//     string                secondary_id = 6;
+// }
+//
+// message Asset {
+//     int32                 status           = 1;
+//     string                type             = 2;
+//     string                sub_type         = 3;
+//     string                name             = 4;
+//     int32                 priority         = 5;
+//     string                parent           = 6;
+//     repeated AssetLink    linked           = 7;
+//     repeated ExtAttribute ext              = 8;
+//     string                secondary_id     = 9;
+//     repeated Asset        parents_list     = 10;
+//     bool                  has_parents_list = 11;
+// }
+//
+// message AssetList {
+//     repeated Asset assets = 1;
+// }
+
+namespace fty { namespace conversion {
+    std::string toBinary(const Asset& asset);
+    std::string toBinary(const std::vector<Asset>& list);
+    void        fromBinary(const std::string& data, fty::Asset& asset);
+    void        fromBinary(const std::string& data, std::vector<fty::Asset>& list);
+}} // namespace fty::conversion
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 // fwd declaration
 struct fty_proto_t;
@@ -31,5 +32,7 @@ class Asset;
 
 namespace fty { namespace conversion {
     fty_proto_t* toFtyProto(const fty::Asset& asset, const std::string& operation, bool test = false);
+    std::vector<fty_proto_t*> toFtyProto(
+        const std::vector<fty::Asset>& assets, const std::string& operation, bool test = false);
     void fromFtyProto(fty_proto_t* proto, fty::Asset& asset, bool extAttributeReadOnly, bool test = false);
 }} // namespace fty::conversion
@@ -0,0 +1,74 @@
+/*  =========================================================================
+    fty_asset_delta - Changed fields between two versions of an asset
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "fty_asset_dto.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fty {
+
+/// Fields of an asset which differ between two versions of it
+///
+/// Payload of compact update notifications: only the changed fields are set. Ext attributes are compared
+/// by value and read only flag; links are sent as a whole list when any of them changed.
+class AssetDelta
+{
+public:
+    /// internal name of the asset
+    std::string name;
+    /// version of the asset after the change, increasing for each change of the asset
+    uint64_t version = 0;
+
+    std::optional<AssetStatus>            status;
+    std::optional<std::string>            type;
+    std::optional<std::string>            subType;
+    std::optional<int>                    priority;
+    std::optional<std::string>            parent;
+    std::optional<std::string>            secondaryID;
+    std::optional<std::vector<AssetLink>> linked;
+
+    /// new or modified ext attributes
+    Asset::ExtMap ext;
+    /// removed ext attributes
+    std::vector<std::string> extRemoved;
+
+    /// delta which turns `before` into `after`
+    static AssetDelta diff(const Asset& before, const Asset& after, uint64_t version = 0);
+
+    /// true if there is no change
+    bool empty() const;
+
+    /// apply the changes on the previous version of the asset
+    void apply(Asset& asset) const;
+
+    // serialization / deserialization for cxxtools
+    void serialize(cxxtools::SerializationInfo& si) const;
+    void deserialize(const cxxtools::SerializationInfo& si);
+};
+
+void operator<<=(cxxtools::SerializationInfo& si, const AssetDelta& delta);
+void operator>>=(const cxxtools::SerializationInfo& si, AssetDelta& delta);
+
+} // namespace fty
@@ -21,18 +21,31 @@
 
 #pragma once
 
+#include "fty_asset_symbol.h"
 #include "fty_common_asset.h"
 
+#include <atomic>
 #include <cxxtools/serializationinfo.h>
 #include <fty_common_asset_types.h>
+#include <functional>
 #include <map>
+#include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 // fwd declaration
 struct fty_proto_t;
 
 namespace fty {
+// message payload encoding of -ng requests, replies carry the encoding actually used (JSON if not set)
+// protobuf payloads (Asset::toBinary) are base64 encoded on the bus: message frames are C strings
+static constexpr const char* METADATA_ENCODING = "ENCODING";
+static constexpr const char* ENCODING_JSON     = "json";
+static constexpr const char* ENCODING_PROTOBUF = "protobuf";
+
 // extended properties
 static constexpr const char* EXT_UUID         = "uuid";
 static constexpr const char* EXT_CREATE_TS    = "create_ts";
@@ -100,11 +113,11 @@ public:
     // constrcutors / destructors
     ExtMapElement(const std::string& val = "", bool readOnly = false, bool forceToFalse = false);
     ExtMapElement(const ExtMapElement& element);
-    ExtMapElement(ExtMapElement&& element);
+    ExtMapElement(ExtMapElement&& element) noexcept;
     ~ExtMapElement() = default;
 
     ExtMapElement& operator=(const ExtMapElement& element);
-    ExtMapElement& operator=(ExtMapElement&& element);
+    ExtMapElement& operator=(ExtMapElement&& element) noexcept;
 
     // getters
     const std::string& getValue() const;
@@ -114,6 +127,8 @@ public:
     // setters
     void setValue(const std::string& val);
     void setReadOnly(bool readOnly);
+    // updated flag is maintained by the setters, this restores a decoded one
+    void setUpdated(bool updated);
 
     // overload equality and inequality check
     bool operator==(const ExtMapElement& element) const;
@@ -185,17 +200,26 @@ class Asset
 public:
     using ExtMap = std::map<std::string, ExtMapElement>;
 
-    virtual ~Asset() = default;
+    Asset()             = default;
+    Asset(const Asset&) = default;
+    Asset(Asset&&)      = default;
+    virtual ~Asset()    = default;
+
+    Asset& operator=(const Asset&) = default;
+    Asset& operator=(Asset&&) = default;
 
     // getters
     const std::string&   getInternalName() const;
     AssetStatus          getAssetStatus() const;
     const std::string&   getAssetType() const;
     const std::string&   getAssetSubtype() const;
+    const Symbol&        getAssetTypeSymbol() const;
+    const Symbol&        getAssetSubtypeSymbol() const;
     const std::string&   getParentIname() const;
     int                  getPriority() const;
     const std::string&   getAssetTag() const;
-    const Asset::ExtMap& getExt() const;
+    // copy of the ext attributes, prefer forEachExt() or getExtEntry() which do not build it
+    Asset::ExtMap        getExt() const;
     const std::string&   getSecondaryID() const;
 
     // ext param getters (return empty string if key not found)
@@ -212,26 +236,38 @@ public:
     const std::string&              getFriendlyName() const; 
     std::vector<std::string>        getAddresses() const;
 
+    // iterates over ext attributes in key order, without copying them
+    void forEachExt(const std::function<void(const std::string& key, const ExtMapElement& element)>& fn) const;
 
-    // setters
+
+    // setters, rvalue overloads take over the value
     void setInternalName(const std::string& internalName);
+    void setInternalName(std::string&& internalName);
     void setAssetStatus(AssetStatus assetStatus);
     void setAssetType(const std::string& assetType);
     void setAssetSubtype(const std::string& assetSubtype);
     void setParentIname(const std::string& parentIname);
+    void setParentIname(std::string&& parentIname);
     void setPriority(int priority);
     void setAssetTag(const std::string& assetTag);
+    void setAssetTag(std::string&& assetTag);
     void setExtMap(const ExtMap& map);
     void clearExtMap();
     void setExtEntry(const std::string& key, const std::string& value, bool readOnly = false,
         bool forceUpdatedFalse = false);
+    // stores the element as is (value, read only and updated flags)
+    void setExtElement(const std::string& key, ExtMapElement&& element);
     void addLink(const std::string& sourceId, const std::string& scrOut, const std::string& destIn,
         int linkType, const AssetLink::ExtMap& attributes);
     void removeLink(
         const std::string& sourceId, const std::string& scrOut, const std::string& destIn, int linkType);
     void setLinkedAssets(const std::vector<AssetLink>& assets);
+    void setLinkedAssets(std::vector<AssetLink>&& assets);
     void setSecondaryID(const std::string& secondaryID);
+    void setSecondaryID(std::string&& secondaryID);
     void setFriendlyName(const std::string& friendlyName);
+    void setParentsList(const std::vector<Asset>& parents);
+    void setParentsList(std::vector<Asset>&& parents);
 
     //Wrapper for addresses => max 256
     using AddressMap = std::map<uint8_t, std::string>;
@@ -273,25 +309,37 @@ public:
     bool operator==(const Asset& asset) const;
     bool operator!=(const Asset& asset) const;
 
+    /// 64-bit hash of the fields compared by operator==: equal assets have the same fingerprint
+    /// computed on first use, then kept up to date by the setters
+    uint64_t fingerprint() const;
+
     // serialization / deserialization for cxxtools
     void serialize(cxxtools::SerializationInfo& si) const;
     void deserialize(const cxxtools::SerializationInfo& si);
 
     // conversion from/to different DTO representations
     static void fromJson(const std::string& json, Asset& a);
+    static void fromBinary(const std::string& data, Asset& a);
+    static void fromBinary(const std::string& data, std::vector<Asset>& list);
     static void fromFtyProto(fty_proto_t* p, Asset& a, bool extAttributeReadOnly, bool test = false);
 
     static FullAsset toFullAsset(const Asset& a);
     static std::string toJson(const Asset& a);
+    // protobuf wire format, see conversion/binary.h for the schema
+    static std::string toBinary(const Asset& a);
+    static std::string toBinary(const std::vector<Asset>& list);
     static fty_proto_t* toFtyProto(const Asset& a, const std::string& op, bool test = false);
+    // parents of all the assets are resolved at once, caller owns the messages
+    static std::vector<fty_proto_t*> toFtyProto(
+        const std::vector<Asset>& assets, const std::string& op, bool test = false);
 
 protected:
     // internal name = <subtype>-<id>)
     std::string m_internalName;
 
     AssetStatus m_assetStatus  = AssetStatus::Unknown;
-    std::string m_assetType    = TYPE_UNKNOWN;
-    std::string m_assetSubtype = SUB_UNKNOWN;
+    Symbol      m_assetType    = TYPE_UNKNOWN;
+    Symbol      m_assetSubtype = SUB_UNKNOWN;
 
     // direct parent iname
     std::string m_parentIname;
@@ -300,9 +348,7 @@ protected:
     // asset tag
     std::string m_assetTag;
     // secondary ID
-    std::string m_secondaryID;
-    // ext map storage (asset-specific values with readonly attribute)
-    ExtMap                 m_ext;
+    std::string            m_secondaryID;
     std::vector<AssetLink> m_linkedAssets;
 
     std::optional<std::vector<Asset>> m_parentsList;
@@ -310,6 +356,81 @@ protected:
     const std::string&  getEndpointData(uint8_t index, const std::string &field) const;
     void  setEndpointData(uint8_t index, const std::string &field, const std::string & val);
 
+private:
+    // ext attribute key, interned (a few distinct names repeated on every asset) while the symbol table has
+    // room, see Symbol::tryIntern(); owned otherwise, shared by the copies of the asset
+    class ExtKey
+    {
+    public:
+        ExtKey(const std::string& key);
+
+        const std::string& str() const
+        {
+            return m_owned ? *m_owned : m_symbol.str();
+        }
+
+        operator const std::string&() const
+        {
+            return str();
+        }
+
+        bool operator==(const ExtKey& other) const
+        {
+            return str() == other.str();
+        }
+
+    private:
+        Symbol                             m_symbol;
+        std::shared_ptr<const std::string> m_owned;
+    };
+
+    // ext attributes (asset-specific values with readonly attribute), sorted by key
+    using ExtEntry = std::pair<ExtKey, ExtMapElement>;
+    std::vector<ExtEntry> m_ext;
+
+    // endpoint and address attributes by index, built on first use and reset on every ext map change
+    // it refers to positions in m_ext, so it stays valid in copies of the asset
+    struct ExtIndex;
+    mutable std::shared_ptr<const ExtIndex> m_extIndex;
+
+    const ExtIndex& extIndex() const;
+    const std::string& extValueAt(int32_t pos) const;
+
+    // cached fingerprint, xor of the hashes of the fields so that a setter swaps the hash of its field
+    struct Fingerprint
+    {
+        std::atomic<uint64_t> value{0};
+        std::atomic<bool>     valid{false};
+
+        Fingerprint() = default;
+        Fingerprint(const Fingerprint& other) noexcept
+        {
+            *this = other;
+        }
+        Fingerprint& operator=(const Fingerprint& other) noexcept
+        {
+            bool otherValid = other.valid.load(std::memory_order_acquire);
+            value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            valid.store(otherValid, std::memory_order_release);
+            return *this;
+        }
+        // fields of a moved-from asset are left unspecified, its fingerprint must be recomputed
+        Fingerprint(Fingerprint&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+        Fingerprint& operator=(Fingerprint&& other) noexcept
+        {
+            *this = static_cast<const Fingerprint&>(other);
+            other.valid.store(false, std::memory_order_relaxed);
+            return *this;
+        }
+    };
+    mutable Fingerprint m_fingerprint;
+
+    void changeFingerprint(uint64_t removed, uint64_t added);
+    void invalidateFingerprint();
+
 };
 
 void operator<<=(cxxtools::SerializationInfo& si, const fty::Asset& asset);
@@ -0,0 +1,86 @@
+/*  =========================================================================
+    fty_asset_id_resolver - Cached resolution of asset internal names to ids
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+/// Resolution of asset internal names to database ids, with a bounded LRU cache
+///
+/// Used by Asset::toFtyProto() for the parent id, where the same few parents are resolved for every asset.
+/// Only existing assets are cached. An id changes only if the asset is deleted and created again with the
+/// same name, so processes which keep converting assets should invalidate() names on asset deletion.
+class AssetIdResolver
+{
+public:
+    /// returns the ids of the names found, names not found are missing from the result
+    using Lookup = std::function<std::map<std::string, int64_t>(const std::vector<std::string>& inames)>;
+
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    struct Stats
+    {
+        uint64_t hits    = 0;
+        uint64_t misses  = 0;
+        uint64_t lookups = 0;
+    };
+
+    /// process-wide resolver, looks up the asset database
+    static AssetIdResolver& instance();
+
+    explicit AssetIdResolver(Lookup lookup, size_t capacity = DEFAULT_CAPACITY);
+
+    /// id of the asset, -1 if it does not exist
+    int64_t resolve(const std::string& iname);
+
+    /// ids of the assets found, all the names not in cache are looked up at once
+    std::map<std::string, int64_t> resolve(const std::vector<std::string>& inames);
+
+    void invalidate(const std::string& iname);
+    void clear();
+
+    size_t size() const;
+    Stats  stats() const;
+
+private:
+    using Entries = std::list<std::pair<std::string, int64_t>>;
+
+    bool find(const std::string& iname, int64_t& id);
+    void store(const std::string& iname, int64_t id);
+
+    Lookup                                             m_lookup;
+    size_t                                             m_capacity;
+    mutable std::mutex                                 m_mutex;
+    Entries                                            m_entries; // most recently used first
+    std::unordered_map<std::string, Entries::iterator> m_index;
+    Stats                                              m_stats;
+};
+
+} // namespace fty
@@ -0,0 +1,165 @@
+/*  =========================================================================
+    fty_asset_symbol - Process-wide interned strings
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace fty {
+
+/// Interned string from a process-wide symbol table
+///
+/// Asset types, subtypes and ext attribute keys come from a small set of values repeated on every asset.
+/// Each distinct value is stored once; a Symbol is a pointer to it, so copies are cheap and two symbols are
+/// equal if they are the same pointer. Symbols are never released and have a stable id for the process
+/// lifetime (the empty string is id 0).
+/// The table only grows: every distinct string ever interned stays allocated until the process exits, so
+/// the constructors are only for values from a bounded set (types, subtypes). Values which may come from
+/// anywhere (ext attribute keys) go through tryIntern(), which stops adding symbols at TRY_INTERN_LIMIT.
+/// Lookups go through a per thread cache, the table lock is only taken the first time a thread sees a value.
+class Symbol
+{
+public:
+    Symbol();
+    Symbol(const std::string& str);
+    Symbol(const char* str);
+
+    const std::string& str() const
+    {
+        return m_entry->str;
+    }
+
+    operator const std::string&() const
+    {
+        return m_entry->str;
+    }
+
+    const char* c_str() const
+    {
+        return m_entry->str.c_str();
+    }
+
+    size_t size() const
+    {
+        return m_entry->str.size();
+    }
+
+    bool empty() const
+    {
+        return m_entry->str.empty();
+    }
+
+    uint32_t id() const
+    {
+        return m_entry->id;
+    }
+
+    /// number of distinct symbols
+    static size_t count();
+
+    /// symbols tryIntern() adds at most, later values are only found if they already are symbols
+    static constexpr size_t TRY_INTERN_LIMIT = 4096;
+
+    /// interned str, or nullopt if it is not a symbol yet and the table already holds TRY_INTERN_LIMIT symbols
+    static std::optional<Symbol> tryIntern(const std::string& str);
+
+    struct Entry
+    {
+        std::string str;
+        uint32_t    id;
+    };
+
+private:
+    explicit Symbol(const Entry* entry)
+        : m_entry(entry)
+    {
+    }
+
+    const Entry* m_entry;
+};
+
+inline bool operator==(const Symbol& l, const Symbol& r)
+{
+    return l.id() == r.id();
+}
+
+inline bool operator!=(const Symbol& l, const Symbol& r)
+{
+    return l.id() != r.id();
+}
+
+inline bool operator==(const Symbol& l, const std::string& r)
+{
+    return l.str() == r;
+}
+
+inline bool operator==(const std::string& l, const Symbol& r)
+{
+    return l == r.str();
+}
+
+inline bool operator==(const Symbol& l, const char* r)
+{
+    return l.str() == r;
+}
+
+inline bool operator!=(const Symbol& l, const std::string& r)
+{
+    return l.str() != r;
+}
+
+inline bool operator!=(const std::string& l, const Symbol& r)
+{
+    return l != r.str();
+}
+
+inline bool operator!=(const Symbol& l, const char* r)
+{
+    return l.str() != r;
+}
+
+/// lexicographic order, as std::string
+inline bool operator<(const Symbol& l, const Symbol& r)
+{
+    return l.str() < r.str();
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Symbol& symbol)
+{
+    return os << symbol.str();
+}
+
+} // namespace fty
+
+namespace std {
+template <>
+struct hash<fty::Symbol>
+{
+    size_t operator()(const fty::Symbol& symbol) const noexcept
+    {
+        return std::hash<uint32_t>()(symbol.id());
+    }
+};
+} // namespace std
@@ -0,0 +1,459 @@
+/*  =========================================================================
+    asset_conversion_binary - asset/conversion/binary
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "conversion/binary.h"
+
+#include <fty_asset_dto.h>
+#include <stdexcept>
+
+// Hand written protobuf encoder/decoder for the schema in conversion/binary.h: assets are a handful of plain
+// fields, which does not justify generated code and a libprotobuf dependency for every user of the DTO.
+// Output is standard protobuf, any protobuf implementation can read it with the .proto from the header.
+
+namespace fty { namespace conversion {
+
+    enum WireType : uint32_t
+    {
+        VARINT = 0,
+        I64    = 1,
+        LEN    = 2,
+        I32    = 5
+    };
+
+    // writer
+
+    static void putVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out += char((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += char(value);
+    }
+
+    static void putTag(std::string& out, uint32_t field, WireType type)
+    {
+        putVarint(out, (uint64_t(field) << 3) | type);
+    }
+
+    static void putString(std::string& out, uint32_t field, const std::string& str)
+    {
+        if (str.empty()) {
+            return;
+        }
+        putTag(out, field, LEN);
+        putVarint(out, str.size());
+        out += str;
+    }
+
+    static void putInt(std::string& out, uint32_t field, int32_t value)
+    {
+        putTag(out, field, VARINT);
+        // negative int32 are sign extended to 64 bits, as protobuf does
+        putVarint(out, uint64_t(int64_t(value)));
+    }
+
+    static void putBool(std::string& out, uint32_t field, bool value)
+    {
+        if (value) {
+            putTag(out, field, VARINT);
+            out += char(1);
+        }
+    }
+
+    // nested message: body is written in place, its length is inserted in front of it afterwards
+    template <typename Fn>
+    static void putMessage(std::string& out, uint32_t field, Fn&& writeBody)
+    {
+        putTag(out, field, LEN);
+        size_t start = out.size();
+        writeBody();
+
+        std::string length;
+        putVarint(length, out.size() - start);
+        out.insert(start, length);
+    }
+
+    static void putExtEntry(std::string& out, uint32_t field, const std::string& key, const ExtMapElement& element)
+    {
+        putMessage(out, field, [&]() {
+            putString(out, 1, key);
+            putString(out, 2, element.getValue());
+            putBool(out, 3, element.isReadOnly());
+            putBool(out, 4, element.wasUpdated());
+        });
+    }
+
+    static void putAsset(std::string& out, const Asset& asset)
+    {
+        putInt(out, 1, int32_t(asset.getAssetStatus()));
+        putString(out, 2, asset.getAssetType());
+        putString(out, 3, asset.getAssetSubtype());
+        putString(out, 4, asset.getInternalName());
+        putInt(out, 5, asset.getPriority());
+        putString(out, 6, asset.getParentIname());
+
+        for (const auto& link : asset.getLinkedAssets()) {
+            putMessage(out, 7, [&]() {
+                putString(out, 1, link.sourceId());
+                putInt(out, 2, link.linkType());
+                putString(out, 3, link.srcOut());
+                putString(out, 4, link.destIn());
+                for (const auto& e : link.ext()) {
+                    putExtEntry(out, 5, e.first, e.second);
+                }
+                putString(out, 6, link.secondaryID());
+            });
+        }
+
+        asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+            putExtEntry(out, 8, key, element);
+        });
+        putString(out, 9, asset.getSecondaryID());
+
+        if (asset.hasParentsList()) {
+            for (const auto& parent : asset.getParentsList()) {
+                putMessage(out, 10, [&]() {
+                    putAsset(out, parent);
+                });
+            }
+            putBool(out, 11, true);
+        }
+    }
+
+    // reader
+
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(const std::string& data)
+            : m_pos(reinterpret_cast<const uint8_t*>(data.data()))
+            , m_end(m_pos + data.size())
+        {
+        }
+
+        void read(Asset& asset)
+        {
+            readAsset(asset, m_end);
+        }
+
+        void read(std::vector<Asset>& list)
+        {
+            readFields(m_end, [&](uint32_t field, uint32_t type) {
+                if (field == 1 && type == LEN) {
+                    list.emplace_back();
+                    readAsset(list.back(), messageEnd());
+                } else {
+                    skip(type);
+                }
+            });
+        }
+
+    private:
+        [[noreturn]] void error(const std::string& msg) const
+        {
+            throw std::runtime_error("Invalid asset protobuf: " + msg);
+        }
+
+        uint64_t readVarint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (m_pos == m_end) {
+                    error("truncated varint");
+                }
+                uint8_t byte = *m_pos++;
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            error("varint too long");
+        }
+
+        const uint8_t* messageEnd()
+        {
+            uint64_t length = readVarint();
+            if (length > uint64_t(m_end - m_pos)) {
+                error("truncated field");
+            }
+            return m_pos + length;
+        }
+
+        void skip(uint32_t type)
+        {
+            size_t length = 0;
+            switch (type) {
+                case VARINT:
+                    readVarint();
+                    return;
+                case I64:
+                    length = 8;
+                    break;
+                case I32:
+                    length = 4;
+                    break;
+                case LEN:
+                    m_pos = messageEnd();
+                    return;
+                default:
+                    error("unsupported wire type " + std::to_string(type));
+            }
+            if (length > size_t(m_end - m_pos)) {
+                error("truncated field");
+            }
+            m_pos += length;
+        }
+
+        // calls fn(field, wireType) for every field until `end`, fn must consume the value
+        template <typename Fn>
+        void readFields(const uint8_t* end, Fn&& fn)
+        {
+            const uint8_t* outer = m_end;
+            m_end                = end;
+            while (m_pos != m_end) {
+                uint64_t key = readVarint();
+                fn(uint32_t(key >> 3), uint32_t(key & 0x7));
+            }
+            m_end = outer;
+        }
+
+        void readString(uint32_t type, std::string& out)
+        {
+            if (type != LEN) {
+                error("string expected");
+            }
+            const uint8_t* end = messageEnd();
+            out.assign(reinterpret_cast<const char*>(m_pos), size_t(end - m_pos));
+            m_pos = end;
+        }
+
+        int32_t readInt(uint32_t type)
+        {
+            if (type != VARINT) {
+                error("integer expected");
+            }
+            return int32_t(readVarint());
+        }
+
+        bool readBool(uint32_t type)
+        {
+            if (type != VARINT) {
+                error("boolean expected");
+            }
+            return readVarint() != 0;
+        }
+
+        // fn(key, element) stores the attribute
+        template <typename Fn>
+        void readExt(uint32_t type, Fn&& fn)
+        {
+            if (type != LEN) {
+                error("ext attribute expected");
+            }
+            ExtMapElement element;
+            std::string   key;
+            bool          updated = false;
+            readFields(messageEnd(), [&](uint32_t field, uint32_t fieldType) {
+                switch (field) {
+                    case 1:
+                        readString(fieldType, key);
+                        break;
+                    case 2:
+                        readString(fieldType, m_buffer);
+                        element.setValue(m_buffer);
+                        break;
+                    case 3:
+                        element.setReadOnly(readBool(fieldType));
+                        break;
+                    case 4:
+                        updated = readBool(fieldType);
+                        break;
+                    default:
+                        skip(fieldType);
+                }
+            });
+            element.setUpdated(updated);
+            fn(key, std::move(element));
+            m_buffer.clear();
+        }
+
+        void readLink(AssetLink& link, uint32_t type)
+        {
+            if (type != LEN) {
+                error("link expected");
+            }
+            AssetLink::ExtMap ext;
+            readFields(messageEnd(), [&](uint32_t field, uint32_t fieldType) {
+                switch (field) {
+                    case 1:
+                        readString(fieldType, m_buffer);
+                        link.setSourceId(m_buffer);
+                        break;
+                    case 2:
+                        link.setLinkType(readInt(fieldType));
+                        break;
+                    case 3:
+                        readString(fieldType, m_buffer);
+                        link.setSrcOut(m_buffer);
+                        break;
+                    case 4:
+                        readString(fieldType, m_buffer);
+                        link.setDestIn(m_buffer);
+                        break;
+                    case 5:
+                        readExt(fieldType, [&](const std::string& key, ExtMapElement&& element) {
+                            ext[key] = std::move(element);
+                        });
+                        break;
+                    case 6:
+                        readString(fieldType, m_buffer);
+                        link.setSecondaryID(m_buffer);
+                        break;
+                    default:
+                        skip(fieldType);
+                }
+            });
+            link.setExt(ext);
+        }
+
+        void readAsset(Asset& asset, const uint8_t* end)
+        {
+            // also drops the cached fingerprint, setters below do not have to maintain it
+            asset.clearExtMap();
+
+            // proto3 defaults, fields with default value may be omitted by other encoders
+            asset.setAssetStatus(AssetStatus::Unknown);
+            asset.setAssetType("");
+            asset.setAssetSubtype("");
+            asset.setInternalName(std::string());
+            asset.setPriority(0);
+            asset.setParentIname(std::string());
+            asset.setSecondaryID(std::string());
+
+            // appended to the links already there, as the JSON readers do
+            std::vector<AssetLink> links(asset.getLinkedAssets());
+            std::vector<Asset>     parents;
+            bool                   hasParents = false;
+
+            readFields(end, [&](uint32_t field, uint32_t type) {
+                switch (field) {
+                    case 1:
+                        asset.setAssetStatus(AssetStatus(readInt(type)));
+                        break;
+                    case 2:
+                        readString(type, m_buffer);
+                        asset.setAssetType(m_buffer);
+                        break;
+                    case 3:
+                        readString(type, m_buffer);
+                        asset.setAssetSubtype(m_buffer);
+                        break;
+                    case 4: {
+                        std::string name;
+                        readString(type, name);
+                        asset.setInternalName(std::move(name));
+                        break;
+                    }
+                    case 5:
+                        asset.setPriority(readInt(type));
+                        break;
+                    case 6: {
+                        std::string parent;
+                        readString(type, parent);
+                        asset.setParentIname(std::move(parent));
+                        break;
+                    }
+                    case 7:
+                        links.emplace_back();
+                        readLink(links.back(), type);
+                        break;
+                    case 8:
+                        readExt(type, [&](const std::string& key, ExtMapElement&& element) {
+                            asset.setExtElement(key, std::move(element));
+                        });
+                        break;
+                    case 9: {
+                        std::string secondaryId;
+                        readString(type, secondaryId);
+                        asset.setSecondaryID(std::move(secondaryId));
+                        break;
+                    }
+                    case 10:
+                        if (type != LEN) {
+                            error("asset expected");
+                        }
+                        parents.emplace_back();
+                        readAsset(parents.back(), messageEnd());
+                        hasParents = true;
+                        break;
+                    case 11:
+                        hasParents = readBool(type) || hasParents;
+                        break;
+                    default:
+                        skip(type);
+                }
+            });
+
+            asset.setLinkedAssets(std::move(links));
+            if (hasParents) {
+                asset.setParentsList(std::move(parents));
+            }
+        }
+
+        const uint8_t* m_pos;
+        const uint8_t* m_end;
+        std::string    m_buffer;
+    };
+
+    std::string toBinary(const Asset& asset)
+    {
+        std::string data;
+        // typical asset, with a few dozens of ext attributes
+        data.reserve(1024);
+
+        putAsset(data, asset);
+
+        return data;
+    }
+
+    std::string toBinary(const std::vector<Asset>& list)
+    {
+        std::string data;
+        for (const auto& asset : list) {
+            putMessage(data, 1, [&]() {
+                putAsset(data, asset);
+            });
+        }
+        return data;
+    }
+
+    void fromBinary(const std::string& data, fty::Asset& asset)
+    {
+        BinaryReader(data).read(asset);
+    }
+
+    void fromBinary(const std::string& data, std::vector<fty::Asset>& list)
+    {
+        BinaryReader(data).read(list);
+    }
+
+}} // namespace fty::conversion
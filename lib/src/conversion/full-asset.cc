@@ -33,10 +33,10 @@ namespace fty { namespace conversion {
         fty::FullAsset::HashMap auxMap; // does not exist in new Asset implementation
         fty::FullAsset::HashMap extMap;
 
-        for (const auto& element : asset.getExt()) {
+        asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
             // FullAsset hash map has no readOnly parameter
-            extMap[element.first] = element.second.getValue();
-        }
+            extMap[key] = element.getValue();
+        });
 
         fty::FullAsset fa(asset.getInternalName(), fty::assetStatusToString(asset.getAssetStatus()),
             asset.getAssetType(), asset.getAssetSubtype(),
@@ -21,38 +21,649 @@
 
 #include "conversion/json.h"
 
+#include <charconv>
 #include <fty_asset_dto.h>
-#include <cxxtools/jsondeserializer.h>
-#include <cxxtools/jsonserializer.h>
-#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+// Direct JSON codec for Asset, same document as cxxtools serialization of Asset::serialize():
+// {"status":1,"type":"..","sub_type":"..","name":"..","priority":1,"parent":"..","linked":[..],"ext":{..},
+//  "secondary_id":"..","parents_list":[..]}
+// Writer appends to a single string; reader is a pull parser which fills the asset while it reads the input,
+// without building an intermediate tree.
 
 namespace fty { namespace conversion {
 
-    std::string toJson(const Asset& asset)
+    // writer
+
+    static void writeString(std::string& out, const std::string& str)
     {
-        std::ostringstream output;
+        static constexpr const char* HEX = "0123456789abcdef";
 
-        cxxtools::SerializationInfo si;
-        cxxtools::JsonSerializer    serializer(output);
+        out += '"';
+        for (char c : str) {
+            switch (c) {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\b':
+                    out += "\\b";
+                    break;
+                case '\f':
+                    out += "\\f";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out += HEX[(c >> 4) & 0xf];
+                        out += HEX[c & 0xf];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
 
-        si <<= asset;
-        serializer.serialize(si);
+    static void writeKey(std::string& out, const char* key)
+    {
+        out += '"';
+        out += key;
+        out += "\":";
+    }
 
-        std::string json = output.str();
+    static void writeExtEntry(std::string& out, const std::string& key, const ExtMapElement& element, bool& first)
+    {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
 
-        return json;
+        writeString(out, key);
+        out += ":{\"value\":";
+        writeString(out, element.getValue());
+        out += element.isReadOnly() ? ",\"readOnly\":true" : ",\"readOnly\":false";
+        out += element.wasUpdated() ? ",\"update\":true}" : ",\"update\":false}";
     }
 
-    void fromJson(const std::string& json, fty::Asset& asset)
+    static void writeExt(std::string& out, const AssetLink::ExtMap& ext)
+    {
+        out += '{';
+        bool first = true;
+        for (const auto& e : ext) {
+            writeExtEntry(out, e.first, e.second, first);
+        }
+        out += '}';
+    }
+
+    static void writeExt(std::string& out, const Asset& asset)
+    {
+        out += '{';
+        bool first = true;
+        asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+            writeExtEntry(out, key, element, first);
+        });
+        out += '}';
+    }
+
+    static void writeLink(std::string& out, const AssetLink& link)
+    {
+        out += '{';
+        writeKey(out, "source");
+        writeString(out, link.sourceId());
+        out += ',';
+        writeKey(out, "link_type");
+        out += std::to_string(link.linkType());
+        if (!link.srcOut().empty()) {
+            out += ',';
+            writeKey(out, "src_out");
+            writeString(out, link.srcOut());
+        }
+        if (!link.destIn().empty()) {
+            out += ',';
+            writeKey(out, "dest_in");
+            writeString(out, link.destIn());
+        }
+        if (!link.ext().empty()) {
+            out += ',';
+            writeKey(out, "link_ext");
+            writeExt(out, link.ext());
+        }
+        if (!link.secondaryID().empty()) {
+            out += ',';
+            writeKey(out, "secondary_id");
+            writeString(out, link.secondaryID());
+        }
+        out += '}';
+    }
+
+    static void writeAsset(std::string& out, const Asset& asset)
+    {
+        out += '{';
+        writeKey(out, "status");
+        out += std::to_string(int(asset.getAssetStatus()));
+        out += ',';
+        writeKey(out, "type");
+        writeString(out, asset.getAssetType());
+        out += ',';
+        writeKey(out, "sub_type");
+        writeString(out, asset.getAssetSubtype());
+        out += ',';
+        writeKey(out, "name");
+        writeString(out, asset.getInternalName());
+        out += ',';
+        writeKey(out, "priority");
+        out += std::to_string(asset.getPriority());
+        out += ',';
+        writeKey(out, "parent");
+        writeString(out, asset.getParentIname());
+
+        out += ',';
+        writeKey(out, "linked");
+        out += '[';
+        bool first = true;
+        for (const auto& link : asset.getLinkedAssets()) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            writeLink(out, link);
+        }
+        out += ']';
+
+        out += ',';
+        writeKey(out, "ext");
+        writeExt(out, asset);
+
+        if (!asset.getSecondaryID().empty()) {
+            out += ',';
+            writeKey(out, "secondary_id");
+            writeString(out, asset.getSecondaryID());
+        }
+
+        if (asset.hasParentsList()) {
+            out += ',';
+            writeKey(out, "parents_list");
+            out += '[';
+            first = true;
+            for (const auto& parent : asset.getParentsList()) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+                writeAsset(out, parent);
+            }
+            out += ']';
+        }
+
+        out += '}';
+    }
+
+    // reader
+
+    class JsonReader
+    {
+    public:
+        explicit JsonReader(const std::string& json)
+            : m_pos(json.data())
+            , m_end(json.data() + json.size())
+        {
+        }
+
+        void read(Asset& asset)
+        {
+            readAsset(asset);
+            skipWs();
+            if (m_pos != m_end) {
+                error("unexpected data after asset");
+            }
+        }
+
+    private:
+        [[noreturn]] void error(const std::string& msg) const
+        {
+            throw std::runtime_error("Invalid asset JSON: " + msg);
+        }
+
+        void skipWs()
+        {
+            while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+                ++m_pos;
+            }
+        }
+
+        char peek()
+        {
+            skipWs();
+            if (m_pos == m_end) {
+                error("unexpected end of input");
+            }
+            return *m_pos;
+        }
+
+        void expect(char c)
+        {
+            if (peek() != c) {
+                error(std::string("expected '") + c + "'");
+            }
+            ++m_pos;
+        }
+
+        bool consumeWord(std::string_view word)
+        {
+            if (size_t(m_end - m_pos) >= word.size() && std::string_view(m_pos, word.size()) == word) {
+                m_pos += word.size();
+                return true;
+            }
+            return false;
+        }
+
+        void appendUtf8(std::string& out, uint32_t cp)
+        {
+            if (cp < 0x80) {
+                out += char(cp);
+            } else if (cp < 0x800) {
+                out += char(0xc0 | (cp >> 6));
+                out += char(0x80 | (cp & 0x3f));
+            } else if (cp < 0x10000) {
+                out += char(0xe0 | (cp >> 12));
+                out += char(0x80 | ((cp >> 6) & 0x3f));
+                out += char(0x80 | (cp & 0x3f));
+            } else {
+                out += char(0xf0 | (cp >> 18));
+                out += char(0x80 | ((cp >> 12) & 0x3f));
+                out += char(0x80 | ((cp >> 6) & 0x3f));
+                out += char(0x80 | (cp & 0x3f));
+            }
+        }
+
+        uint32_t hex4()
+        {
+            if (m_end - m_pos < 4) {
+                error("truncated \\u escape");
+            }
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i, ++m_pos) {
+                char c = *m_pos;
+                value <<= 4;
+                if (c >= '0' && c <= '9') {
+                    value |= uint32_t(c - '0');
+                } else if (c >= 'a' && c <= 'f') {
+                    value |= uint32_t(c - 'a' + 10);
+                } else if (c >= 'A' && c <= 'F') {
+                    value |= uint32_t(c - 'A' + 10);
+                } else {
+                    error("invalid \\u escape");
+                }
+            }
+            return value;
+        }
+
+        // string literal, m_pos is on the opening quote
+        void readStringLiteral(std::string& out)
+        {
+            ++m_pos;
+            while (true) {
+                // copy runs of plain characters at once
+                const char* start = m_pos;
+                while (m_pos != m_end && *m_pos != '"' && *m_pos != '\\') {
+                    ++m_pos;
+                }
+                out.append(start, size_t(m_pos - start));
+
+                if (m_pos == m_end) {
+                    error("unterminated string");
+                }
+                if (*m_pos++ == '"') {
+                    return;
+                }
+                if (m_pos == m_end) {
+                    error("unterminated string");
+                }
+                switch (*m_pos++) {
+                    case '"':
+                        out += '"';
+                        break;
+                    case '\\':
+                        out += '\\';
+                        break;
+                    case '/':
+                        out += '/';
+                        break;
+                    case 'b':
+                        out += '\b';
+                        break;
+                    case 'f':
+                        out += '\f';
+                        break;
+                    case 'n':
+                        out += '\n';
+                        break;
+                    case 'r':
+                        out += '\r';
+                        break;
+                    case 't':
+                        out += '\t';
+                        break;
+                    case 'u': {
+                        uint32_t cp = hex4();
+                        if (cp >= 0xd800 && cp < 0xdc00) {
+                            // high surrogate, must be followed by a low one
+                            if (!consumeWord("\\u")) {
+                                error("unpaired surrogate");
+                            }
+                            uint32_t low = hex4();
+                            if (low < 0xdc00 || low >= 0xe000) {
+                                error("unpaired surrogate");
+                            }
+                            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                        } else if (cp >= 0xdc00 && cp < 0xe000) {
+                            error("unpaired surrogate");
+                        }
+                        appendUtf8(out, cp);
+                        break;
+                    }
+                    default:
+                        error("invalid escape");
+                }
+            }
+        }
+
+        // scalar as string, as cxxtools does for numbers, booleans and null
+        void readString(std::string& out)
+        {
+            out.clear();
+            char c = peek();
+            if (c == '"') {
+                readStringLiteral(out);
+            } else if (consumeWord("null")) {
+            } else if (consumeWord("true")) {
+                out = "true";
+            } else if (consumeWord("false")) {
+                out = "false";
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                const char* start = m_pos;
+                while (m_pos != m_end &&
+                       ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '-' || *m_pos == '+' || *m_pos == '.' ||
+                           *m_pos == 'e' || *m_pos == 'E')) {
+                    ++m_pos;
+                }
+                out.assign(start, size_t(m_pos - start));
+            } else {
+                error("expected string");
+            }
+        }
+
+        int readInt()
+        {
+            int value = 0;
+            if (peek() == '"') {
+                readString(m_buffer);
+                if (std::from_chars(m_buffer.data(), m_buffer.data() + m_buffer.size(), value).ec != std::errc()) {
+                    error("expected integer");
+                }
+                return value;
+            }
+            auto res = std::from_chars(m_pos, m_end, value);
+            if (res.ec != std::errc()) {
+                error("expected integer");
+            }
+            m_pos = res.ptr;
+            return value;
+        }
+
+        bool readBool()
+        {
+            if (peek() == 't' && consumeWord("true")) {
+                return true;
+            }
+            if (*m_pos == 'f' && consumeWord("false")) {
+                return false;
+            }
+            readString(m_buffer);
+            return m_buffer == "true" || m_buffer == "1";
+        }
+
+        void skipValue()
+        {
+            char c = peek();
+            if (c == '{' || c == '[') {
+                forEach(c, [this](const std::string&) {
+                    skipValue();
+                });
+            } else {
+                readString(m_skip);
+            }
+        }
+
+        // iterate over object members or array items, fn(key) must consume the value (key is empty in arrays)
+        template <typename Fn>
+        void forEach(char open, Fn&& fn)
+        {
+            const char close = (open == '{') ? '}' : ']';
+            expect(open);
+            // values are read recursively, bound the stack used by nested input
+            if (++m_depth > MAX_DEPTH) {
+                error("nesting too deep");
+            }
+            if (peek() == close) {
+                ++m_pos;
+                --m_depth;
+                return;
+            }
+
+            std::string key;
+            while (true) {
+                if (open == '{') {
+                    if (peek() != '"') {
+                        error("expected member name");
+                    }
+                    key.clear();
+                    readStringLiteral(key);
+                    expect(':');
+                }
+                fn(key);
+
+                char c = peek();
+                ++m_pos;
+                if (c == close) {
+                    --m_depth;
+                    return;
+                }
+                if (c != ',') {
+                    error(std::string("expected ',' or '") + close + "'");
+                }
+            }
+        }
+
+        void readExtElement(ExtMapElement& element)
+        {
+            unsigned found   = 0;
+            bool     updated = false;
+            forEach('{', [&](const std::string& key) {
+                if (key == "value") {
+                    readString(m_buffer);
+                    element.setValue(m_buffer);
+                    found |= 1;
+                } else if (key == "readOnly") {
+                    element.setReadOnly(readBool());
+                    found |= 2;
+                } else if (key == "update") {
+                    updated = readBool();
+                    found |= 4;
+                } else {
+                    skipValue();
+                }
+            });
+            if (found != 7) {
+                error("ext attribute requires value, readOnly and update");
+            }
+            element.setUpdated(updated);
+        }
+
+        // fn(key, element) stores an attribute
+        template <typename Fn>
+        void readExt(Fn&& fn)
+        {
+            forEach('{', [&](const std::string& key) {
+                ExtMapElement element;
+                readExtElement(element);
+                fn(key, std::move(element));
+            });
+        }
+
+        void readLink(AssetLink& link)
+        {
+            unsigned found = 0;
+            forEach('{', [&](const std::string& key) {
+                if (key == "source") {
+                    readString(m_buffer);
+                    link.setSourceId(m_buffer);
+                    found |= 1;
+                } else if (key == "link_type") {
+                    link.setLinkType(readInt());
+                    found |= 2;
+                } else if (key == "src_out") {
+                    readString(m_buffer);
+                    link.setSrcOut(m_buffer);
+                } else if (key == "dest_in") {
+                    readString(m_buffer);
+                    link.setDestIn(m_buffer);
+                } else if (key == "link_ext") {
+                    AssetLink::ExtMap ext;
+                    readExt([&](const std::string& extKey, ExtMapElement&& element) {
+                        ext[extKey] = std::move(element);
+                    });
+                    link.setExt(ext);
+                } else if (key == "secondary_id") {
+                    readString(m_buffer);
+                    link.setSecondaryID(m_buffer);
+                } else {
+                    skipValue();
+                }
+            });
+            if (found != 3) {
+                error("link requires source and link_type");
+            }
+        }
+
+        void readAsset(Asset& asset)
+        {
+            // also drops the cached fingerprint, setters below do not have to maintain it
+            asset.clearExtMap();
+
+            enum : unsigned
+            {
+                STATUS   = 1 << 0,
+                TYPE     = 1 << 1,
+                SUB_TYPE = 1 << 2,
+                NAME     = 1 << 3,
+                PRIORITY = 1 << 4,
+                PARENT   = 1 << 5,
+                LINKED   = 1 << 6,
+                EXT      = 1 << 7,
+                REQUIRED = (1 << 8) - 1
+            };
+
+            unsigned found = 0;
+            forEach('{', [&](const std::string& key) {
+                if (key == "status") {
+                    asset.setAssetStatus(AssetStatus(readInt()));
+                    found |= STATUS;
+                } else if (key == "type") {
+                    readString(m_buffer);
+                    asset.setAssetType(m_buffer);
+                    found |= TYPE;
+                } else if (key == "sub_type") {
+                    readString(m_buffer);
+                    asset.setAssetSubtype(m_buffer);
+                    found |= SUB_TYPE;
+                } else if (key == "name") {
+                    std::string name;
+                    readString(name);
+                    asset.setInternalName(std::move(name));
+                    found |= NAME;
+                } else if (key == "priority") {
+                    asset.setPriority(readInt());
+                    found |= PRIORITY;
+                } else if (key == "parent") {
+                    std::string parent;
+                    readString(parent);
+                    asset.setParentIname(std::move(parent));
+                    found |= PARENT;
+                } else if (key == "linked") {
+                    // appended to the links already there, as cxxtools deserialization does
+                    std::vector<AssetLink> links(asset.getLinkedAssets());
+                    forEach('[', [&](const std::string&) {
+                        AssetLink link;
+                        readLink(link);
+                        links.push_back(std::move(link));
+                    });
+                    asset.setLinkedAssets(std::move(links));
+                    found |= LINKED;
+                } else if (key == "ext") {
+                    asset.clearExtMap();
+                    readExt([&](const std::string& extKey, ExtMapElement&& element) {
+                        asset.setExtElement(extKey, std::move(element));
+                    });
+                    found |= EXT;
+                } else if (key == "secondary_id") {
+                    std::string secondaryId;
+                    readString(secondaryId);
+                    asset.setSecondaryID(std::move(secondaryId));
+                } else if (key == "parents_list") {
+                    std::vector<Asset> parents;
+                    forEach('[', [&](const std::string&) {
+                        parents.emplace_back();
+                        readAsset(parents.back());
+                    });
+                    asset.setParentsList(std::move(parents));
+                } else {
+                    skipValue();
+                }
+            });
+
+            if ((found & REQUIRED) != REQUIRED) {
+                error("asset requires status, type, sub_type, name, priority, parent, linked and ext");
+            }
+        }
+
+        // far above what assets need (parents list of an asset)
+        static constexpr int MAX_DEPTH = 64;
+
+        const char* m_pos;
+        const char* m_end;
+        int         m_depth = 0;
+        std::string m_buffer;
+        std::string m_skip;
+    };
+
+    std::string toJson(const Asset& asset)
     {
-        std::istringstream input(json);
+        std::string json;
+        // typical asset, with a few dozens of ext attributes
+        json.reserve(2048);
 
-        cxxtools::SerializationInfo si;
-        cxxtools::JsonDeserializer  deserializer(input);
+        writeAsset(json, asset);
 
-        deserializer.deserialize(si);
+        return json;
+    }
 
-        si >>= asset;
+    void fromJson(const std::string& json, fty::Asset& asset)
+    {
+        JsonReader(json).read(asset);
     }
 
 }} // namespace fty::conversion
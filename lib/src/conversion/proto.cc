@@ -22,17 +22,19 @@
 #include "conversion/proto.h"
 
 #include <fty_asset_dto.h>
+#include <fty_asset_id_resolver.h>
 #include <fty_common_db.h>
 #include <fty_log.h>
 #include <fty/convert.h>
 #include <fty_proto.h>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace fty { namespace conversion {
 
-    // fty-proto/Asset conversion
-    // return a valid fty_proto_t* object, else throw exception
-    fty_proto_t* toFtyProto(const fty::Asset& asset, const std::string& operation, bool test)
+    // fty-proto/Asset conversion, parent is the database id of the parent ("0" if none)
+    static fty_proto_t* buildFtyProto(const fty::Asset& asset, const std::string& operation, const std::string& parent)
     {
         fty_proto_t* proto = fty_proto_new(FTY_PROTO_ASSET);
         if (!proto) {
@@ -49,30 +51,86 @@ namespace fty { namespace conversion {
         fty_proto_aux_insert(proto, "status", "%s", assetStatusToString(asset.getAssetStatus()).c_str());
 
         // aux/parent
+        fty_proto_aux_insert(proto, "parent", "%s", parent.c_str());
+
+        // extended attributes
+        asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+            fty_proto_ext_insert(proto, key.c_str(), "%s", element.getValue().c_str());
+        });
+
+        return proto;
+    }
+
+    static std::runtime_error parentNotFound(const std::string& parentIname)
+    {
+        log_error("Could not find parent ID from iname %s", parentIname.c_str());
+        return std::runtime_error(
+            "Invalid conversion from Asset to fty_proto_t : Could not find parent ID from iname " + parentIname);
+    }
+
+    // return a valid fty_proto_t* object, else throw exception
+    fty_proto_t* toFtyProto(const fty::Asset& asset, const std::string& operation, bool test)
+    {
         std::string parent{"0"};
         if (!test && !asset.getParentIname().empty()) {
+            int64_t parentId;
             try {
-                auto parentId = DBAssets::name_to_asset_id(asset.getParentIname());
-                if (parentId < 0) {
-                    log_error("Could not find parent ID from iname %s", asset.getParentIname().c_str());
-                    throw std::runtime_error("Could not find parent ID from iname " + asset.getParentIname());
+                parentId = AssetIdResolver::instance().resolve(asset.getParentIname());
+            } catch (const std::exception& e) {
+                log_error("Invalid conversion from Asset to fty_proto_t : %s", e.what());
+                throw std::runtime_error("Invalid conversion from Asset to fty_proto_t : " + std::string(e.what()));
+            }
+            if (parentId < 0) {
+                throw parentNotFound(asset.getParentIname());
+            }
+            parent = std::to_string(parentId);
+        }
+
+        return buildFtyProto(asset, operation, parent);
+    }
+
+    // all parents are resolved at once, caller owns the returned messages
+    std::vector<fty_proto_t*> toFtyProto(const std::vector<fty::Asset>& assets, const std::string& operation, bool test)
+    {
+        std::map<std::string, int64_t> parentIds;
+        if (!test) {
+            std::vector<std::string> parents;
+            for (const auto& asset : assets) {
+                if (!asset.getParentIname().empty()) {
+                    parents.push_back(asset.getParentIname());
                 }
-                parent = std::to_string(parentId);
             }
-            catch (const std::exception& e) {
-                fty_proto_destroy(&proto);
+
+            try {
+                parentIds = AssetIdResolver::instance().resolve(parents);
+            } catch (const std::exception& e) {
                 log_error("Invalid conversion from Asset to fty_proto_t : %s", e.what());
                 throw std::runtime_error("Invalid conversion from Asset to fty_proto_t : " + std::string(e.what()));
             }
         }
-        fty_proto_aux_insert(proto, "parent", "%s", parent.c_str());
 
-        // extended attributes
-        for (const auto& i : asset.getExt()) {
-            fty_proto_ext_insert(proto, i.first.c_str(), "%s", i.second.getValue().c_str());
+        std::vector<fty_proto_t*> protos;
+        protos.reserve(assets.size());
+        try {
+            for (const auto& asset : assets) {
+                std::string parent{"0"};
+                if (!test && !asset.getParentIname().empty()) {
+                    auto found = parentIds.find(asset.getParentIname());
+                    if (found == parentIds.end()) {
+                        throw parentNotFound(asset.getParentIname());
+                    }
+                    parent = std::to_string(found->second);
+                }
+                protos.push_back(buildFtyProto(asset, operation, parent));
+            }
+        } catch (...) {
+            for (auto& proto : protos) {
+                fty_proto_destroy(&proto);
+            }
+            throw;
         }
 
-        return proto;
+        return protos;
     }
 
     void fromFtyProto(fty_proto_t* proto, fty::Asset& asset, bool extAttributeReadOnly, bool test)
@@ -124,11 +182,15 @@ namespace fty { namespace conversion {
             asset.setExtEntry("name", asset.getExtEntry("name"), false);
             asset.setExtEntry("ip.1", asset.getExtEntry("ip.1"), false);
             // all endpoint attribs are RW
-            for(const auto& att : asset.getExt()) {
+            std::vector<std::pair<std::string, std::string>> endpoints;
+            asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
                 //An endpoint is always "endpoint.<params>"
-                if(att.first.find("endpoint.") == 0) {
-                    asset.setExtEntry(att.first, att.second.getValue(), false);
+                if(key.find("endpoint.") == 0) {
+                    endpoints.emplace_back(key, element.getValue());
                 }
+            });
+            for(const auto& att : endpoints) {
+                asset.setExtEntry(att.first, att.second, false);
             }
         }//
     }
@@ -0,0 +1,266 @@
+/*  =========================================================================
+    fty_asset_delta - Changed fields between two versions of an asset
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_asset_delta.h"
+
+namespace fty {
+
+static bool sameLinks(const std::vector<AssetLink>& l, const std::vector<AssetLink>& r)
+{
+    if (l.size() != r.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < l.size(); ++i) {
+        // AssetLink equality ignores attributes and secondary id
+        if (!(l[i] == r[i]) || l[i].ext() != r[i].ext() || l[i].secondaryID() != r[i].secondaryID()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+static void diffField(std::optional<T>& field, const T& before, const T& after)
+{
+    if (before != after) {
+        field = after;
+    }
+}
+
+AssetDelta AssetDelta::diff(const Asset& before, const Asset& after, uint64_t version)
+{
+    AssetDelta delta;
+    delta.name    = after.getInternalName();
+    delta.version = version;
+
+    diffField(delta.status, before.getAssetStatus(), after.getAssetStatus());
+    diffField(delta.type, before.getAssetType(), after.getAssetType());
+    diffField(delta.subType, before.getAssetSubtype(), after.getAssetSubtype());
+    diffField(delta.priority, before.getPriority(), after.getPriority());
+    diffField(delta.parent, before.getParentIname(), after.getParentIname());
+    diffField(delta.secondaryID, before.getSecondaryID(), after.getSecondaryID());
+
+    if (!sameLinks(before.getLinkedAssets(), after.getLinkedAssets())) {
+        delta.linked = after.getLinkedAssets();
+    }
+
+    // both ext attribute lists are sorted by key: single merge pass, without copying them
+    std::vector<std::pair<const std::string*, const ExtMapElement*>> l;
+    before.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+        l.emplace_back(&key, &element);
+    });
+
+    auto li = l.begin();
+    after.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+        for (; li != l.end() && *li->first < key; ++li) {
+            delta.extRemoved.push_back(*li->first);
+        }
+        if (li != l.end() && *li->first == key) {
+            if (*li->second != element) {
+                delta.ext.emplace(key, element);
+            }
+            ++li;
+        } else {
+            delta.ext.emplace(key, element);
+        }
+    });
+    for (; li != l.end(); ++li) {
+        delta.extRemoved.push_back(*li->first);
+    }
+
+    return delta;
+}
+
+bool AssetDelta::empty() const
+{
+    return !status && !type && !subType && !priority && !parent && !secondaryID && !linked && ext.empty() &&
+           extRemoved.empty();
+}
+
+void AssetDelta::apply(Asset& asset) const
+{
+    if (status) {
+        asset.setAssetStatus(*status);
+    }
+    if (type) {
+        asset.setAssetType(*type);
+    }
+    if (subType) {
+        asset.setAssetSubtype(*subType);
+    }
+    if (priority) {
+        asset.setPriority(*priority);
+    }
+    if (parent) {
+        asset.setParentIname(*parent);
+    }
+    if (secondaryID) {
+        asset.setSecondaryID(*secondaryID);
+    }
+    if (linked) {
+        asset.setLinkedAssets(*linked);
+    }
+
+    if (extRemoved.empty()) {
+        for (const auto& e : ext) {
+            asset.setExtElement(e.first, ExtMapElement(e.second));
+        }
+    } else {
+        // no single entry removal in the asset: rebuild the whole list
+        Asset::ExtMap map = asset.getExt();
+        for (const auto& key : extRemoved) {
+            map.erase(key);
+        }
+        for (const auto& e : ext) {
+            map[e.first] = e.second;
+        }
+        asset.setExtMap(std::move(map));
+    }
+}
+
+static constexpr const char* SI_DELTA_NAME         = "name";
+static constexpr const char* SI_DELTA_VERSION      = "version";
+static constexpr const char* SI_DELTA_STATUS       = "status";
+static constexpr const char* SI_DELTA_TYPE         = "type";
+static constexpr const char* SI_DELTA_SUB_TYPE     = "sub_type";
+static constexpr const char* SI_DELTA_PRIORITY     = "priority";
+static constexpr const char* SI_DELTA_PARENT       = "parent";
+static constexpr const char* SI_DELTA_SECONDARY_ID = "secondary_id";
+static constexpr const char* SI_DELTA_LINKED       = "linked";
+static constexpr const char* SI_DELTA_EXT          = "ext";
+static constexpr const char* SI_DELTA_EXT_REMOVED  = "ext_removed";
+
+void AssetDelta::serialize(cxxtools::SerializationInfo& si) const
+{
+    si.addMember(SI_DELTA_NAME) <<= name;
+    si.addMember(SI_DELTA_VERSION) <<= version;
+
+    if (status) {
+        si.addMember(SI_DELTA_STATUS) <<= int(*status);
+    }
+    if (type) {
+        si.addMember(SI_DELTA_TYPE) <<= *type;
+    }
+    if (subType) {
+        si.addMember(SI_DELTA_SUB_TYPE) <<= *subType;
+    }
+    if (priority) {
+        si.addMember(SI_DELTA_PRIORITY) <<= *priority;
+    }
+    if (parent) {
+        si.addMember(SI_DELTA_PARENT) <<= *parent;
+    }
+    if (secondaryID) {
+        si.addMember(SI_DELTA_SECONDARY_ID) <<= *secondaryID;
+    }
+
+    if (linked) {
+        cxxtools::SerializationInfo& links = si.addMember(SI_DELTA_LINKED);
+        for (const auto& l : *linked) {
+            cxxtools::SerializationInfo& link = links.addMember("");
+            link <<= l;
+            link.setCategory(cxxtools::SerializationInfo::Category::Object);
+        }
+        links.setCategory(cxxtools::SerializationInfo::Category::Array);
+    }
+
+    if (!ext.empty()) {
+        cxxtools::SerializationInfo& data = si.addMember(SI_DELTA_EXT);
+        for (const auto& e : ext) {
+            data.addMember(e.first) <<= e.second;
+        }
+        data.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+
+    if (!extRemoved.empty()) {
+        si.addMember(SI_DELTA_EXT_REMOVED) <<= extRemoved;
+    }
+}
+
+void AssetDelta::deserialize(const cxxtools::SerializationInfo& si)
+{
+    si.getMember(SI_DELTA_NAME) >>= name;
+    si.getMember(SI_DELTA_VERSION) >>= version;
+
+    int         tmpInt = 0;
+    std::string tmpString;
+
+    if (si.findMember(SI_DELTA_STATUS) != nullptr) {
+        si.getMember(SI_DELTA_STATUS) >>= tmpInt;
+        status = AssetStatus(tmpInt);
+    }
+    if (si.findMember(SI_DELTA_TYPE) != nullptr) {
+        si.getMember(SI_DELTA_TYPE) >>= tmpString;
+        type = tmpString;
+    }
+    if (si.findMember(SI_DELTA_SUB_TYPE) != nullptr) {
+        si.getMember(SI_DELTA_SUB_TYPE) >>= tmpString;
+        subType = tmpString;
+    }
+    if (si.findMember(SI_DELTA_PRIORITY) != nullptr) {
+        si.getMember(SI_DELTA_PRIORITY) >>= tmpInt;
+        priority = tmpInt;
+    }
+    if (si.findMember(SI_DELTA_PARENT) != nullptr) {
+        si.getMember(SI_DELTA_PARENT) >>= tmpString;
+        parent = tmpString;
+    }
+    if (si.findMember(SI_DELTA_SECONDARY_ID) != nullptr) {
+        si.getMember(SI_DELTA_SECONDARY_ID) >>= tmpString;
+        secondaryID = tmpString;
+    }
+
+    if (si.findMember(SI_DELTA_LINKED) != nullptr) {
+        std::vector<AssetLink> links;
+        for (const auto& linkSi : si.getMember(SI_DELTA_LINKED)) {
+            AssetLink l;
+            linkSi >>= l;
+            links.push_back(std::move(l));
+        }
+        linked = std::move(links);
+    }
+
+    ext.clear();
+    if (si.findMember(SI_DELTA_EXT) != nullptr) {
+        for (const auto& siExt : si.getMember(SI_DELTA_EXT)) {
+            ExtMapElement element;
+            siExt >>= element;
+            ext[siExt.name()] = std::move(element);
+        }
+    }
+
+    extRemoved.clear();
+    if (si.findMember(SI_DELTA_EXT_REMOVED) != nullptr) {
+        si.getMember(SI_DELTA_EXT_REMOVED) >>= extRemoved;
+    }
+}
+
+void operator<<=(cxxtools::SerializationInfo& si, const AssetDelta& delta)
+{
+    delta.serialize(si);
+}
+
+void operator>>=(const cxxtools::SerializationInfo& si, AssetDelta& delta)
+{
+    delta.deserialize(si);
+}
+
+} // namespace fty
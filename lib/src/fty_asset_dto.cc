@@ -27,6 +27,7 @@
 */
 
 #include "fty_asset_dto.h"
+#include "conversion/binary.h"
 #include "conversion/full-asset.h"
 #include "conversion/json.h"
 #include "conversion/proto.h"
@@ -35,6 +36,8 @@
 #include <cxxtools/jsonserializer.h>
 #include <fty_proto.h>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 
 
 namespace fty {
@@ -135,13 +138,13 @@ void AssetLink::setExt(const AssetLink::ExtMap& ext)
 
 void AssetLink::setExtEntry(const std::string& key, const std::string& value, bool readOnly, bool forceUpdatedFalse)
 {
-    if (m_ext.find(key) != m_ext.end()) {
+    auto found = m_ext.find(key);
+    if (found != m_ext.end()) {
         // key already exists, update values
-        m_ext.at(key).setValue(value);
-        m_ext.at(key).setReadOnly(readOnly);
+        found->second.setValue(value);
+        found->second.setReadOnly(readOnly);
     } else {
-        ExtMapElement element(value, readOnly, forceUpdatedFalse);
-        m_ext[key] = element;
+        m_ext.emplace(key, ExtMapElement(value, readOnly, forceUpdatedFalse));
     }
 }
 
@@ -283,6 +286,16 @@ const std::string& Asset::getAssetSubtype() const
     return m_assetSubtype;
 }
 
+const Symbol& Asset::getAssetTypeSymbol() const
+{
+    return m_assetType;
+}
+
+const Symbol& Asset::getAssetSubtypeSymbol() const
+{
+    return m_assetSubtype;
+}
+
 const std::string& Asset::getParentIname() const
 {
     return m_parentIname;
@@ -298,9 +311,20 @@ const std::string& Asset::getAssetTag() const
     return m_assetTag;
 }
 
-const Asset::ExtMap& Asset::getExt() const
+Asset::ExtMap Asset::getExt() const
 {
-    return m_ext;
+    ExtMap map;
+    for (const auto& e : m_ext) {
+        map.emplace_hint(map.end(), e.first, e.second);
+    }
+    return map;
+}
+
+void Asset::forEachExt(const std::function<void(const std::string& key, const ExtMapElement& element)>& fn) const
+{
+    for (const auto& e : m_ext) {
+        fn(e.first, e.second);
+    }
 }
 
 const std::string& Asset::getSecondaryID() const
@@ -308,11 +332,36 @@ const std::string& Asset::getSecondaryID() const
     return m_secondaryID;
 }
 
+Asset::ExtKey::ExtKey(const std::string& key)
+{
+    if (auto symbol = Symbol::tryIntern(key)) {
+        m_symbol = *symbol;
+    } else {
+        m_owned = std::make_shared<const std::string>(key);
+    }
+}
+
+// ext attributes are sorted by key, keys are compared as strings so that lookups do not intern them
+template <typename Entries>
+static auto lowerBoundExt(Entries& ext, const std::string& key)
+{
+    return std::lower_bound(ext.begin(), ext.end(), key, [](const auto& e, const std::string& k) {
+        return e.first.str() < k;
+    });
+}
+
+template <typename Entries>
+static auto findExt(Entries& ext, const std::string& key)
+{
+    auto it = lowerBoundExt(ext, key);
+    return (it != ext.end() && it->first.str() == key) ? it : ext.end();
+}
+
 const std::string& Asset::getExtEntry(const std::string& key) const
 {
     static const std::string extNotFound;
 
-    auto search = m_ext.find(key);
+    auto search = findExt(m_ext, key);
 
     if (search != m_ext.end()) {
         return search->second.getValue();
@@ -323,7 +372,7 @@ const std::string& Asset::getExtEntry(const std::string& key) const
 
 bool Asset::isExtEntryReadOnly(const std::string& key) const
 {
-    auto search = m_ext.find(key);
+    auto search = findExt(m_ext, key);
 
     if (search != m_ext.end()) {
         return search->second.isReadOnly();
@@ -368,62 +417,232 @@ const std::vector<Asset>& Asset::getParentsList() const
     return m_parentsList.value();
 }
 
+// fingerprint
+
+// every field hash is seeded with its own tag, so that equal values in different fields do not cancel out
+enum FingerprintField : uint64_t
+{
+    FP_NAME = 1,
+    FP_STATUS,
+    FP_TYPE,
+    FP_SUB_TYPE,
+    FP_PARENT,
+    FP_PRIORITY,
+    FP_TAG,
+    FP_EXT,
+    FP_LINKS
+};
+
+// splitmix64 finalizer
+static uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// FNV-1a
+static uint64_t hashBytes(std::string_view str, uint64_t seed)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ mixHash(seed);
+    for (unsigned char c : str) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static uint64_t hashField(FingerprintField field, std::string_view value)
+{
+    return mixHash(hashBytes(value, field));
+}
+
+static uint64_t hashField(FingerprintField field, int64_t value)
+{
+    return mixHash(mixHash(field) ^ uint64_t(value));
+}
+
+// ext attributes are a set: entries are hashed on their own, independently of their position
+static uint64_t hashExtEntry(std::string_view key, const ExtMapElement& element)
+{
+    uint64_t h = hashBytes(element.getValue(), hashBytes(key, FP_EXT));
+    return mixHash(element.isReadOnly() ? ~h : h);
+}
+
+// links are an ordered list, with the fields compared by AssetLink equality
+static uint64_t hashLinks(const std::vector<AssetLink>& links)
+{
+    uint64_t h = mixHash(FP_LINKS);
+    for (const auto& l : links) {
+        h = hashBytes(l.sourceId(), h);
+        h = hashBytes(l.srcOut(), h);
+        h = hashBytes(l.destIn(), h);
+        h = mixHash(h ^ uint64_t(l.linkType()));
+    }
+    return h;
+}
+
+uint64_t Asset::fingerprint() const
+{
+    if (m_fingerprint.valid.load(std::memory_order_acquire)) {
+        return m_fingerprint.value.load(std::memory_order_relaxed);
+    }
+
+    uint64_t fp = hashField(FP_NAME, m_internalName) ^ hashField(FP_STATUS, int64_t(m_assetStatus)) ^
+                  hashField(FP_TYPE, m_assetType.str()) ^ hashField(FP_SUB_TYPE, m_assetSubtype.str()) ^
+                  hashField(FP_PARENT, m_parentIname) ^ hashField(FP_PRIORITY, m_priority) ^
+                  hashField(FP_TAG, m_assetTag) ^ hashLinks(m_linkedAssets);
+    for (const auto& e : m_ext) {
+        fp ^= hashExtEntry(e.first.str(), e.second);
+    }
+
+    // const readers may compute it concurrently, they all store the same value
+    m_fingerprint.value.store(fp, std::memory_order_relaxed);
+    m_fingerprint.valid.store(true, std::memory_order_release);
+    return fp;
+}
+
+void Asset::changeFingerprint(uint64_t removed, uint64_t added)
+{
+    m_fingerprint.value.store(m_fingerprint.value.load(std::memory_order_relaxed) ^ removed ^ added,
+        std::memory_order_relaxed);
+}
+
+void Asset::invalidateFingerprint()
+{
+    m_fingerprint.valid.store(false, std::memory_order_relaxed);
+}
+
 // setters
 
 void Asset::setInternalName(const std::string& internalName)
 {
-    m_internalName = internalName;
+    setInternalName(std::string(internalName));
+}
+
+void Asset::setInternalName(std::string&& internalName)
+{
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_NAME, m_internalName), hashField(FP_NAME, internalName));
+    }
+    m_internalName = std::move(internalName);
 }
 
 void Asset::setAssetStatus(AssetStatus assetStatus)
 {
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_STATUS, int64_t(m_assetStatus)), hashField(FP_STATUS, int64_t(assetStatus)));
+    }
     m_assetStatus = assetStatus;
 }
 
 void Asset::setAssetType(const std::string& assetType)
 {
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_TYPE, m_assetType.str()), hashField(FP_TYPE, assetType));
+    }
     m_assetType = assetType;
 }
 
 void Asset::setAssetSubtype(const std::string& assetSubtype)
 {
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_SUB_TYPE, m_assetSubtype.str()), hashField(FP_SUB_TYPE, assetSubtype));
+    }
     m_assetSubtype = assetSubtype;
 }
 
 void Asset::setParentIname(const std::string& parentIname)
 {
-    m_parentIname = parentIname;
+    setParentIname(std::string(parentIname));
+}
+
+void Asset::setParentIname(std::string&& parentIname)
+{
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_PARENT, m_parentIname), hashField(FP_PARENT, parentIname));
+    }
+    m_parentIname = std::move(parentIname);
 }
 
 void Asset::setPriority(int priority)
 {
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_PRIORITY, m_priority), hashField(FP_PRIORITY, priority));
+    }
     m_priority = priority;
 }
 
 void Asset::setAssetTag(const std::string& assetTag)
 {
-    m_assetTag = assetTag;
+    setAssetTag(std::string(assetTag));
+}
+
+void Asset::setAssetTag(std::string&& assetTag)
+{
+    if (m_fingerprint.valid) {
+        changeFingerprint(hashField(FP_TAG, m_assetTag), hashField(FP_TAG, assetTag));
+    }
+    m_assetTag = std::move(assetTag);
 }
 
 void Asset::setExtMap(const ExtMap& map)
 {
-    m_ext = map;
+    m_ext.clear();
+    m_ext.reserve(map.size());
+    for (const auto& e : map) {
+        m_ext.emplace_back(e.first, e.second);
+    }
+    m_extIndex.reset();
+    invalidateFingerprint();
 }
 
 void Asset::clearExtMap()
 {
     m_ext.clear();
+    m_extIndex.reset();
+    invalidateFingerprint();
 }
 
 void Asset::setExtEntry(const std::string& key, const std::string& value, bool readOnly, bool forceUpdatedFalse)
 {
-    if (m_ext.find(key) != m_ext.end()) {
+    auto found = lowerBoundExt(m_ext, key);
+    if (found != m_ext.end() && found->first.str() == key) {
         // key already exists, update values
-        m_ext.at(key).setValue(value);
-        m_ext.at(key).setReadOnly(readOnly);
+        uint64_t removed = m_fingerprint.valid ? hashExtEntry(key, found->second) : 0;
+        found->second.setValue(value);
+        found->second.setReadOnly(readOnly);
+        if (m_fingerprint.valid) {
+            changeFingerprint(removed, hashExtEntry(key, found->second));
+        }
+    } else {
+        found = m_ext.emplace(found, key, ExtMapElement(value, readOnly, forceUpdatedFalse));
+        // positions of the following keys changed
+        m_extIndex.reset();
+        if (m_fingerprint.valid) {
+            changeFingerprint(0, hashExtEntry(key, found->second));
+        }
+    }
+}
+
+void Asset::setExtElement(const std::string& key, ExtMapElement&& element)
+{
+    auto found = lowerBoundExt(m_ext, key);
+    if (found != m_ext.end() && found->first.str() == key) {
+        uint64_t removed = m_fingerprint.valid ? hashExtEntry(key, found->second) : 0;
+        found->second    = std::move(element);
+        if (m_fingerprint.valid) {
+            changeFingerprint(removed, hashExtEntry(key, found->second));
+        }
     } else {
-        ExtMapElement element(value, readOnly, forceUpdatedFalse);
-        m_ext[key] = element;
+        found = m_ext.emplace(found, key, std::move(element));
+        m_extIndex.reset();
+        if (m_fingerprint.valid) {
+            changeFingerprint(0, hashExtEntry(key, found->second));
+        }
     }
 }
 
@@ -434,6 +653,7 @@ void Asset::addLink(
     l.setExt(attributes);
 
     m_linkedAssets.push_back(l);
+    invalidateFingerprint();
 }
 
 void Asset::removeLink(const std::string& sourceId, const std::string& scrOut, const std::string& destIn, int linkType)
@@ -443,17 +663,153 @@ void Asset::removeLink(const std::string& sourceId, const std::string& scrOut, c
 
     if (found != m_linkedAssets.end()) {
         m_linkedAssets.erase(found);
+        invalidateFingerprint();
     }
 }
 
 void Asset::setLinkedAssets(const std::vector<AssetLink>& assets)
 {
-    m_linkedAssets = assets;
+    setLinkedAssets(std::vector<AssetLink>(assets));
+}
+
+void Asset::setLinkedAssets(std::vector<AssetLink>&& assets)
+{
+    m_linkedAssets = std::move(assets);
+    invalidateFingerprint();
+}
+
+void Asset::setParentsList(const std::vector<Asset>& parents)
+{
+    m_parentsList = parents;
+}
+
+void Asset::setParentsList(std::vector<Asset>&& parents)
+{
+    m_parentsList = std::move(parents);
 }
 
 void Asset::setSecondaryID(const std::string& secondaryID)
 {
-    m_secondaryID = secondaryID;
+    setSecondaryID(std::string(secondaryID));
+}
+
+void Asset::setSecondaryID(std::string&& secondaryID)
+{
+    m_secondaryID = std::move(secondaryID);
+}
+
+// index of ip.<N> and endpoint.<N>.<field> attributes
+struct Asset::ExtIndex
+{
+    struct Endpoint
+    {
+        int32_t protocol     = -1;
+        int32_t port         = -1;
+        int32_t subAddress   = -1;
+        int32_t operating    = -1;
+        int32_t errorMessage = -1;
+        // other fields, views on interned keys
+        std::vector<std::pair<std::string_view, int32_t>> fields;
+    };
+
+    // position in ext map by address/endpoint index, -1 if not set
+    std::vector<int32_t>  addresses;
+    std::vector<Endpoint> endpoints;
+};
+
+// parse "<N>" (as written by std::to_string, 0..255) at the beginning of str, followed by end or '.'
+static bool parseExtIndex(std::string_view str, size_t& index, size_t& length)
+{
+    length = 0;
+    index  = 0;
+    while (length < str.size() && str[length] >= '0' && str[length] <= '9') {
+        index = index * 10 + size_t(str[length] - '0');
+        if (++length > 3) {
+            return false;
+        }
+    }
+    if (length == 0 || index > 255 || (length > 1 && str[0] == '0')) {
+        return false;
+    }
+    return length == str.size() || str[length] == '.';
+}
+
+// position of a known endpoint field, nullptr for other fields
+template <typename Endpoint>
+static auto endpointField(Endpoint& endpoint, std::string_view field) -> decltype(&endpoint.protocol)
+{
+    if (field == "protocol") {
+        return &endpoint.protocol;
+    } else if (field == "port") {
+        return &endpoint.port;
+    } else if (field == "sub_address") {
+        return &endpoint.subAddress;
+    } else if (field == "status.operating") {
+        return &endpoint.operating;
+    } else if (field == "status.error_msg") {
+        return &endpoint.errorMessage;
+    }
+    return nullptr;
+}
+
+const Asset::ExtIndex& Asset::extIndex() const
+{
+    // const readers may build it concurrently, the first one stored wins and the others use it
+    if (auto index = std::atomic_load(&m_extIndex)) {
+        return *index;
+    }
+
+    static constexpr std::string_view IP       = "ip.";
+    static constexpr std::string_view ENDPOINT = "endpoint.";
+
+    auto   index = std::make_shared<ExtIndex>();
+    size_t num   = 0;
+    size_t len   = 0;
+
+    int32_t pos = 0;
+    for (auto it = m_ext.begin(); it != m_ext.end(); ++it, ++pos) {
+        std::string_view key = it->first.str();
+
+        if (key.compare(0, IP.size(), IP) == 0) {
+            std::string_view rest = key.substr(IP.size());
+            if (parseExtIndex(rest, num, len) && len == rest.size()) {
+                if (index->addresses.size() <= num) {
+                    index->addresses.resize(num + 1, -1);
+                }
+                index->addresses[num] = pos;
+            }
+        } else if (key.compare(0, ENDPOINT.size(), ENDPOINT) == 0) {
+            std::string_view rest = key.substr(ENDPOINT.size());
+            if (parseExtIndex(rest, num, len) && len + 1 < rest.size()) {
+                if (index->endpoints.size() <= num) {
+                    index->endpoints.resize(num + 1);
+                }
+                auto&            endpoint = index->endpoints[num];
+                std::string_view field    = rest.substr(len + 1);
+                if (int32_t* known = endpointField(endpoint, field)) {
+                    *known = pos;
+                } else {
+                    endpoint.fields.emplace_back(field, pos);
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<const ExtIndex> stored;
+    if (!std::atomic_compare_exchange_strong(&m_extIndex, &stored, std::shared_ptr<const ExtIndex>(index))) {
+        return *stored;
+    }
+    return *index;
+}
+
+const std::string& Asset::extValueAt(int32_t pos) const
+{
+    static const std::string extNotFound;
+
+    if (pos < 0) {
+        return extNotFound;
+    }
+    return (m_ext.begin() + pos)->second.getValue();
 }
 
 // wrapper for address
@@ -461,11 +817,27 @@ Asset::AddressMap Asset::getAddressMap() const
 {
     Asset::AddressMap addresses;
 
-    for (uint16_t index = 0; index <= 255; index++) {
-        const std::string& address = getAddress(static_cast<uint8_t>(index));
+    const auto& index = extIndex().addresses;
+    for (size_t i = 0; i < index.size(); i++) {
+        const std::string& address = extValueAt(index[i]);
 
         if (!address.empty()) {
-            addresses[static_cast<uint8_t>(index)] = address;
+            addresses[static_cast<uint8_t>(i)] = address;
+        }
+    }
+
+    return addresses;
+}
+
+std::vector<std::string> Asset::getAddresses() const
+{
+    std::vector<std::string> addresses;
+
+    for (int32_t pos : extIndex().addresses) {
+        const std::string& address = extValueAt(pos);
+
+        if (!address.empty()) {
+            addresses.push_back(address);
         }
     }
 
@@ -474,7 +846,8 @@ Asset::AddressMap Asset::getAddressMap() const
 
 const std::string& Asset::getAddress(uint8_t index) const
 {
-    return getExtEntry("ip." + std::to_string(index));
+    const auto& addresses = extIndex().addresses;
+    return extValueAt(index < addresses.size() ? addresses[index] : -1);
 }
 
 void Asset::setAddress(uint8_t index, const std::string& address)
@@ -492,11 +865,12 @@ Asset::ProtocolMap Asset::getProtocolMap() const
 {
     Asset::ProtocolMap protocols;
 
-    for (uint16_t index = 0; index <= 255; index++) {
-        const std::string& protocol = getEndpointProtocol(static_cast<uint8_t>(index));
+    const auto& endpoints = extIndex().endpoints;
+    for (size_t i = 0; i < endpoints.size(); i++) {
+        const std::string& protocol = extValueAt(endpoints[i].protocol);
 
         if (!protocol.empty()) {
-            protocols[static_cast<uint8_t>(index)] = protocol;
+            protocols[static_cast<uint8_t>(i)] = protocol;
         }
     }
 
@@ -528,12 +902,26 @@ const std::string& Asset::getEndpointProtocolAttribute(uint8_t index, const std:
 {
     static std::string noProtocol;
 
-    std::string protocol = getEndpointProtocol(index);
+    const std::string& protocol = getEndpointProtocol(index);
     if (protocol.empty()) {
         return noProtocol;
     }
 
-    return getEndpointData(index, "." + protocol + "." + attributeName);
+    // field is ".<protocol>.<attributeName>"
+    const auto& endpoints = extIndex().endpoints;
+    if (index >= endpoints.size()) {
+        return noProtocol;
+    }
+    for (const auto& field : endpoints[index].fields) {
+        std::string_view name = field.first;
+        if (name.size() == protocol.size() + attributeName.size() + 2 && name[0] == '.' &&
+            name.compare(1, protocol.size(), protocol) == 0 && name[protocol.size() + 1] == '.' &&
+            name.compare(protocol.size() + 2, std::string_view::npos, attributeName) == 0) {
+            return extValueAt(field.second);
+        }
+    }
+
+    return noProtocol;
 }
 
 void Asset::setEndpointProtocol(uint8_t index, const std::string& val)
@@ -578,7 +966,21 @@ void Asset::removeEndpoint(uint8_t index)
 
 const std::string& Asset::getEndpointData(uint8_t index, const std::string& field) const
 {
-    return getExtEntry("endpoint." + std::to_string(index) + "." + field);
+    const auto& endpoints = extIndex().endpoints;
+    if (index >= endpoints.size()) {
+        return extValueAt(-1);
+    }
+
+    if (const int32_t* known = endpointField(endpoints[index], field)) {
+        return extValueAt(*known);
+    }
+    for (const auto& it : endpoints[index].fields) {
+        if (it.first == field) {
+            return extValueAt(it.second);
+        }
+    }
+
+    return extValueAt(-1);
 }
 
 void Asset::setEndpointData(uint8_t index, const std::string& field, const std::string& val)
@@ -610,7 +1012,7 @@ void Asset::dump(std::ostream& os)
     os << "ext attrib  : " << m_secondaryID << std::endl;
 
     for (const auto& e : m_ext) {
-        os << "- key: " << e.first << " - value: " << e.second.getValue() << (e.second.isReadOnly() ? " [ReadOny]" : "")
+        os << "- key: " << e.first.str() << " - value: " << e.second.getValue() << (e.second.isReadOnly() ? " [ReadOny]" : "")
            << (e.second.wasUpdated() ? " [Updated]" : "") << std::endl;
     }
 
@@ -634,6 +1036,10 @@ void Asset::dump(std::ostream& os)
 
 bool Asset::operator==(const Asset& asset) const
 {
+    // different fingerprints: fields differ, same fingerprints: compare fields (collisions)
+    if (fingerprint() != asset.fingerprint()) {
+        return false;
+    }
     return (
         m_internalName == asset.m_internalName && m_assetStatus == asset.m_assetStatus && m_assetType == asset.m_assetType &&
         m_assetSubtype == asset.m_assetSubtype && m_parentIname == asset.m_parentIname && m_priority == asset.m_priority &&
@@ -659,8 +1065,8 @@ static constexpr const char* SI_PARENTS_LIST = "parents_list";
 void Asset::serialize(cxxtools::SerializationInfo& si) const
 {
     si.addMember(SI_STATUS) <<= int(m_assetStatus);
-    si.addMember(SI_TYPE) <<= m_assetType;
-    si.addMember(SI_SUB_TYPE) <<= m_assetSubtype;
+    si.addMember(SI_TYPE) <<= m_assetType.str();
+    si.addMember(SI_SUB_TYPE) <<= m_assetSubtype.str();
     si.addMember(SI_NAME) <<= m_internalName;
     si.addMember(SI_PRIORITY) <<= m_priority;
     si.addMember(SI_PARENT) <<= m_parentIname;
@@ -701,13 +1107,16 @@ void Asset::serialize(cxxtools::SerializationInfo& si) const
 
 void Asset::deserialize(const cxxtools::SerializationInfo& si)
 {
-    int tmpInt = 0;
+    int         tmpInt = 0;
+    std::string tmpString;
 
     si.getMember(SI_STATUS) >>= tmpInt;
     m_assetStatus = AssetStatus(tmpInt);
 
-    si.getMember(SI_TYPE) >>= m_assetType;
-    si.getMember(SI_SUB_TYPE) >>= m_assetSubtype;
+    si.getMember(SI_TYPE) >>= tmpString;
+    m_assetType = tmpString;
+    si.getMember(SI_SUB_TYPE) >>= tmpString;
+    m_assetSubtype = tmpString;
     si.getMember(SI_NAME) >>= m_internalName;
     si.getMember(SI_PRIORITY) >>= m_priority;
     si.getMember(SI_PARENT) >>= m_parentIname;
@@ -722,13 +1131,12 @@ void Asset::deserialize(const cxxtools::SerializationInfo& si)
     }
 
     // ext map
-    m_ext.clear();
+    clearExtMap();
     const cxxtools::SerializationInfo ext = si.getMember(SI_EXT);
     for (const auto& siExt : ext) {
-        std::string   key = siExt.name();
         ExtMapElement element;
         siExt >>= element;
-        m_ext[key] = element;
+        setExtElement(siExt.name(), std::move(element));
     }
 
     if (si.findMember(SI_SECONDARY_ID) != NULL) {
@@ -747,6 +1155,16 @@ void Asset::fromJson(const std::string& json, Asset& a)
     conversion::fromJson(json, a);
 }
 
+void Asset::fromBinary(const std::string& data, Asset& a)
+{
+    conversion::fromBinary(data, a);
+}
+
+void Asset::fromBinary(const std::string& data, std::vector<Asset>& list)
+{
+    conversion::fromBinary(data, list);
+}
+
 void Asset::fromFtyProto(fty_proto_t* p, Asset& a, bool extAttributeReadOnly, bool test)
 {
     conversion::fromFtyProto(p, a, extAttributeReadOnly, test);
@@ -762,11 +1180,26 @@ std::string Asset::toJson(const Asset& a)
     return conversion::toJson(a);
 }
 
+std::string Asset::toBinary(const Asset& a)
+{
+    return conversion::toBinary(a);
+}
+
+std::string Asset::toBinary(const std::vector<Asset>& list)
+{
+    return conversion::toBinary(list);
+}
+
 fty_proto_t* Asset::toFtyProto(const Asset& a, const std::string& op, bool test)
 {
     return conversion::toFtyProto(a, op, test);
 }
 
+std::vector<fty_proto_t*> Asset::toFtyProto(const std::vector<Asset>& assets, const std::string& op, bool test)
+{
+    return conversion::toFtyProto(assets, op, test);
+}
+
 
 void operator<<=(cxxtools::SerializationInfo& si, const fty::Asset& asset)
 {
@@ -795,13 +1228,12 @@ ExtMapElement::ExtMapElement(const ExtMapElement& element)
     m_wasUpdated = element.m_wasUpdated;
 }
 
-ExtMapElement::ExtMapElement(ExtMapElement&& element)
+ExtMapElement::ExtMapElement(ExtMapElement&& element) noexcept
+    : m_value(std::move(element.m_value))
+    , m_readOnly(element.m_readOnly)
+    , m_wasUpdated(element.m_wasUpdated)
 {
-    m_value      = element.m_value;
-    m_readOnly   = element.m_readOnly;
-    m_wasUpdated = element.m_wasUpdated;
-
-    element.m_value      = std::string();
+    element.m_value.clear();
     element.m_readOnly   = false;
     element.m_wasUpdated = false;
 }
@@ -814,9 +1246,9 @@ ExtMapElement& ExtMapElement::operator=(const ExtMapElement& element)
     return *this;
 }
 
-ExtMapElement& ExtMapElement::operator=(ExtMapElement&& element)
+ExtMapElement& ExtMapElement::operator=(ExtMapElement&& element) noexcept
 {
-    m_value      = element.m_value;
+    m_value      = std::move(element.m_value);
     m_readOnly   = element.m_readOnly;
     m_wasUpdated = element.m_wasUpdated;
     return *this;
@@ -849,6 +1281,11 @@ void ExtMapElement::setReadOnly(bool readOnly)
     m_readOnly = readOnly;
 }
 
+void ExtMapElement::setUpdated(bool updated)
+{
+    m_wasUpdated = updated;
+}
+
 bool ExtMapElement::operator==(const ExtMapElement& element) const
 {
     return (m_value == element.m_value && m_readOnly == element.m_readOnly);
@@ -913,8 +1350,8 @@ void UIAsset::serializeUI(cxxtools::SerializationInfo& si) const
 
     si.addMember(UI_ASSET_FRIENDLY_NAME) <<= getFriendlyName();
 
-    si.addMember(UI_TYPE) <<= m_assetType;
-    si.addMember(UI_SUBTYPE) <<= m_assetSubtype;
+    si.addMember(UI_TYPE) <<= m_assetType.str();
+    si.addMember(UI_SUBTYPE) <<= m_assetSubtype.str();
 
     si.addMember(UI_PRIORITY) <<= "P" + std::to_string(m_priority);
 
@@ -0,0 +1,177 @@
+/*  =========================================================================
+    fty_asset_id_resolver - Cached resolution of asset internal names to ids
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_asset_id_resolver.h"
+#include <algorithm>
+#include <fty_common_db_dbpath.h>
+#include <tntdb.h>
+
+namespace fty {
+
+// names per query, keeps the statement (and its prepared cache entry) small
+static constexpr size_t LOOKUP_CHUNK = 128;
+
+static std::map<std::string, int64_t> lookupDatabase(const std::vector<std::string>& inames)
+{
+    std::map<std::string, int64_t> ids;
+
+    tntdb::Connection conn = tntdb::connectCached(DBConn::url);
+
+    for (size_t start = 0; start < inames.size(); start += LOOKUP_CHUNK) {
+        size_t count = std::min(LOOKUP_CHUNK, inames.size() - start);
+
+        std::string sql = "SELECT name, id_asset_element FROM t_bios_asset_element WHERE name IN (";
+        for (size_t i = 0; i < count; ++i) {
+            sql += (i ? ", :n" : ":n") + std::to_string(i);
+        }
+        sql += ")";
+
+        auto q = conn.prepareCached(sql);
+        for (size_t i = 0; i < count; ++i) {
+            q.set("n" + std::to_string(i), inames[start + i]);
+        }
+
+        for (const auto& row : q.select()) {
+            ids.emplace(row.getString("name"), row.getInt64("id_asset_element"));
+        }
+    }
+
+    return ids;
+}
+
+AssetIdResolver& AssetIdResolver::instance()
+{
+    static AssetIdResolver resolver(&lookupDatabase);
+    return resolver;
+}
+
+AssetIdResolver::AssetIdResolver(Lookup lookup, size_t capacity)
+    : m_lookup(std::move(lookup))
+    , m_capacity(capacity ? capacity : 1)
+{
+}
+
+int64_t AssetIdResolver::resolve(const std::string& iname)
+{
+    auto ids = resolve(std::vector<std::string>{iname});
+
+    auto found = ids.find(iname);
+    return found != ids.end() ? found->second : -1;
+}
+
+std::map<std::string, int64_t> AssetIdResolver::resolve(const std::vector<std::string>& inames)
+{
+    std::map<std::string, int64_t> ids;
+    std::vector<std::string>       missing;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& iname : inames) {
+            int64_t id;
+            if (ids.count(iname)) {
+                continue;
+            }
+            if (find(iname, id)) {
+                ++m_stats.hits;
+                ids.emplace(iname, id);
+            } else if (std::find(missing.begin(), missing.end(), iname) == missing.end()) {
+                ++m_stats.misses;
+                missing.push_back(iname);
+            }
+        }
+        if (missing.empty()) {
+            return ids;
+        }
+        ++m_stats.lookups;
+    }
+
+    // lookup without the lock, resolver is shared by all threads
+    auto found = m_lookup(missing);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& it : found) {
+        store(it.first, it.second);
+        ids.emplace(it.first, it.second);
+    }
+
+    return ids;
+}
+
+void AssetIdResolver::invalidate(const std::string& iname)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_index.find(iname);
+    if (found != m_index.end()) {
+        m_entries.erase(found->second);
+        m_index.erase(found);
+    }
+}
+
+void AssetIdResolver::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+}
+
+size_t AssetIdResolver::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+AssetIdResolver::Stats AssetIdResolver::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+bool AssetIdResolver::find(const std::string& iname, int64_t& id)
+{
+    auto found = m_index.find(iname);
+    if (found == m_index.end()) {
+        return false;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    id = found->second->second;
+    return true;
+}
+
+void AssetIdResolver::store(const std::string& iname, int64_t id)
+{
+    auto found = m_index.find(iname);
+    if (found != m_index.end()) {
+        found->second->second = id;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return;
+    }
+
+    m_entries.emplace_front(iname, id);
+    m_index.emplace(iname, m_entries.begin());
+
+    if (m_index.size() > m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
+
+} // namespace fty
@@ -0,0 +1,130 @@
+/*  =========================================================================
+    fty_asset_symbol - Process-wide interned strings
+
+    Copyright (C) 2016 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_asset_symbol.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace fty {
+
+namespace {
+
+    class SymbolTable
+    {
+    public:
+        SymbolTable()
+        {
+            intern(std::string_view());
+        }
+
+        /// nullptr if str is a new value and the table already holds limit symbols
+        const Symbol::Entry* intern(std::string_view str, size_t limit = SIZE_MAX)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto found = m_index.find(str);
+            if (found != m_index.end()) {
+                return found->second;
+            }
+            if (m_entries.size() >= limit) {
+                return nullptr;
+            }
+
+            // deque: entries never move, views on them stay valid
+            m_entries.push_back({std::string(str), uint32_t(m_entries.size())});
+            const Symbol::Entry* entry = &m_entries.back();
+            m_index.emplace(entry->str, entry);
+            return entry;
+        }
+
+        size_t count()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_entries.size();
+        }
+
+    private:
+        std::mutex                                                   m_mutex;
+        std::deque<Symbol::Entry>                                    m_entries;
+        std::unordered_map<std::string_view, const Symbol::Entry*> m_index;
+    };
+
+    SymbolTable& table()
+    {
+        // never destroyed: symbols may be held by static objects
+        static auto* symbols = new SymbolTable();
+        return *symbols;
+    }
+
+    const Symbol::Entry* intern(std::string_view str, size_t limit = SIZE_MAX)
+    {
+        // the set of symbols is small, a per thread cache avoids the table lock on hot paths (DB loaders)
+        // only symbols are cached, so it is bounded as the table is
+        thread_local std::unordered_map<std::string_view, const Symbol::Entry*> cache;
+
+        auto found = cache.find(str);
+        if (found != cache.end()) {
+            return found->second;
+        }
+
+        const Symbol::Entry* entry = table().intern(str, limit);
+        if (entry) {
+            cache.emplace(entry->str, entry);
+        }
+        return entry;
+    }
+
+} // namespace
+
+Symbol::Symbol()
+    : m_entry(intern(std::string_view()))
+{
+}
+
+Symbol::Symbol(const std::string& str)
+    : m_entry(intern(str))
+{
+}
+
+Symbol::Symbol(const char* str)
+    : m_entry(intern(str ? std::string_view(str) : std::string_view()))
+{
+}
+
+size_t Symbol::count()
+{
+    return table().count();
+}
+
+constexpr size_t Symbol::TRY_INTERN_LIMIT;
+
+std::optional<Symbol> Symbol::tryIntern(const std::string& str)
+{
+    if (const Entry* entry = intern(str, TRY_INTERN_LIMIT)) {
+        return Symbol(entry);
+    }
+    return std::nullopt;
+}
+
+} // namespace fty
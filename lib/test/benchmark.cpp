@@ -0,0 +1,274 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+// Hidden benchmarks, not run by default: fty-asset-test "[benchmark]"
+// Behaviour is covered by the regular tests, these only print figures to compare implementations.
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include "heap.h"
+#include <chrono>
+#include <cstdio>
+#include <cxxtools/jsondeserializer.h>
+#include <cxxtools/jsonserializer.h>
+#include <map>
+#include <sstream>
+
+using namespace fty;
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// typical device attributes: endpoints, addresses and inventory
+static std::vector<std::string> deviceKeys()
+{
+    std::vector<std::string> keys;
+    for (int ep = 1; ep <= 4; ++ep) {
+        for (const char* field : {"protocol", "port", "sub_address", "status.operating", "status.error_msg",
+                 "nut_snmp.secw_credential_id", "nut_powercom.secw_credential_id"}) {
+            keys.push_back("endpoint." + std::to_string(ep) + "." + field);
+        }
+    }
+    for (int ip = 1; ip <= 8; ++ip) {
+        keys.push_back("ip." + std::to_string(ip));
+    }
+    for (const char* key : {"name", "uuid", "create_ts", "update_ts", "model", "manufacturer", "serial_no",
+             "firmware", "device.contact", "device.location", "device.description", "max_power",
+             "phases.output", "phases.input", "battery.type", "battery.date", "installation_date",
+             "maintenance_date", "warranty_end_date", "u_size"}) {
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+// asset as sent on the bus: identification, a few endpoint attributes and links
+static Asset busAsset(int i)
+{
+    Asset asset;
+    asset.setInternalName("ups-" + std::to_string(i));
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_UPS);
+    asset.setParentIname("rack-1");
+    asset.setPriority(2);
+    asset.setSecondaryID("secondary");
+    asset.setFriendlyName("UPS \"main\" room " + std::to_string(i));
+    asset.setAddress(1, "10.0.0." + std::to_string(i % 250));
+    asset.setEndpointProtocol(1, "nut_snmp");
+    asset.setEndpointPort(1, "161");
+    asset.setEndpointProtocolAttribute(1, "secw_credential_id", "cred-1");
+    asset.setExtEntry("model", "9PX", false, true);
+
+    AssetLink link("feed-1", "", "", 3);
+    link.setExtEntry("label", "A/B");
+    asset.setLinkedAssets({AssetLink("epdu-1", "1", "2", 1), link});
+    return asset;
+}
+
+static std::string cxxtoolsToJson(const Asset& asset)
+{
+    std::ostringstream          output;
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonSerializer    serializer(output);
+
+    si <<= asset;
+    serializer.serialize(si);
+    return output.str();
+}
+
+static Asset cxxtoolsFromJson(const std::string& json)
+{
+    std::istringstream          input(json);
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonDeserializer  deserializer(input);
+
+    deserializer.deserialize(si);
+
+    Asset asset;
+    si >>= asset;
+    return asset;
+}
+
+TEST_CASE("Benchmark - ext attributes memory and lookup", "[.][benchmark]")
+{
+    static constexpr size_t ASSETS = 10000;
+
+    const auto keys = deviceKeys();
+
+    long long                                         before = g_heapBytes;
+    std::vector<std::map<std::string, ExtMapElement>> maps(ASSETS);
+    for (size_t i = 0; i < ASSETS; ++i) {
+        for (const auto& key : keys) {
+            maps[i].emplace(key, ExtMapElement("value-" + std::to_string(i)));
+        }
+    }
+    long long mapBytes = g_heapBytes - before;
+
+    before = g_heapBytes;
+    std::vector<Asset> assets(ASSETS);
+    for (size_t i = 0; i < ASSETS; ++i) {
+        for (const auto& key : keys) {
+            assets[i].setExtEntry(key, "value-" + std::to_string(i));
+        }
+    }
+    long long assetBytes = g_heapBytes - before;
+
+    size_t mapFound = 0;
+    auto   start    = Clock::now();
+    for (const auto& map : maps) {
+        for (const auto& key : keys) {
+            mapFound += map.count(key);
+        }
+    }
+    double mapMs = elapsedMs(start);
+
+    size_t assetFound = 0;
+    start             = Clock::now();
+    for (const auto& asset : assets) {
+        for (const auto& key : keys) {
+            assetFound += asset.getExtEntry(key).empty() ? 0 : 1;
+        }
+    }
+    double assetMs = elapsedMs(start);
+
+    printf("%zu assets x %zu ext attributes\n", ASSETS, keys.size());
+    printf("  std::map  : %10lld bytes, lookup %8.2f ms\n", mapBytes, mapMs);
+    printf("  Asset ext : %10lld bytes, lookup %8.2f ms\n", assetBytes, assetMs);
+
+    REQUIRE(mapFound == assetFound);
+}
+
+TEST_CASE("Benchmark - asset comparison with fingerprints", "[.][benchmark]")
+{
+    static constexpr size_t ASSETS = 10000;
+
+    std::vector<Asset> before;
+    std::vector<Asset> after;
+    for (size_t i = 0; i < ASSETS; ++i) {
+        Asset a;
+        a.setInternalName("ups-" + std::to_string(i));
+        a.setAssetType(TYPE_DEVICE);
+        a.setAssetSubtype(SUB_UPS);
+        a.setParentIname("rack-1");
+        for (const auto& key : deviceKeys()) {
+            a.setExtEntry(key, "value");
+        }
+        before.push_back(a);
+        // change in the last ext attribute compared
+        a.setExtEntry("u_size", "2");
+        after.push_back(a);
+    }
+
+    auto   start   = Clock::now();
+    size_t changed = 0;
+    for (size_t i = 0; i < ASSETS; ++i) {
+        changed += before[i] != after[i];
+    }
+    double firstMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < ASSETS; ++i) {
+        changed += before[i] != after[i];
+    }
+    double cachedMs = elapsedMs(start);
+
+    printf("%zu asset comparisons\n", ASSETS);
+    printf("  first (fingerprints computed) : %8.2f ms\n", firstMs);
+    printf("  cached fingerprints           : %8.2f ms\n", cachedMs);
+
+    REQUIRE(changed == 2 * ASSETS);
+}
+
+TEST_CASE("Benchmark - JSON codec throughput", "[.][benchmark]")
+{
+    static constexpr int ASSETS = 5000;
+
+    std::vector<Asset> assets;
+    for (int i = 0; i < ASSETS; ++i) {
+        assets.push_back(busAsset(i));
+    }
+
+    std::vector<std::string> cxxtoolsJson;
+    std::vector<std::string> directJson;
+
+    auto start = Clock::now();
+    for (const auto& asset : assets) {
+        cxxtoolsJson.push_back(cxxtoolsToJson(asset));
+    }
+    double cxxtoolsWriteMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (const auto& asset : assets) {
+        directJson.push_back(Asset::toJson(asset));
+    }
+    double directWriteMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (const auto& json : cxxtoolsJson) {
+        cxxtoolsFromJson(json);
+    }
+    double cxxtoolsReadMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (const auto& json : directJson) {
+        Asset asset;
+        Asset::fromJson(json, asset);
+    }
+    double directReadMs = elapsedMs(start);
+
+    printf("%d assets, JSON\n", ASSETS);
+    printf("  cxxtools : write %8.2f ms, read %8.2f ms\n", cxxtoolsWriteMs, cxxtoolsReadMs);
+    printf("  direct   : write %8.2f ms, read %8.2f ms\n", directWriteMs, directReadMs);
+}
+
+TEST_CASE("Benchmark - binary codec throughput", "[.][benchmark]")
+{
+    static constexpr int ASSETS = 5000;
+
+    std::vector<Asset> assets;
+    for (int i = 0; i < ASSETS; ++i) {
+        assets.push_back(busAsset(i));
+    }
+
+    size_t jsonBytes = 0;
+    auto   start     = Clock::now();
+    for (const auto& asset : assets) {
+        std::string json = Asset::toJson(asset);
+        jsonBytes += json.size();
+        Asset decoded;
+        Asset::fromJson(json, decoded);
+    }
+    double jsonMs = elapsedMs(start);
+
+    size_t binaryBytes = 0;
+    start              = Clock::now();
+    for (const auto& asset : assets) {
+        std::string data = Asset::toBinary(asset);
+        binaryBytes += data.size();
+        Asset decoded;
+        Asset::fromBinary(data, decoded);
+    }
+    double binaryMs = elapsedMs(start);
+
+    printf("%d assets, encode + decode\n", ASSETS);
+    printf("  json     : %10zu bytes, %8.2f ms\n", jsonBytes, jsonMs);
+    printf("  protobuf : %10zu bytes, %8.2f ms\n", binaryBytes, binaryMs);
+}
@@ -0,0 +1,120 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+
+using namespace fty;
+
+static Asset binarySample(int i)
+{
+    Asset asset;
+    asset.setInternalName("epdu-" + std::to_string(i));
+    asset.setAssetStatus(AssetStatus::Nonactive);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_EPDU);
+    asset.setParentIname("rack-1");
+    asset.setPriority(1);
+    asset.setSecondaryID("secondary");
+    asset.setFriendlyName(std::string("ePDU\0 1", 7));
+    asset.setAddress(1, "10.0.0." + std::to_string(i % 250));
+    asset.setEndpointProtocol(1, "nut_snmp");
+    asset.setExtEntry("model", "G3", true, true);
+
+    AssetLink link("ups-1", "2", "", -1);
+    link.setExtEntry("label", "A");
+    asset.setLinkedAssets({link, AssetLink("feed-1", "", "", 1)});
+    return asset;
+}
+
+static void requireSameBinary(const Asset& l, const Asset& r)
+{
+    REQUIRE(l == r);
+    REQUIRE(l.getSecondaryID() == r.getSecondaryID());
+    REQUIRE(l.getLinkedAssets().size() == r.getLinkedAssets().size());
+    for (size_t i = 0; i < l.getLinkedAssets().size(); ++i) {
+        REQUIRE(l.getLinkedAssets()[i].ext() == r.getLinkedAssets()[i].ext());
+    }
+    for (const auto& e : l.getExt()) {
+        REQUIRE(e.second.wasUpdated() == r.getExt().at(e.first).wasUpdated());
+    }
+    REQUIRE(l.hasParentsList() == r.hasParentsList());
+}
+
+TEST_CASE("Binary codec - round trip")
+{
+    const Asset asset = binarySample(1);
+
+    Asset decoded;
+    Asset::fromBinary(Asset::toBinary(asset), decoded);
+    requireSameBinary(decoded, asset);
+    REQUIRE(decoded.getFriendlyName().size() == 7);
+    REQUIRE(decoded.getLinkedAssets()[0].linkType() == -1);
+
+    // same content as JSON, smaller
+    Asset fromJson;
+    Asset::fromJson(Asset::toJson(asset), fromJson);
+    requireSameBinary(fromJson, decoded);
+    REQUIRE(Asset::toBinary(asset).size() < Asset::toJson(asset).size());
+
+    // empty parents list is kept
+    Asset withParents;
+    Asset::fromJson(Asset::toJson(asset).substr(0, Asset::toJson(asset).size() - 1) + ",\"parents_list\":[]}",
+        withParents);
+    REQUIRE(withParents.hasParentsList());
+    Asset parentsDecoded;
+    Asset::fromBinary(Asset::toBinary(withParents), parentsDecoded);
+    REQUIRE(parentsDecoded.hasParentsList());
+    REQUIRE(parentsDecoded.getParentsList().empty());
+}
+
+TEST_CASE("Binary codec - asset list")
+{
+    std::vector<Asset> list{binarySample(1), binarySample(2), Asset()};
+
+    std::vector<Asset> decoded;
+    Asset::fromBinary(Asset::toBinary(list), decoded);
+
+    REQUIRE(decoded.size() == list.size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        requireSameBinary(decoded[i], list[i]);
+    }
+
+    decoded.clear();
+    Asset::fromBinary(Asset::toBinary(std::vector<Asset>()), decoded);
+    REQUIRE(decoded.empty());
+}
+
+TEST_CASE("Binary codec - reader")
+{
+    // unknown fields are skipped: varint 99, fixed32 100, fixed64 101, bytes 102
+    std::string data = Asset::toBinary(binarySample(1));
+    data += std::string("\x98\x06\x01", 3);
+    data += std::string("\xa5\x06\x01\x02\x03\x04", 6);
+    data += std::string("\xa9\x06\x01\x02\x03\x04\x05\x06\x07\x08", 10);
+    data += std::string("\xb2\x06\x02xy", 5);
+
+    Asset asset;
+    Asset::fromBinary(data, asset);
+    requireSameBinary(asset, binarySample(1));
+
+    // truncated input
+    std::string truncated = Asset::toBinary(binarySample(1));
+    truncated.pop_back();
+    REQUIRE_THROWS_AS(Asset::fromBinary(truncated, asset), std::runtime_error);
+    REQUIRE_THROWS_AS(Asset::fromBinary(std::string("\x12\x05" "ab", 4), asset), std::runtime_error);
+}
@@ -0,0 +1,140 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_delta.h"
+#include <cxxtools/serializationinfo.h>
+
+using namespace fty;
+
+static Asset device()
+{
+    Asset asset;
+    asset.setInternalName("ups-1");
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_UPS);
+    asset.setParentIname("rack-1");
+    asset.setPriority(3);
+    asset.setExtEntry("name", "ups");
+    asset.setExtEntry("model", "9PX", true);
+    asset.setAddress(1, "10.0.0.1");
+    return asset;
+}
+
+TEST_CASE("Asset delta - no change")
+{
+    Asset before = device();
+
+    AssetDelta delta = AssetDelta::diff(before, device(), 12);
+    REQUIRE(delta.empty());
+    REQUIRE(delta.name == "ups-1");
+    REQUIRE(delta.version == 12);
+}
+
+TEST_CASE("Asset delta - only changed fields")
+{
+    Asset before = device();
+    Asset after  = device();
+    after.setPriority(1);
+    after.setExtEntry("name", "ups renamed");
+    after.setExtEntry("model", "9PX", false);
+    after.setAddress(2, "10.0.0.2");
+    Asset::ExtMap ext = after.getExt();
+    ext.erase("ip.1");
+    after.setExtMap(std::move(ext));
+
+    AssetDelta delta = AssetDelta::diff(before, after, 13);
+    REQUIRE_FALSE(delta.empty());
+    REQUIRE(delta.priority == 1);
+    REQUIRE_FALSE(delta.status);
+    REQUIRE_FALSE(delta.type);
+    REQUIRE_FALSE(delta.parent);
+    REQUIRE_FALSE(delta.linked);
+    REQUIRE(delta.ext.size() == 3);
+    REQUIRE(delta.ext.at("name").getValue() == "ups renamed");
+    REQUIRE_FALSE(delta.ext.at("model").isReadOnly());
+    REQUIRE(delta.ext.at("ip.2").getValue() == "10.0.0.2");
+    REQUIRE(delta.extRemoved == std::vector<std::string>{"ip.1"});
+
+    Asset patched = device();
+    delta.apply(patched);
+    REQUIRE(patched == after);
+    REQUIRE(patched.getExt() == after.getExt());
+}
+
+TEST_CASE("Asset delta - links and parent")
+{
+    Asset before = device();
+    Asset after  = device();
+    after.setParentIname("rack-2");
+
+    AssetLink link;
+    link.setSourceId("epdu-1");
+    link.setSrcOut("1");
+    link.setDestIn("2");
+    link.setLinkType(1);
+    after.setLinkedAssets({link});
+
+    AssetDelta delta = AssetDelta::diff(before, after);
+    REQUIRE(delta.parent == std::string("rack-2"));
+    REQUIRE(delta.linked);
+    REQUIRE(delta.linked->size() == 1);
+    REQUIRE(delta.ext.empty());
+    REQUIRE(delta.extRemoved.empty());
+
+    Asset patched = device();
+    delta.apply(patched);
+    REQUIRE(patched.getParentIname() == "rack-2");
+    REQUIRE(patched.getLinkedAssets() == after.getLinkedAssets());
+}
+
+TEST_CASE("Asset delta - serialization")
+{
+    Asset before = device();
+    Asset after  = device();
+    after.setAssetStatus(AssetStatus::Nonactive);
+    after.setExtEntry("serial_no", "G123");
+    after.setExtMap([&after]() {
+        Asset::ExtMap ext = after.getExt();
+        ext.erase("name");
+        return ext;
+    }());
+
+    AssetDelta delta = AssetDelta::diff(before, after, 14);
+
+    cxxtools::SerializationInfo si;
+    si <<= delta;
+    // unchanged fields are not sent
+    REQUIRE(si.findMember("type") == nullptr);
+    REQUIRE(si.findMember("priority") == nullptr);
+    REQUIRE(si.findMember("linked") == nullptr);
+    REQUIRE(si.findMember("status") != nullptr);
+
+    AssetDelta received;
+    si >>= received;
+    REQUIRE(received.name == "ups-1");
+    REQUIRE(received.version == 14);
+    REQUIRE(received.status == AssetStatus::Nonactive);
+    REQUIRE_FALSE(received.priority);
+    REQUIRE(received.ext == delta.ext);
+    REQUIRE(received.extRemoved == std::vector<std::string>{"name"});
+
+    Asset patched = device();
+    received.apply(patched);
+    REQUIRE(patched == after);
+}
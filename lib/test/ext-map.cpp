@@ -0,0 +1,183 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include "heap.h"
+#include <map>
+#include <thread>
+
+using namespace fty;
+
+TEST_CASE("Asset ext map copy")
+{
+    Asset asset;
+    asset.setExtEntry("name", "ups");
+    asset.setExtEntry("ip.1", "10.0.0.1", true);
+    asset.setExtEntry("endpoint.1.protocol", "nut_snmp");
+
+    // std::map in key order
+    Asset::ExtMap ext = asset.getExt();
+    REQUIRE(ext.size() == 3);
+    REQUIRE(ext.at("ip.1").isReadOnly());
+
+    std::vector<std::string> keys;
+    asset.forEachExt([&](const std::string& key, const ExtMapElement&) {
+        keys.push_back(key);
+    });
+    REQUIRE(keys == std::vector<std::string>{"endpoint.1.protocol", "ip.1", "name"});
+
+    // a copy, the asset keeps no map of its own
+    asset.setExtEntry("name", "ups-2");
+    asset.setExtEntry("serial_no", "1234");
+    REQUIRE(ext.size() == 3);
+    REQUIRE(ext.at("name").getValue() == "ups");
+    REQUIRE(asset.getExt().size() == 4);
+    REQUIRE(asset.getExt().at("name").getValue() == "ups-2");
+
+    // still valid once the asset is assigned
+    Asset copy = asset;
+    copy.setExtEntry("name", "ups-3");
+    asset = copy;
+    REQUIRE(ext.at("name").getValue() == "ups");
+    REQUIRE(asset.getExt().at("name").getValue() == "ups-3");
+
+    asset.setExtMap({{"model", ExtMapElement("9PX")}});
+    REQUIRE(asset.getExt().size() == 1);
+    REQUIRE(asset.getModel() == "9PX");
+    REQUIRE(asset.getFriendlyName().empty());
+
+    asset.clearExtMap();
+    REQUIRE(asset.getExt().empty());
+}
+
+TEST_CASE("Asset ext lookups do not intern keys")
+{
+    Asset asset;
+    asset.setExtEntry("name", "ups");
+
+    size_t symbols = Symbol::count();
+    REQUIRE(asset.getExtEntry("ext-map-test-unknown-key").empty());
+    REQUIRE_FALSE(asset.isExtEntryReadOnly("ext-map-test-unknown-key-2"));
+    REQUIRE(Symbol::count() == symbols);
+}
+
+TEST_CASE("Asset ext storage heap usage")
+{
+    static constexpr size_t ASSETS = 100;
+
+    // keys already in the symbol table are shared, even once it is full
+    std::vector<std::string> keys;
+    for (int i = 0; i < 50; ++i) {
+        keys.push_back("attribute." + std::to_string(i));
+        Symbol(keys.back());
+    }
+
+    long long before = g_heapBytes;
+    std::vector<std::map<std::string, ExtMapElement>> maps(ASSETS);
+    for (auto& map : maps) {
+        for (const auto& key : keys) {
+            map.emplace(key, ExtMapElement("value"));
+        }
+    }
+    long long mapBytes = g_heapBytes - before;
+
+    before = g_heapBytes;
+    std::vector<Asset> assets(ASSETS);
+    for (auto& asset : assets) {
+        for (const auto& key : keys) {
+            asset.setExtEntry(key, "value");
+        }
+    }
+    long long assetBytes = g_heapBytes - before;
+
+    REQUIRE(assetBytes < mapBytes);
+}
+
+TEST_CASE("Asset ext entries")
+{
+    Asset asset;
+    asset.setExtEntry("name", "ups-1");
+    asset.setEndpointProtocol(1, "nut_snmp");
+    asset.setAddress(1, "10.0.0.1");
+
+    REQUIRE(asset.getFriendlyName() == "ups-1");
+    REQUIRE(asset.getEndpointProtocol(1) == "nut_snmp");
+    REQUIRE(asset.getAddress(1) == "10.0.0.1");
+    REQUIRE(asset.getExtEntry("unknown").empty());
+
+    asset.setExtEntry("name", "ups-2", true);
+    REQUIRE(asset.getFriendlyName() == "ups-2");
+    REQUIRE(asset.isExtEntryReadOnly("name"));
+    REQUIRE(asset.getExt().size() == 3);
+}
+
+TEST_CASE("Asset endpoint and address index")
+{
+    Asset asset;
+    asset.setAddress(1, "10.0.0.1");
+    asset.setAddress(3, "10.0.0.3");
+    asset.setExtEntry("ip.01", "not an address");
+    asset.setEndpointProtocol(1, "nut_snmp");
+    asset.setEndpointPort(1, "161");
+    asset.setEndpointProtocolAttribute(1, "community", "public");
+
+    REQUIRE(asset.getAddress(1) == "10.0.0.1");
+    REQUIRE(asset.getAddress(2).empty());
+    REQUIRE(asset.getAddressMap() == Asset::AddressMap{{1, "10.0.0.1"}, {3, "10.0.0.3"}});
+    REQUIRE(asset.getEndpointProtocol(1) == "nut_snmp");
+    REQUIRE(asset.getEndpointPort(1) == "161");
+    REQUIRE(asset.getEndpointPort(2).empty());
+    REQUIRE(asset.getEndpointProtocolAttribute(1, "community") == "public");
+    REQUIRE(asset.getProtocolMap() == Asset::ProtocolMap{{1, "nut_snmp"}});
+
+    // index follows changes, also in copies
+    Asset copy = asset;
+    copy.setAddress(0, "10.0.0.100");
+    copy.setEndpointPort(1, "162");
+    REQUIRE(copy.getAddress(0) == "10.0.0.100");
+    REQUIRE(copy.getAddress(3) == "10.0.0.3");
+    REQUIRE(copy.getEndpointPort(1) == "162");
+    REQUIRE(asset.getEndpointPort(1) == "161");
+    REQUIRE(asset.getAddress(0).empty());
+
+    asset.removeEndpoint(1);
+    REQUIRE(asset.getProtocolMap().empty());
+}
+
+TEST_CASE("Asset ext index built by concurrent readers")
+{
+    for (int round = 0; round < 50; ++round) {
+        Asset asset;
+        asset.setAddress(1, "10.0.0.1");
+        asset.setEndpointProtocol(1, "nut_snmp");
+
+        // every reader gets references into the index which is stored in the asset
+        std::vector<std::thread> readers;
+        std::vector<int>         ok(8, 0);
+        for (size_t i = 0; i < ok.size(); ++i) {
+            readers.emplace_back([&asset, &ok, i]() {
+                ok[i] = asset.getAddress(1) == "10.0.0.1" && asset.getEndpointProtocol(1) == "nut_snmp" &&
+                        asset.getExt().size() == 2;
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        REQUIRE(ok == std::vector<int>(8, 1));
+    }
+}
@@ -0,0 +1,160 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include <functional>
+
+using namespace fty;
+
+static Asset device(const std::string& name = "ups-1")
+{
+    Asset asset;
+    asset.setInternalName(name);
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_UPS);
+    asset.setParentIname("rack-1");
+    asset.setPriority(3);
+    asset.setExtEntry("name", "ups");
+    asset.setExtEntry("model", "9PX", true);
+    asset.setAddress(1, "10.0.0.1");
+    return asset;
+}
+
+TEST_CASE("Asset fingerprint - equal assets")
+{
+    Asset a = device();
+    Asset b = device();
+    REQUIRE(a.fingerprint() == b.fingerprint());
+    REQUIRE(a == b);
+
+    // ext attributes order of insertion does not matter
+    Asset c;
+    c.setAddress(1, "10.0.0.1");
+    c.setExtEntry("model", "9PX", true);
+    c.setExtEntry("name", "ups");
+    c.setPriority(3);
+    c.setParentIname("rack-1");
+    c.setAssetSubtype(SUB_UPS);
+    c.setAssetType(TYPE_DEVICE);
+    c.setAssetStatus(AssetStatus::Active);
+    c.setInternalName("ups-1");
+    REQUIRE(c.fingerprint() == a.fingerprint());
+
+    // not compared by operator==
+    c.setSecondaryID("secondary");
+    REQUIRE(c.fingerprint() == a.fingerprint());
+    REQUIRE(c == a);
+
+    // copies carry the cached value
+    Asset copy = a;
+    REQUIRE(copy.fingerprint() == a.fingerprint());
+}
+
+TEST_CASE("Asset fingerprint - every compared field")
+{
+    const uint64_t fp = device().fingerprint();
+
+    std::vector<std::function<void(Asset&)>> changes = {
+        [](Asset& a) { a.setInternalName("ups-2"); },
+        [](Asset& a) { a.setAssetStatus(AssetStatus::Nonactive); },
+        [](Asset& a) { a.setAssetType(TYPE_RACK); },
+        [](Asset& a) { a.setAssetSubtype(SUB_EPDU); },
+        [](Asset& a) { a.setParentIname("rack-2"); },
+        [](Asset& a) { a.setPriority(1); },
+        [](Asset& a) { a.setAssetTag("tag"); },
+        [](Asset& a) { a.setExtEntry("name", "other"); },
+        [](Asset& a) { a.setExtEntry("model", "9PX", false); },
+        [](Asset& a) { a.setExtEntry("serial_no", "G123"); },
+        [](Asset& a) { a.clearExtMap(); },
+        [](Asset& a) {
+            AssetLink link;
+            link.setSourceId("epdu-1");
+            link.setLinkType(1);
+            a.setLinkedAssets({link});
+        },
+    };
+
+    for (const auto& change : changes) {
+        Asset tracked = device();
+        tracked.fingerprint();
+        change(tracked);
+
+        Asset fresh = device();
+        change(fresh);
+
+        // maintained by the setters or recomputed, same value
+        REQUIRE(tracked.fingerprint() != fp);
+        REQUIRE(tracked.fingerprint() == fresh.fingerprint());
+        REQUIRE(tracked != device());
+    }
+
+    // back to the original values
+    Asset asset = device();
+    asset.fingerprint();
+    asset.setPriority(1);
+    asset.setExtEntry("name", "other");
+    asset.setPriority(3);
+    asset.setExtEntry("name", "ups");
+    REQUIRE(asset.fingerprint() == fp);
+    REQUIRE(asset == device());
+}
+
+TEST_CASE("Asset fingerprint - decoded assets")
+{
+    Asset asset = device();
+    asset.fingerprint();
+
+    Asset decoded = device("other");
+    decoded.fingerprint();
+    Asset::fromJson(Asset::toJson(asset), decoded);
+    REQUIRE(decoded.fingerprint() == asset.fingerprint());
+
+    decoded = device("other");
+    decoded.fingerprint();
+    Asset::fromBinary(Asset::toBinary(asset), decoded);
+    REQUIRE(decoded.fingerprint() == asset.fingerprint());
+}
+
+TEST_CASE("Asset fingerprint - moved-from assets")
+{
+    Asset asset = device();
+    asset.fingerprint();
+
+    Asset moved(std::move(asset));
+    REQUIRE(moved == device());
+
+    // moved-from asset reused with the setters (strings and containers are left empty by the move)
+    asset.setInternalName("ups-1");
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_UPS);
+    asset.setParentIname("rack-1");
+    asset.setPriority(3);
+    asset.setExtEntry("name", "ups");
+    asset.setExtEntry("model", "9PX", true);
+    asset.setAddress(1, "10.0.0.1");
+    REQUIRE(asset.fingerprint() == device().fingerprint());
+    REQUIRE(asset == device());
+
+    // and after a move assignment
+    Asset target = device("other");
+    target.fingerprint();
+    target = std::move(moved);
+    REQUIRE(target == device());
+}
@@ -0,0 +1,51 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include "heap.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<long long> g_heapBytes{0};
+std::atomic<long long> g_heapAllocs{0};
+
+static constexpr size_t HEAP_HEADER = 16;
+
+void* operator new(size_t size)
+{
+    char* p = static_cast<char*>(std::malloc(size + HEAP_HEADER));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(p) = size;
+    g_heapBytes += static_cast<long long>(size);
+    ++g_heapAllocs;
+    return p + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+    char* p = static_cast<char*>(ptr) - HEAP_HEADER;
+    g_heapBytes -= static_cast<long long>(*reinterpret_cast<size_t*>(p));
+    std::free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
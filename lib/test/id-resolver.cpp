@@ -0,0 +1,99 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_id_resolver.h"
+
+using namespace fty;
+
+namespace {
+
+// fake database: rack-<N> has id N
+struct FakeLookup
+{
+    std::vector<std::vector<std::string>> queries;
+
+    std::map<std::string, int64_t> operator()(const std::vector<std::string>& inames)
+    {
+        queries.push_back(inames);
+
+        std::map<std::string, int64_t> ids;
+        for (const auto& iname : inames) {
+            if (iname.compare(0, 5, "rack-") == 0) {
+                ids[iname] = std::stoll(iname.substr(5));
+            }
+        }
+        return ids;
+    }
+};
+
+} // namespace
+
+TEST_CASE("AssetIdResolver - cache")
+{
+    FakeLookup      db;
+    AssetIdResolver resolver(std::ref(db), 2);
+
+    REQUIRE(resolver.resolve("rack-1") == 1);
+    REQUIRE(resolver.resolve("rack-1") == 1);
+    REQUIRE(db.queries.size() == 1);
+
+    // not found is not cached, the asset may be created later
+    REQUIRE(resolver.resolve("room-1") == -1);
+    REQUIRE(resolver.resolve("room-1") == -1);
+    REQUIRE(db.queries.size() == 3);
+
+    // least recently used is evicted
+    REQUIRE(resolver.resolve("rack-2") == 2);
+    REQUIRE(resolver.resolve("rack-1") == 1);
+    REQUIRE(resolver.resolve("rack-3") == 3);
+    REQUIRE(resolver.size() == 2);
+    REQUIRE(db.queries.size() == 5);
+    REQUIRE(resolver.resolve("rack-1") == 1);
+    REQUIRE(db.queries.size() == 5);
+    REQUIRE(resolver.resolve("rack-2") == 2);
+    REQUIRE(db.queries.size() == 6);
+
+    resolver.invalidate("rack-2");
+    REQUIRE(resolver.resolve("rack-2") == 2);
+    REQUIRE(db.queries.size() == 7);
+
+    auto stats = resolver.stats();
+    REQUIRE(stats.hits == 3);
+    REQUIRE(stats.lookups == 7);
+}
+
+TEST_CASE("AssetIdResolver - bulk resolution")
+{
+    FakeLookup      db;
+    AssetIdResolver resolver(std::ref(db));
+
+    REQUIRE(resolver.resolve("rack-1") == 1);
+
+    auto ids = resolver.resolve({"rack-1", "rack-2", "rack-3", "rack-2", "room-1", "rack-3"});
+
+    // only the names not in cache, once each, in a single lookup
+    REQUIRE(db.queries.size() == 2);
+    REQUIRE(db.queries[1] == std::vector<std::string>{"rack-2", "rack-3", "room-1"});
+    REQUIRE(ids == std::map<std::string, int64_t>{{"rack-1", 1}, {"rack-2", 2}, {"rack-3", 3}});
+
+    resolver.resolve({"rack-1", "rack-2", "rack-3"});
+    REQUIRE(db.queries.size() == 2);
+
+    resolver.clear();
+    REQUIRE(resolver.size() == 0);
+}
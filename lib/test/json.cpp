@@ -0,0 +1,205 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include <cxxtools/jsondeserializer.h>
+#include <cxxtools/jsonserializer.h>
+#include <sstream>
+
+using namespace fty;
+
+static Asset sampleAsset(int i)
+{
+    Asset asset;
+    asset.setInternalName("ups-" + std::to_string(i));
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_UPS);
+    asset.setParentIname("rack-1");
+    asset.setPriority(2);
+    asset.setSecondaryID("secondary");
+    asset.setFriendlyName("UPS \"main\"\\room\t1\n");
+    asset.setExtEntry("ctrl", std::string("a\x01z"), true);
+    asset.setAddress(1, "10.0.0." + std::to_string(i % 250));
+    asset.setEndpointProtocol(1, "nut_snmp");
+    asset.setEndpointPort(1, "161");
+    asset.setEndpointProtocolAttribute(1, "secw_credential_id", "cred-1");
+    asset.setExtEntry("model", "9PX", false, true);
+
+    AssetLink link("feed-1", "", "", 3);
+    link.setExtEntry("label", "A/B");
+    link.setSecondaryID("link-secondary");
+    asset.setLinkedAssets({AssetLink("epdu-1", "1", "2", 1), link});
+    return asset;
+}
+
+// reference implementation, cxxtools serialization
+static std::string cxxtoolsToJson(const Asset& asset)
+{
+    std::ostringstream          output;
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonSerializer    serializer(output);
+
+    si <<= asset;
+    serializer.serialize(si);
+    return output.str();
+}
+
+static Asset cxxtoolsFromJson(const std::string& json)
+{
+    std::istringstream          input(json);
+    cxxtools::SerializationInfo si;
+    cxxtools::JsonDeserializer  deserializer(input);
+
+    deserializer.deserialize(si);
+
+    Asset asset;
+    si >>= asset;
+    return asset;
+}
+
+static void requireSame(const Asset& l, const Asset& r)
+{
+    REQUIRE(l == r);
+    REQUIRE(l.getAssetStatus() == r.getAssetStatus());
+    REQUIRE(l.getSecondaryID() == r.getSecondaryID());
+    REQUIRE(l.getExt() == r.getExt());
+    REQUIRE(l.getLinkedAssets().size() == r.getLinkedAssets().size());
+    for (size_t i = 0; i < l.getLinkedAssets().size(); ++i) {
+        const auto& ll = l.getLinkedAssets()[i];
+        const auto& rl = r.getLinkedAssets()[i];
+        REQUIRE(ll == rl);
+        REQUIRE(ll.ext() == rl.ext());
+        REQUIRE(ll.secondaryID() == rl.secondaryID());
+    }
+    for (const auto& e : l.getExt()) {
+        REQUIRE(e.second.wasUpdated() == r.getExt().at(e.first).wasUpdated());
+    }
+    REQUIRE(l.hasParentsList() == r.hasParentsList());
+    if (l.hasParentsList()) {
+        REQUIRE(l.getParentsList() == r.getParentsList());
+    }
+}
+
+TEST_CASE("Json codec - same result as cxxtools")
+{
+    const Asset       asset = sampleAsset(1);
+    const std::string json = Asset::toJson(asset);
+
+    // what cxxtools reads from our output, we read from cxxtools output
+    requireSame(cxxtoolsFromJson(json), asset);
+
+    Asset fromCxxtools;
+    Asset::fromJson(cxxtoolsToJson(asset), fromCxxtools);
+    requireSame(fromCxxtools, asset);
+
+    Asset roundTrip;
+    Asset::fromJson(json, roundTrip);
+    requireSame(roundTrip, asset);
+    REQUIRE(roundTrip.getEndpointProtocol(1) == "nut_snmp");
+    REQUIRE(roundTrip.getFriendlyName() == "UPS \"main\"\\room\t1\n");
+
+    // parents list read from JSON
+    const std::string withParents = json.substr(0, json.size() - 1) + ",\"parents_list\":[" +
+                                    Asset::toJson(sampleAsset(2)) + "]}";
+    Asset parents;
+    Asset::fromJson(withParents, parents);
+    REQUIRE(parents.hasParentsList());
+    requireSame(parents, cxxtoolsFromJson(withParents));
+    requireSame(cxxtoolsFromJson(Asset::toJson(parents)), parents);
+}
+
+TEST_CASE("Json codec - reader")
+{
+    SECTION("whitespace, unknown members, lenient scalars and escapes")
+    {
+        const std::string json = R"( {
+            "unknown" : {"a": [1, 2, {"b": null}]},
+            "status" : "2", "type" : "device", "sub_type" : "ups", "name" : "ups-1",
+            "priority" : 3, "parent" : null, "linked" : [ {"source": "epdu-1", "link_type": "1"} ],
+            "ext" : {
+                "name" : {"value": "caf\u00e9 \ud83d\ude00 \/", "readOnly": false, "update": true},
+                "u_size" : {"value": 2, "readOnly": "true", "update": false}
+            }
+        } )";
+
+        Asset asset;
+        Asset::fromJson(json, asset);
+
+        REQUIRE(asset.getAssetStatus() == AssetStatus::Nonactive);
+        REQUIRE(asset.getAssetType() == TYPE_DEVICE);
+        REQUIRE(asset.getPriority() == 3);
+        REQUIRE(asset.getParentIname().empty());
+        REQUIRE(asset.getLinkedAssets().size() == 1);
+        REQUIRE(asset.getLinkedAssets()[0].linkType() == 1);
+        REQUIRE(asset.getFriendlyName() == "caf\xc3\xa9 \xf0\x9f\x98\x80 /");
+        REQUIRE(asset.getExt().at("name").wasUpdated());
+        REQUIRE(asset.getExtEntry("u_size") == "2");
+        REQUIRE(asset.isExtEntryReadOnly("u_size"));
+        REQUIRE_FALSE(asset.hasParentsList());
+    }
+
+    SECTION("malformed input")
+    {
+        Asset asset;
+        REQUIRE_THROWS_AS(Asset::fromJson("", asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson("{\"status\":1", asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson("{\"status\":1}", asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson(Asset::toJson(sampleAsset(1)) + "x", asset), std::runtime_error);
+    }
+
+    SECTION("unpaired surrogates")
+    {
+        auto withName = [](const std::string& name) {
+            Asset asset = sampleAsset(1);
+            asset.setFriendlyName("@");
+            std::string json = Asset::toJson(asset);
+            return json.replace(json.find("\"@\""), 3, "\"" + name + "\"");
+        };
+
+        Asset asset;
+        Asset::fromJson(withName("\\ud83d\\ude00"), asset);
+        REQUIRE(asset.getFriendlyName() == "\xf0\x9f\x98\x80");
+
+        REQUIRE_THROWS_AS(Asset::fromJson(withName("\\ud83d"), asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson(withName("\\ud83dx"), asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson(withName("\\ud83d\\u0041"), asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson(withName("\\ud83d\\ud83d"), asset), std::runtime_error);
+        REQUIRE_THROWS_AS(Asset::fromJson(withName("\\ude00"), asset), std::runtime_error);
+    }
+
+    SECTION("nesting depth")
+    {
+        const std::string json = Asset::toJson(sampleAsset(1));
+        auto withUnknown = [&](int depth) {
+            return json.substr(0, json.size() - 1) + ",\"unknown\":" + std::string(size_t(depth), '[') +
+                   std::string(size_t(depth), ']') + "}";
+        };
+
+        Asset asset;
+        Asset::fromJson(withUnknown(32), asset);
+        REQUIRE_THROWS_AS(Asset::fromJson(withUnknown(100000), asset), std::runtime_error);
+
+        // parents of parents
+        std::string nested = json;
+        for (int i = 0; i < 100; ++i) {
+            nested = json.substr(0, json.size() - 1) + ",\"parents_list\":[" + nested + "]}";
+        }
+        REQUIRE_THROWS_AS(Asset::fromJson(nested, asset), std::runtime_error);
+    }
+}
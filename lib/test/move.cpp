@@ -0,0 +1,114 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include "heap.h"
+#include <type_traits>
+
+using namespace fty;
+
+static_assert(std::is_nothrow_move_constructible<Asset>::value, "vector<Asset> must move on reallocation");
+static_assert(std::is_nothrow_move_constructible<ExtMapElement>::value, "ext attributes must move on reallocation");
+
+static Asset movableAsset(int i)
+{
+    Asset asset;
+    asset.setInternalName("ups-with-a-long-enough-internal-name-" + std::to_string(i));
+    asset.setParentIname("rack-with-a-long-enough-internal-name");
+    for (int n = 0; n < 20; ++n) {
+        asset.setExtEntry("attribute." + std::to_string(n), "value of the attribute, not in small buffer");
+    }
+    asset.setAddress(1, "10.0.0.1");
+    asset.setLinkedAssets({AssetLink("epdu-with-a-long-enough-internal-name", "1", "2", 1)});
+    return asset;
+}
+
+TEST_CASE("Asset - move does not allocate")
+{
+    Asset asset = movableAsset(1);
+    REQUIRE(asset.getAddress(1) == "10.0.0.1");
+
+    long long before = g_heapAllocs;
+    Asset     moved(std::move(asset));
+    Asset     assigned;
+    assigned = std::move(moved);
+    REQUIRE(g_heapAllocs == before);
+
+    REQUIRE(assigned.getExt().size() == 21);
+    REQUIRE(assigned.getAddress(1) == "10.0.0.1");
+    REQUIRE(assigned.getLinkedAssets().size() == 1);
+
+    ExtMapElement element("value of the attribute, not in small buffer", true);
+    before                = g_heapAllocs;
+    ExtMapElement movedElement(std::move(element));
+    REQUIRE(g_heapAllocs == before);
+    REQUIRE(movedElement.isReadOnly());
+    REQUIRE(element.getValue().empty());
+}
+
+TEST_CASE("Asset - sink setters")
+{
+    Asset asset;
+
+    std::string name(64, 'n');
+    std::string tag(64, 't');
+    std::vector<AssetLink> links{AssetLink(std::string(64, 's'), "", "", 1)};
+
+    // rvalue overloads take over the buffers
+    long long before = g_heapAllocs;
+    asset.setInternalName(std::move(name));
+    asset.setAssetTag(std::move(tag));
+    asset.setLinkedAssets(std::move(links));
+    REQUIRE(g_heapAllocs == before);
+
+    REQUIRE(asset.getInternalName() == std::string(64, 'n'));
+    REQUIRE(asset.getAssetTag() == std::string(64, 't'));
+    REQUIRE(asset.getLinkedAssets().size() == 1);
+
+    // const overloads copy
+    const std::string parent(64, 'p');
+    asset.setParentIname(parent);
+    REQUIRE(asset.getParentIname() == parent);
+    REQUIRE(asset.getParentIname().data() != parent.data());
+}
+
+TEST_CASE("Asset - vector growth moves elements")
+{
+    static constexpr int ASSETS = 256;
+
+    std::vector<Asset>       source;
+    std::vector<const char*> names;
+    for (int i = 0; i < ASSETS; ++i) {
+        source.push_back(movableAsset(i));
+    }
+    for (const auto& asset : source) {
+        names.push_back(asset.getInternalName().data());
+    }
+    std::vector<Asset> copied(source);
+
+    // a copy would allocate a new buffer for the internal name (not in small buffer): the buffers of the
+    // source assets must end up in the vector, through push_back and every reallocation
+    std::vector<Asset> moved;
+    for (auto& asset : source) {
+        moved.push_back(std::move(asset));
+    }
+    for (int i = 0; i < ASSETS; ++i) {
+        REQUIRE(moved[size_t(i)].getInternalName().data() == names[size_t(i)]);
+    }
+    REQUIRE(moved == copied);
+}
@@ -0,0 +1,91 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "fty_asset_dto.h"
+#include "fty_asset_symbol.h"
+#include <thread>
+
+using namespace fty;
+
+TEST_CASE("Symbol interning")
+{
+    Symbol device("device");
+    Symbol same(std::string("device"));
+    Symbol rack("rack");
+
+    REQUIRE(device == same);
+    REQUIRE(device.id() == same.id());
+    REQUIRE(&device.str() == &same.str());
+    REQUIRE(device != rack);
+    REQUIRE(device == "device");
+    REQUIRE(std::string("rack") == rack);
+    REQUIRE(Symbol().empty());
+    REQUIRE(Symbol().id() == 0);
+
+    // same table from every thread
+    Symbol fromThread;
+    std::thread([&fromThread]() {
+        fromThread = Symbol("device");
+    }).join();
+    REQUIRE(fromThread == device);
+}
+
+TEST_CASE("Asset types are shared symbols")
+{
+    Asset ups;
+    ups.setAssetType(TYPE_DEVICE);
+    ups.setAssetSubtype(SUB_UPS);
+
+    Asset epdu;
+    epdu.setAssetType(std::string(TYPE_DEVICE));
+    epdu.setAssetSubtype(SUB_EPDU);
+
+    REQUIRE(ups.getAssetTypeSymbol() == epdu.getAssetTypeSymbol());
+    REQUIRE(&ups.getAssetType() == &epdu.getAssetType());
+    REQUIRE(ups.getAssetSubtypeSymbol() != epdu.getAssetSubtypeSymbol());
+    REQUIRE(ups.getAssetSubtype() == SUB_UPS);
+
+    Asset unknown;
+    REQUIRE(unknown.getAssetType() == TYPE_UNKNOWN);
+}
+
+TEST_CASE("Symbol table bounded for free-form values")
+{
+    Symbol device("device");
+    REQUIRE(Symbol::tryIntern("device") == device);
+
+    // fill the table up to the limit, values are unique to this test
+    for (size_t i = 0; Symbol::count() < Symbol::TRY_INTERN_LIMIT; ++i) {
+        REQUIRE(Symbol::tryIntern("symbol-test-" + std::to_string(i)));
+    }
+
+    size_t count = Symbol::count();
+    REQUIRE(!Symbol::tryIntern("symbol-test-over-limit"));
+    REQUIRE(Symbol::tryIntern("device") == device);
+    REQUIRE(Symbol::count() == count);
+
+    // ext keys are then owned by the asset
+    Asset asset;
+    asset.setExtEntry("symbol-test-key", "value");
+    asset.setExtEntry("name", "ups");
+    Asset copy = asset;
+    REQUIRE(copy.getExtEntry("symbol-test-key") == "value");
+    REQUIRE(copy == asset);
+    REQUIRE(asset.getExt().count("symbol-test-key") == 1);
+    REQUIRE(Symbol::count() == count);
+}
@@ -96,15 +96,28 @@
     bool read_only,
     bool test);
 
-// Inserts ext attributes from inventory message into DB if not present in the cache
+// One ext attribute of an inventory message
+struct InventoryAttribute
+{
+    std::string device_name;
+    std::string keytag;
+    std::string value;
+    bool        read_only;
+};
+
+// Inserts ext attributes of several assets as multi-row upserts in one transaction,
+// written [i] tells whether attributes [i] is in DB once the transaction is committed
  int
     process_insert_inventory
-    (const std::string& device_name,
-    zhash_t *ext_attributes,
-    bool read_only,
-    std::unordered_map<std::string,std::string> &map_cache,
+    (const std::vector<InventoryAttribute> &attributes,
+    std::vector<bool> &written,
     bool test);
 
+// Multi-row upsert statement of inventory attributes
+ std::string
+    inventory_upsert_sql
+    (size_t rows);
+
 // Selects user-friendly name for given asset name
  int
     select_ename_from_iname
@@ -21,9 +21,13 @@
 
 #include "asset-server.h"
 
+#include "asset/asset-journal.h"
+#include "asset/asset-snapshot.h"
 #include "asset/asset-utils.h"
 
 #include <algorithm>
+#include <cinttypes>
+#include <fty_asset_delta.h>
 #include <fty_asset_dto.h>
 #include <fty/convert.h>
 #include <sstream>
@@ -31,7 +35,12 @@
 #include <ctime>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
+#include <cxxtools/base64codec.h>
 #include <cxxtools/serializationinfo.h>
 
 #include <fty_common.h>
@@ -70,6 +79,63 @@ static V value(const std::map<K, V>& map, const typename identify<K>::type& key,
     return def;
 }
 
+// payload encoding of -ng requests, JSON unless the client asks for protobuf in metadata
+static bool isBinaryEncoding(const messagebus::Message& msg)
+{
+    return value(msg.metaData(), METADATA_ENCODING) == ENCODING_PROTOBUF;
+}
+
+// protobuf payloads are base64 encoded: message frames are C strings, protobuf has 0x00 bytes
+static std::string toPayload(const std::string& binary)
+{
+    return cxxtools::encode<cxxtools::Base64Codec>(binary);
+}
+
+static std::string fromPayload(const std::string& payload)
+{
+    return cxxtools::decode<cxxtools::Base64Codec>(payload);
+}
+
+static void decodeAsset(const messagebus::Message& msg, fty::Asset& asset)
+{
+    if (isBinaryEncoding(msg)) {
+        fty::Asset::fromBinary(fromPayload(msg.userData().front()), asset);
+    } else {
+        fty::Asset::fromJson(msg.userData().front(), asset);
+    }
+}
+
+static std::string encodeAsset(const messagebus::Message& request, const fty::Asset& asset)
+{
+    return isBinaryEncoding(request) ? toPayload(fty::Asset::toBinary(asset)) : fty::Asset::toJson(asset);
+}
+
+// JSON array or protobuf AssetList
+static std::string encodeAssets(const messagebus::Message& request, const std::vector<fty::Asset>& assets)
+{
+    if (isBinaryEncoding(request)) {
+        return toPayload(fty::Asset::toBinary(assets));
+    }
+
+    cxxtools::SerializationInfo si;
+    for (const auto& asset : assets) {
+        cxxtools::SerializationInfo& data = si.addMember("");
+        data <<= asset;
+        data.setCategory(cxxtools::SerializationInfo::Category::Object);
+    }
+    si.setCategory(cxxtools::SerializationInfo::Category::Array);
+    return JSON::writeToString(si, false);
+}
+
+// replies tell which encoding was used, so that clients can fall back to JSON with older agents
+static messagebus::Message withEncoding(const messagebus::Message& request, messagebus::Message reply)
+{
+    if (isBinaryEncoding(request)) {
+        reply.metaData()[METADATA_ENCODING] = ENCODING_PROTOBUF;
+    }
+    return reply;
+}
+
 // ===========================================================================================================
 
 
@@ -143,6 +209,11 @@ void AssetServer::createPublisherClientNg()
         messagebus::MlmMessageBus(m_mailboxEndpoint, m_agentNameNg + "-delete-light"));
     log_debug("New publisher client registered to endpoint %s with name %s", m_mailboxEndpoint.c_str(),
         (m_agentNameNg + "-delete-light").c_str());
+
+    m_publisherUpdateDelta.reset(
+        messagebus::MlmMessageBus(m_mailboxEndpoint, m_agentNameNg + "-update-delta"));
+    log_debug("New publisher client registered to endpoint %s with name %s", m_mailboxEndpoint.c_str(),
+        (m_agentNameNg + "-update-delta").c_str());
 }
 
 void AssetServer::resetPublisherClientNg()
@@ -153,6 +224,7 @@ void AssetServer::resetPublisherClientNg()
     m_publisherCreateLight.reset();
     m_publisherUpdateLight.reset();
     m_publisherDeleteLight.reset();
+    m_publisherUpdateDelta.reset();
 }
 
 void AssetServer::connectPublisherClientNg()
@@ -163,6 +235,7 @@ void AssetServer::connectPublisherClientNg()
     m_publisherCreateLight->connect();
     m_publisherUpdateLight->connect();
     m_publisherDeleteLight->connect();
+    m_publisherUpdateDelta->connect();
 }
 
 // new generation asset manipulation handler
@@ -173,16 +246,19 @@ void AssetServer::handleAssetManipulationReq(const messagebus::Message& msg)
 
     // clang-format off
     static std::map<std::string, std::function<void(const messagebus::Message&)>> procMap = {
-        { FTY_ASSET_SUBJECT_CREATE,       [&](const messagebus::Message& message){ createAsset(message); } },
-        { FTY_ASSET_SUBJECT_UPDATE,       [&](const messagebus::Message& message){ updateAsset(message); } },
-        { FTY_ASSET_SUBJECT_DELETE,       [&](const messagebus::Message& message){ deleteAsset(message); } },
-        { FTY_ASSET_SUBJECT_GET,          [&](const messagebus::Message& message){ getAsset(message); } },
-        { FTY_ASSET_SUBJECT_GET_BY_UUID,  [&](const messagebus::Message& message){ getAsset(message, true); } },
-        { FTY_ASSET_SUBJECT_LIST,         [&](const messagebus::Message& message){ listAsset(message); } },
-        { FTY_ASSET_SUBJECT_GET_ID,       [&](const messagebus::Message& message){ getAssetID(message); } },
-        { FTY_ASSET_SUBJECT_GET_INAME,    [&](const messagebus::Message& message){ getAssetIname(message); } },
-        { FTY_ASSET_SUBJECT_STATUS_UPD,   [&](const messagebus::Message& message){ notifyStatusUpdate(message); } },
-        { FTY_ASSET_SUBJECT_NOTIFY,       [&](const messagebus::Message& message){ notifyAsset(message); } }
+        { FTY_ASSET_SUBJECT_CREATE,            [&](const messagebus::Message& message){ createAsset(message); } },
+        { FTY_ASSET_SUBJECT_UPDATE,            [&](const messagebus::Message& message){ updateAsset(message); } },
+        { FTY_ASSET_SUBJECT_DELETE,            [&](const messagebus::Message& message){ deleteAsset(message); } },
+        { FTY_ASSET_SUBJECT_GET,               [&](const messagebus::Message& message){ getAsset(message); } },
+        { FTY_ASSET_SUBJECT_GET_BY_UUID,       [&](const messagebus::Message& message){ getAsset(message, true); } },
+        { FTY_ASSET_SUBJECT_LIST,              [&](const messagebus::Message& message){ listAsset(message); } },
+        { FTY_ASSET_SUBJECT_GET_ID,            [&](const messagebus::Message& message){ getAssetID(message); } },
+        { FTY_ASSET_SUBJECT_GET_INAME,         [&](const messagebus::Message& message){ getAssetIname(message); } },
+        { FTY_ASSET_SUBJECT_STATUS_UPD,        [&](const messagebus::Message& message){ notifyStatusUpdate(message); } },
+        { FTY_ASSET_SUBJECT_NOTIFY,            [&](const messagebus::Message& message){ notifyAsset(message); } },
+        { FTY_ASSET_SUBJECT_GET_BATCH,         [&](const messagebus::Message& message){ getAssetBatch(message); } },
+        { FTY_ASSET_SUBJECT_GET_BATCH_BY_UUID, [&](const messagebus::Message& message){ getAssetBatch(message, true); } },
+        { FTY_ASSET_SUBJECT_GET_ID_BATCH,      [&](const messagebus::Message& message){ getAssetIDBatch(message); } }
     };
     // clang-format on
 
@@ -208,8 +284,22 @@ void AssetServer::handleAssetSrrReq(const messagebus::Message& msg)
         Query    query;
         data >> query;
 
+        // incremental save if the request gives the sequence of a previous save
+        dto::srr::SrrQueryProcessor processor = m_srrProcessor;
+        const std::string&          since     = value(msg.metaData(), METADATA_SRR_SINCE);
+        if (!since.empty()) {
+            try {
+                uint64_t sequence     = fty::convert<uint64_t>(since);
+                processor.saveHandler = [this, sequence](const SaveQuery& saveQuery) {
+                    return handleSave(saveQuery, sequence);
+                };
+            } catch (const std::exception&) {
+                log_warning("Invalid %s '%s', full save", METADATA_SRR_SINCE, since.c_str());
+            }
+        }
+
         messagebus::UserData respData;
-        respData << (m_srrProcessor.processQuery(query));
+        respData << (processor.processQuery(query));
 
         auto response = assetutils::createMessage(msg.metaData().find(messagebus::Message::SUBJECT)->second,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_srrAgentName,
@@ -226,7 +316,7 @@ void AssetServer::handleAssetSrrReq(const messagebus::Message& msg)
     }
 }
 
-dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query)
+dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query, std::optional<uint64_t> since)
 {
     using namespace dto;
     using namespace dto::srr;
@@ -238,13 +328,18 @@ dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query)
         FeatureAndStatus fs1;
         Feature&         f1 = *(fs1.mutable_feature());
 
-
         if (featureName == FTY_ASSET_SRR_NAME) {
             f1.set_version(SRR_ACTIVE_VERSION);
             try {
                 Lock lock(m_srrLock);
-                auto savedAssets = saveAssets();
-                f1.set_data(JSON::writeToString(savedAssets, false));
+                if (since) {
+                    f1.set_data(saveAssetsDelta(*since));
+                } else if (m_srrEncoding == SrrEncoding::Binary) {
+                    // feature data must be valid UTF-8
+                    f1.set_data(cxxtools::encode<cxxtools::Base64Codec>(saveSnapshot()));
+                } else {
+                    f1.set_data(saveAssetsJson());
+                }
                 fs1.mutable_status()->set_status(Status::SUCCESS);
             } catch (std::exception& e) {
                 fs1.mutable_status()->set_status(Status::FAILED);
@@ -262,6 +357,12 @@ dto::srr::SaveResponse AssetServer::handleSave(const dto::srr::SaveQuery& query)
     return (createSaveResponse(mapFeaturesData, SRR_ACTIVE_VERSION)).save();
 }
 
+// base64 encoded snapshot starts with the encoded magic "FTYASN..."
+static bool isBinarySnapshot(const std::string& data)
+{
+    return data.compare(0, 8, "RlRZQVNO") == 0;
+}
+
 dto::srr::RestoreResponse AssetServer::handleRestore(const dto::srr::RestoreQuery& query)
 {
     using namespace dto;
@@ -282,9 +383,18 @@ dto::srr::RestoreResponse AssetServer::handleRestore(const dto::srr::RestoreQuer
             try {
                 Lock lock(m_srrLock);
 
-                cxxtools::SerializationInfo si;
-                JSON::readFromString(feature.data(), si);
-                restoreAssets(si);
+                if (isBinarySnapshot(feature.data())) {
+                    std::string snapshot = cxxtools::decode<cxxtools::Base64Codec>(feature.data());
+                    restoreSnapshot(snapshot.data(), snapshot.size());
+                } else {
+                    cxxtools::SerializationInfo si;
+                    JSON::readFromString(feature.data(), si);
+                    if (si.findMember("since")) {
+                        restoreAssetsDelta(si);
+                    } else {
+                        restoreAssets(si);
+                    }
+                }
 
                 featureStatus.set_status(Status::SUCCESS);
             } catch (std::exception& e) {
@@ -330,8 +440,10 @@ dto::srr::ResetResponse AssetServer::handleReset(const dto::srr::ResetQuery& /*q
 }
 
 // sends create/update/delete notification on both new and old interface
-void AssetServer::sendNotification(const messagebus::Message& msg) const
+uint64_t AssetServer::sendNotification(const messagebus::Message& msg) const
 {
+    uint64_t sequence = 0;
+
     const std::string& subject = msg.metaData().at(messagebus::Message::SUBJECT);
 
     if (subject == FTY_ASSET_SUBJECT_CREATED) {
@@ -343,6 +455,8 @@ void AssetServer::sendNotification(const messagebus::Message& msg) const
         fty::Asset::fromJson(msg.userData().back(), asset);
         send_create_or_update_asset(
             *this, asset.getInternalName(), "create", false /* read_only is not used */);
+
+        sequence = ChangeJournal::instance().record(asset.getInternalName(), ChangeJournal::Change::Updated);
     } else if (subject == FTY_ASSET_SUBJECT_UPDATED) {
         m_publisherUpdate->publish(FTY_ASSET_TOPIC_UPDATED, msg);
 
@@ -358,15 +472,25 @@ void AssetServer::sendNotification(const messagebus::Message& msg) const
 
         send_create_or_update_asset(
             *this, asset.getInternalName(), "update", false /* read_only is not used */);
+
+        sequence = ChangeJournal::instance().record(asset.getInternalName(), ChangeJournal::Change::Updated);
     } else if (subject == FTY_ASSET_SUBJECT_DELETED) {
         m_publisherDelete->publish(FTY_ASSET_TOPIC_DELETED, msg);
+
+        fty::Asset asset;
+        fty::Asset::fromJson(msg.userData().back(), asset);
+        sequence = ChangeJournal::instance().record(asset.getInternalName(), ChangeJournal::Change::Deleted);
     } else if (subject == FTY_ASSET_SUBJECT_CREATED_L) {
         m_publisherCreateLight->publish(FTY_ASSET_TOPIC_CREATED_L, msg);
     } else if (subject == FTY_ASSET_SUBJECT_UPDATED_L) {
         m_publisherUpdateLight->publish(FTY_ASSET_TOPIC_UPDATED_L, msg);
     } else if (subject == FTY_ASSET_SUBJECT_DELETED_L) {
         m_publisherDeleteLight->publish(FTY_ASSET_TOPIC_DELETED_L, msg);
+    } else if (subject == FTY_ASSET_SUBJECT_UPDATED_D) {
+        m_publisherUpdateDelta->publish(FTY_ASSET_TOPIC_UPDATED_D, msg);
     }
+
+    return sequence;
 }
 
 void AssetServer::initSrr(const std::string& queue)
@@ -377,7 +501,9 @@ void AssetServer::initSrr(const std::string& queue)
 
     m_srrClient->connect();
 
-    m_srrProcessor.saveHandler    = std::bind(&AssetServer::handleSave, this, _1);
+    m_srrProcessor.saveHandler    = [this](const dto::srr::SaveQuery& query) {
+        return handleSave(query);
+    };
     m_srrProcessor.restoreHandler = std::bind(&AssetServer::handleRestore, this, _1);
     m_srrProcessor.resetHandler   = std::bind(&AssetServer::handleReset, this, _1);
 
@@ -403,9 +529,8 @@ void AssetServer::createAsset(const messagebus::Message& msg)
             throw std::runtime_error("Licensing limitation hit - asset manipulation is prohibited");
         }
 
-        std::string    userData = msg.userData().front();
         fty::AssetImpl asset;
-        fty::Asset::fromJson(userData, asset);
+        decodeAsset(msg, asset);
 
         bool requestActivation = (asset.getAssetStatus() == AssetStatus::Active);
 
@@ -437,10 +562,10 @@ void AssetServer::createAsset(const messagebus::Message& msg)
         // update asset data
         asset.load();
 
-        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_CREATE,
+        auto response = withEncoding(msg, assetutils::createMessage(FTY_ASSET_SUBJECT_CREATE,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
             msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            fty::Asset::toJson(asset));
+            encodeAsset(msg, asset)));
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
@@ -483,10 +608,9 @@ void AssetServer::updateAsset(const messagebus::Message& msg)
             throw std::runtime_error("Licensing limitation hit - asset manipulation is prohibited");
         }
 
-        std::string    userData = msg.userData().front();
         fty::AssetImpl asset;
 
-        fty::Asset::fromJson(userData, asset);
+        decodeAsset(msg, asset);
 
         // get current asset data from storage
         fty::AssetImpl currentAsset(asset.getInternalName());
@@ -528,10 +652,10 @@ void AssetServer::updateAsset(const messagebus::Message& msg)
         asset.load();
 
         // create response (ok)
-        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATE,
+        auto response = withEncoding(msg, assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATE,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
             msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            fty::Asset::toJson(asset));
+            encodeAsset(msg, asset)));
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
@@ -636,10 +760,10 @@ void AssetServer::getAsset(const messagebus::Message& msg, bool getFromUuid)
         }
 
         // create response (ok)
-        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET,
+        auto response = withEncoding(msg, assetutils::createMessage(FTY_ASSET_SUBJECT_GET,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
             msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            fty::Asset::toJson(asset));
+            encodeAsset(msg, asset)));
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
@@ -658,6 +782,53 @@ void AssetServer::getAsset(const messagebus::Message& msg, bool getFromUuid)
     }
 }
 
+void AssetServer::getAssetBatch(const messagebus::Message& msg, bool getFromUuid)
+{
+    log_debug("subject GET_BATCH%s", (getFromUuid ? "_BY_UUID" : ""));
+
+    try {
+        std::vector<std::string> names(msg.userData().begin(), msg.userData().end());
+        if (getFromUuid) {
+            names = AssetImpl::getInamesFromUuids(names);
+        }
+
+        // one set-based load for all the assets, instead of one per asset
+        std::vector<fty::AssetImpl> loaded = AssetImpl::loadList(names);
+
+        bool withParentsList = value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true";
+
+        std::vector<fty::Asset> assets;
+        assets.reserve(loaded.size());
+        for (auto& asset : loaded) {
+            if (withParentsList) {
+                asset.updateParentsList();
+            }
+            assets.push_back(std::move(asset));
+        }
+
+        // create response (ok), assets not found are missing
+        auto response = withEncoding(msg, assetutils::createMessage(FTY_ASSET_SUBJECT_GET_BATCH,
+            msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
+            encodeAssets(msg, assets)));
+
+        // send response
+        log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
+        m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
+    } catch (std::exception& e) {
+        log_error(e.what());
+        // create response (error)
+        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET_BATCH,
+            msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_KO,
+            TRANSLATE_ME(e.what()));
+
+        // send response
+        log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
+        m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
+    }
+}
+
 void AssetServer::listAsset(const messagebus::Message& msg)
 {
     log_debug("subject LIST");
@@ -688,9 +859,28 @@ void AssetServer::listAsset(const messagebus::Message& msg)
 
         std::vector<std::string>    inameList = fty::AssetImpl::list(filters);
         cxxtools::SerializationInfo si;
+        std::string                 data;
 
         if (idOnly) {
             si <<= inameList;
+            data = JSON::writeToString(si, false);
+        } else if (isBinaryEncoding(msg)) {
+            bool withParentsList = value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true";
+
+            std::vector<fty::Asset> assets;
+            assets.reserve(inameList.size());
+            for (const auto& iname : inameList) {
+                try {
+                    fty::AssetImpl asset(iname);
+                    if (withParentsList) {
+                        asset.updateParentsList();
+                    }
+                    assets.push_back(std::move(asset));
+                } catch (std::exception& e) {
+                    log_error("Could not retrieve asset %s: %s", iname.c_str(), e.what());
+                }
+            }
+            data = toPayload(fty::Asset::toBinary(assets));
         } else {
             bool withParentsList = value(msg.metaData(), METADATA_WITH_PARENTS_LIST) == "true";
 
@@ -708,13 +898,16 @@ void AssetServer::listAsset(const messagebus::Message& msg)
                 }
             }
             si.setCategory(cxxtools::SerializationInfo::Category::Array);
+            data = JSON::writeToString(si, false);
         }
 
-        // create response (ok)
+        // create response (ok), list of inames is always JSON
         auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_LIST,
             msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
-            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
-            JSON::writeToString(si, false));
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK, data);
+        if (!idOnly) {
+            response = withEncoding(msg, response);
+        }
 
         // send response
         log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
@@ -765,6 +958,43 @@ void AssetServer::getAssetID(const messagebus::Message& msg)
     }
 }
 
+void AssetServer::getAssetIDBatch(const messagebus::Message& msg)
+{
+    log_debug("subject GET_ID_BATCH");
+
+    try {
+        std::vector<std::string> inames(msg.userData().begin(), msg.userData().end());
+
+        // object iname -> id, assets not found are missing
+        cxxtools::SerializationInfo si;
+        for (const auto& it : AssetImpl::getIDsFromInames(inames)) {
+            si.addMember(it.first) <<= it.second;
+        }
+        si.setCategory(cxxtools::SerializationInfo::Category::Object);
+
+        // create response (ok)
+        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET_ID_BATCH,
+            msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_OK,
+            JSON::writeToString(si, false));
+
+        // send response
+        log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
+        m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
+    } catch (std::exception& e) {
+        log_error(e.what());
+        // create response (error)
+        auto response = assetutils::createMessage(FTY_ASSET_SUBJECT_GET_ID_BATCH,
+            msg.metaData().find(messagebus::Message::CORRELATION_ID)->second, m_agentNameNg,
+            msg.metaData().find(messagebus::Message::FROM)->second, messagebus::STATUS_KO,
+            TRANSLATE_ME(e.what()));
+
+        // send response
+        log_debug("sending response to %s", msg.metaData().find(messagebus::Message::FROM)->second.c_str());
+        m_assetMsgQueue->sendReply(msg.metaData().find(messagebus::Message::REPLY_TO)->second, response);
+    }
+}
+
 void AssetServer::getAssetIname(const messagebus::Message& msg)
 {
     log_debug("subject GET_INAME");
@@ -863,13 +1093,14 @@ void AssetServer::notifyAsset(const messagebus::Message& msg)
         // full notification
         messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED, "",
             m_agentNameNg, "", messagebus::STATUS_OK, JSON::writeToString(si, false));
-        sendNotification(notification);
+        uint64_t sequence = sendNotification(notification);
 
         // light notification
         messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_L, "",
             m_agentNameNg, "", messagebus::STATUS_OK, newAsset.getInternalName());
         sendNotification(notification_l);
 
+        notifyAssetDelta(oldAsset, newAsset, sequence);
 
     } catch (std::exception& e) {
         log_error(e.what());
@@ -903,82 +1134,208 @@ void AssetServer::notifyAssetUpdate(const Asset& before, const Asset& after)
         // full notification
         messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED, "",
             m_agentNameNg, "", messagebus::STATUS_OK, JSON::writeToString(si, false));
-        sendNotification(notification);
+        uint64_t sequence = sendNotification(notification);
 
         // light notification
         messagebus::Message notification_l = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_L, "",
             m_agentNameNg, "", messagebus::STATUS_OK, after.getInternalName());
         sendNotification(notification_l);
 
+        notifyAssetDelta(before, after, sequence);
     } catch (std::exception& e) {
         log_error(e.what());
     }
 }
 
+// sequence: journal record of the full notification, the version of the asset (the journal may have moved on)
+void AssetServer::notifyAssetDelta(const Asset& before, const Asset& after, uint64_t sequence)
+{
+    AssetDelta delta = AssetDelta::diff(before, after, sequence);
+    if (delta.empty()) {
+        return;
+    }
+
+    cxxtools::SerializationInfo si;
+    si <<= delta;
+
+    messagebus::Message notification = assetutils::createMessage(FTY_ASSET_SUBJECT_UPDATED_D, "",
+        m_agentNameNg, "", messagebus::STATUS_OK, JSON::writeToString(si, false));
+    sendNotification(notification);
+}
+
 // SRR
 cxxtools::SerializationInfo AssetServer::saveAssets(bool saveVirtualAssets)
 {
-    std::vector<std::string> assets = AssetImpl::listAll();
-
     cxxtools::SerializationInfo si;
 
     si.addMember("version") <<= SRR_ACTIVE_VERSION;
 
     cxxtools::SerializationInfo& data = si.addMember("data");
 
-    for (const std::string& assetName : assets) {
-        AssetImpl a(assetName);
-
-        if (a.isVirtual() && !saveVirtualAssets) {
+    AssetImpl::loadAll([&](const Asset& a) {
+        if (AssetImpl::isVirtualType(a.getAssetTypeSymbol()) && !saveVirtualAssets) {
             log_info("Asset %s is virtual, will not be saved", a.getInternalName().c_str());
-            continue;
+            return;
         }
 
         log_debug("Saving asset %s...", a.getInternalName().c_str());
 
         cxxtools::SerializationInfo& siAsset = data.addMember("");
         AssetImpl::assetToSrr(a, siAsset);
-    }
+    });
 
     data.setCategory(cxxtools::SerializationInfo::Array);
 
     return si;
 }
 
-static void buildRestoreTree(std::vector<AssetImpl>& v)
+// same document as saveAssets(), but serialized asset by asset without building the whole tree
+std::string AssetServer::saveAssetsJson(bool saveVirtualAssets)
 {
-    std::map<std::string, std::vector<std::string>> ancestorMatrix;
+    std::string payload;
+    bool        first = true;
+
+    // taken first: changes made while saving are part of the next delta
+    uint64_t sequence = ChangeJournal::instance().sequence();
+
+    payload += "{\"version\":\"";
+    payload += SRR_ACTIVE_VERSION;
+    payload += "\",\"sequence\":";
+    payload += std::to_string(sequence);
+    payload += ",\"data\":[";
+
+    AssetImpl::loadAll([&](const Asset& a) {
+        if (AssetImpl::isVirtualType(a.getAssetTypeSymbol()) && !saveVirtualAssets) {
+            log_info("Asset %s is virtual, will not be saved", a.getInternalName().c_str());
+            return;
+        }
+
+        log_debug("Saving asset %s...", a.getInternalName().c_str());
+
+        cxxtools::SerializationInfo siAsset;
+        AssetImpl::assetToSrr(a, siAsset);
 
-    for (const AssetImpl& a : v) {
-        // create node if doesn't exist
-        ancestorMatrix[a.getInternalName()];
-        if (!a.getParentIname().empty()) {
-            ancestorMatrix[a.getParentIname()].push_back(a.getInternalName());
+        if (!first) {
+            payload += ',';
         }
+        payload += JSON::writeToString(siAsset, false);
+        first = false;
+    });
+
+    payload += "]}";
+
+    return payload;
+}
+
+// changed assets and deleted inames since a previous save, falls back to a full save if the journal does not
+// go back that far
+std::string AssetServer::saveAssetsDelta(uint64_t since, bool saveVirtualAssets)
+{
+    uint64_t                sequence = ChangeJournal::instance().sequence();
+    ChangeJournal::Changes changes;
+
+    if (!ChangeJournal::instance().since(since, changes)) {
+        log_info("Changes since %" PRIu64 " are not in journal, full save", since);
+        return saveAssetsJson(saveVirtualAssets);
     }
 
-    // iterate on each asset
-    for (const auto& a : ancestorMatrix) {
-        std::string id       = a.first;
-        const auto& children = a.second;
+    cxxtools::SerializationInfo si;
+    si.addMember("version") <<= SRR_DELTA_VERSION;
+    si.addMember("sequence") <<= sequence;
+    si.addMember("since") <<= since;
 
-        // find ancestors of asset a
-        for (auto& x : ancestorMatrix) {
-            auto& parentOf = x.second;
+    cxxtools::SerializationInfo& data    = si.addMember("data");
+    cxxtools::SerializationInfo& deleted = si.addMember("deleted");
 
-            auto found = std::find(parentOf.begin(), parentOf.end(), id);
-            // if x is parent of a, x inherits all children of a
-            if (found != parentOf.end()) {
-                for (const auto& child : children) {
-                    parentOf.push_back(child);
+    for (const auto& it : changes) {
+        const std::string& iname = it.first;
+
+        if (it.second.change == ChangeJournal::Change::Updated) {
+            try {
+                AssetImpl a(iname);
+                if (AssetImpl::isVirtualType(a.getAssetTypeSymbol()) && !saveVirtualAssets) {
+                    continue;
                 }
+
+                log_debug("Saving changed asset %s...", iname.c_str());
+                AssetImpl::assetToSrr(a, data.addMember(""));
+                continue;
+            } catch (const std::exception& e) {
+                // deleted without notification
+                log_debug("Changed asset %s not found: %s", iname.c_str(), e.what());
             }
         }
+
+        deleted.addMember("") <<= iname;
     }
 
-    std::sort(v.begin(), v.end(), [&](const AssetImpl& l, const AssetImpl& r) {
-        return ancestorMatrix[l.getInternalName()].size() > ancestorMatrix[r.getInternalName()].size();
-    });
+    data.setCategory(cxxtools::SerializationInfo::Array);
+    deleted.setCategory(cxxtools::SerializationInfo::Array);
+
+    log_debug("Delta since %" PRIu64 ": %zu changes", since, changes.size());
+
+    return JSON::writeToString(si, false);
+}
+
+// order assets parent before child, grouped by depth in the restored tree
+// assets whose parent is not part of the restore (or has no parent) are at level 0
+static std::vector<std::vector<AssetImpl*>> buildRestoreLevels(std::vector<AssetImpl>& v)
+{
+    static constexpr int IN_PROGRESS = -2;
+    static constexpr int UNKNOWN     = -1;
+
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+        index.emplace(v[i].getInternalName(), i);
+    }
+
+    std::vector<int>    depth(v.size(), UNKNOWN);
+    std::vector<size_t> path;
+
+    // every asset is visited once: walk up until an ancestor with known depth, then assign depths downwards
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (depth[i] != UNKNOWN) {
+            continue;
+        }
+
+        path.clear();
+        size_t cur  = i;
+        int    base = 0;
+        while (true) {
+            depth[cur] = IN_PROGRESS;
+            path.push_back(cur);
+
+            auto parent = index.find(v[cur].getParentIname());
+            if (parent == index.end()) {
+                break;
+            }
+            if (depth[parent->second] >= 0) {
+                base = depth[parent->second] + 1;
+                break;
+            }
+            if (depth[parent->second] == IN_PROGRESS) {
+                log_error("Parent cycle detected on asset %s", v[cur].getInternalName().c_str());
+                break;
+            }
+            cur = parent->second;
+        }
+
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            depth[*it] = base++;
+        }
+    }
+
+    std::vector<std::vector<AssetImpl*>> levels;
+    for (size_t i = 0; i < v.size(); ++i) {
+        size_t d = size_t(depth[i]);
+        if (levels.size() <= d) {
+            levels.resize(d + 1);
+        }
+        levels[d].push_back(&v[i]);
+    }
+
+    return levels;
 }
 
 void AssetServer::restoreAssets(const cxxtools::SerializationInfo& si, bool tryActivate)
@@ -997,55 +1354,264 @@ void AssetServer::restoreAssets(const cxxtools::SerializationInfo& si, bool tryA
         AssetImpl a;
         AssetImpl::srrToAsset(*it, a);
 
-        assetsToRestore.push_back(a);
+        assetsToRestore.push_back(std::move(a));
+    }
+
+    restoreAssets(assetsToRestore, tryActivate);
+}
+
+// apply a delta created by saveAssetsDelta() on top of a restored base
+void AssetServer::restoreAssetsDelta(const cxxtools::SerializationInfo& si, bool tryActivate)
+{
+    std::string srrVersion;
+    si.getMember("version") >>= srrVersion;
+
+    if (fty::convert<float>(srrVersion) > fty::convert<float>(SRR_DELTA_VERSION)) {
+        throw std::runtime_error("Version " + srrVersion + " is not supported");
+    }
+
+    std::vector<std::string> deleted;
+    si.getMember("deleted") >>= deleted;
+
+    if (!deleted.empty()) {
+        for (const auto& status : AssetImpl::deleteList(deleted, false)) {
+            if (status.second != "OK") {
+                log_debug("Asset %s not deleted: %s", status.first.getInternalName().c_str(),
+                    status.second.c_str());
+            }
+        }
+    }
+
+    const cxxtools::SerializationInfo& assets = si.getMember("data");
+    std::vector<AssetImpl>             assetsToRestore;
+    std::vector<AssetImpl>             assetsToUpdate;
+
+    for (auto it = assets.begin(); it != assets.end(); ++it) {
+        AssetImpl a;
+        AssetImpl::srrToAsset(*it, a);
+
+        try {
+            AssetImpl::getIDFromIname(a.getInternalName());
+            assetsToUpdate.push_back(std::move(a));
+        } catch (const std::exception&) {
+            assetsToRestore.push_back(std::move(a));
+        }
+    }
+
+    // new assets first, an updated asset may have been moved under one of them
+    restoreAssets(assetsToRestore, tryActivate);
+
+    for (auto& a : assetsToUpdate) {
+        try {
+            log_debug("Updating asset %s...", a.getInternalName().c_str());
+            a.update();
+        } catch (const std::exception& e) {
+            log_error("Update of asset %s failed: %s", a.getInternalName().c_str(), e.what());
+        }
     }
+}
 
-    buildRestoreTree(assetsToRestore);
+// number of parallel workers (and database connections) used by restore
+static size_t restoreWorkers()
+{
+    static constexpr size_t MAX_RESTORE_WORKERS = 8;
+    return std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), MAX_RESTORE_WORKERS));
+}
 
-    for (AssetImpl& a : assetsToRestore) {
-        log_debug("Restoring asset %s...", a.getInternalName().c_str());
+// split assets in chunks and run fn on each of them concurrently, every worker with its own connection
+// small batches are not worth a connection and run in the calling thread
+static void restoreParallel(const std::vector<AssetImpl*>& assets,
+    const std::function<void(const std::vector<AssetImpl*>& chunk, AssetStorage& storage)>& fn)
+{
+    static constexpr size_t MIN_CHUNK = 64;
 
+    auto run = [&fn](const std::vector<AssetImpl*>& chunk) {
         try {
-            bool requestActivation = (a.getAssetStatus() == AssetStatus::Active);
+            fn(chunk, *AssetImpl::createStorage());
+        } catch (const std::exception& e) {
+            log_error("Restore of %zu assets failed: %s", chunk.size(), e.what());
+        }
+    };
+
+    size_t workers = std::min(restoreWorkers(), (assets.size() + MIN_CHUNK - 1) / MIN_CHUNK);
+    if (workers <= 1) {
+        if (!assets.empty()) {
+            run(assets);
+        }
+        return;
+    }
 
-            if (requestActivation && !a.isActivable()) {
+    std::vector<std::vector<AssetImpl*>> chunks(workers);
+    for (size_t i = 0; i < assets.size(); ++i) {
+        chunks[i % workers].push_back(assets[i]);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (const auto& chunk : chunks) {
+        threads.emplace_back(run, std::cref(chunk));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void AssetServer::restoreAssets(std::vector<AssetImpl>& assetsToRestore, bool tryActivate)
+{
+    std::vector<AssetImpl*> restored;
+    std::mutex              restoredLock;
+
+    for (const auto& level : buildRestoreLevels(assetsToRestore)) {
+        std::vector<AssetImpl*> toInsert;
+        std::set<AssetImpl*>    toActivate;
+        toInsert.reserve(level.size());
+
+        // one licensing request for the whole level
+        std::vector<AssetImpl*> active;
+        for (AssetImpl* a : level) {
+            if (a->getAssetStatus() == AssetStatus::Active) {
+                active.push_back(a);
+            }
+        }
+        std::set<AssetImpl*> notActivable;
+        auto                 activable = AssetImpl::isActivable(active);
+        for (size_t i = 0; i < active.size(); ++i) {
+            if (!activable[i]) {
+                notActivable.insert(active[i]);
+            }
+        }
+
+        for (AssetImpl* a : level) {
+            log_debug("Restoring asset %s...", a->getInternalName().c_str());
+
+            bool requestActivation = (a->getAssetStatus() == AssetStatus::Active);
+
+            if (requestActivation && notActivable.count(a)) {
                 if (tryActivate) {
-                    a.setAssetStatus(fty::AssetStatus::Nonactive);
+                    a->setAssetStatus(fty::AssetStatus::Nonactive);
                     requestActivation = false;
                 } else {
-                    throw std::runtime_error(
-                        "Licensing limitation hit - maximum amount of active power devices allowed in "
-                        "license reached.");
+                    // not restored, as any asset failing its restore: the restore goes on with the others
+                    log_error("Licensing limitation hit - maximum amount of active power devices allowed in "
+                              "license reached.");
+                    continue;
                 }
             }
 
-            // restore asset to db
-            a.restore();
-
-            // activate asset
+            toInsert.push_back(a);
             if (requestActivation) {
-                try {
-                    a.activate();
-                } catch (std::exception& e) {
-                    // if activation fails, delete asset
-                    AssetImpl::deleteList({a.getInternalName()}, false);
-                    throw std::runtime_error(e.what());
-                }
+                toActivate.insert(a);
+            }
+        }
+
+        // siblings do not depend on each other: restore the level concurrently, one transaction per worker
+        std::vector<AssetImpl*> levelRestored;
+        restoreParallel(toInsert, [&](const std::vector<AssetImpl*>& chunk, AssetStorage& storage) {
+            auto done = AssetImpl::restoreList(chunk, storage);
+
+            std::lock_guard<std::mutex> lock(restoredLock);
+            levelRestored.insert(levelRestored.end(), done.begin(), done.end());
+        });
+
+        // workers joined, mappings go through the agent CAM client
+        AssetImpl::restoreMappings(levelRestored);
+
+        // activate assets
+        std::vector<AssetImpl*> activate;
+        for (AssetImpl* a : levelRestored) {
+            if (toActivate.count(a)) {
+                activate.push_back(a);
+            }
+        }
+        auto failed = AssetImpl::activate(activate);
+
+        // if activation fails, delete asset
+        std::set<AssetImpl*> deleted;
+        for (AssetImpl* a : failed) {
+            auto status = AssetImpl::deleteList({a->getInternalName()}, false);
+            if (!status.empty() && status.front().second == "OK") {
+                deleted.insert(a);
+            }
+        }
+
+        for (AssetImpl* a : levelRestored) {
+            if (!deleted.count(a)) {
+                restored.push_back(a);
             }
-        } catch (std::exception& e) {
-            log_error(e.what());
         }
     }
 
-    // restore links
-    for (AssetImpl& a : assetsToRestore) {
-        try {
-            // save links
-            a.update();
-        } catch (std::exception& e) {
-            log_error(e.what());
+    // restore links, all assets exist at this point
+    restoreParallel(restored, [](const std::vector<AssetImpl*>& chunk, AssetStorage& storage) {
+        AssetImpl::restoreLinksList(chunk, storage);
+    });
+}
+
+std::string AssetServer::saveSnapshot(bool saveVirtualAssets)
+{
+    std::set<std::string> saved;
+
+    SnapshotWriter writer;
+
+    AssetImpl::loadAll([&](const Asset& a) {
+        if (AssetImpl::isVirtualType(a.getAssetTypeSymbol()) && !saveVirtualAssets) {
+            log_info("Asset %s is virtual, will not be saved", a.getInternalName().c_str());
+            return;
+        }
+
+        writer.addAsset(a);
+        saved.insert(a.getInternalName());
+    });
+
+    for (const auto& relation : AssetImpl::listGroupRelations()) {
+        if (saved.count(relation.first) && saved.count(relation.second)) {
+            writer.addGroupRelation(relation.first, relation.second);
         }
     }
+
+    log_debug("Snapshot of %zu assets created", saved.size());
+
+    return writer.finish();
+}
+
+size_t AssetServer::restoreSnapshot(const char* data, size_t size, bool tryActivate)
+{
+    SnapshotReader reader(data, size);
+
+    std::vector<AssetImpl> assetsToRestore;
+    GroupRelations         groups;
+    reader.read(assetsToRestore, groups);
+
+    size_t count = assetsToRestore.size();
+    restoreAssets(assetsToRestore, tryActivate);
+
+    try {
+        AssetImpl::restoreGroupRelations(groups);
+    } catch (std::exception& e) {
+        log_error("Restore of group relations failed: %s", e.what());
+    }
+
+    log_debug("Snapshot of %zu assets restored", count);
+
+    return count;
+}
+
+size_t AssetServer::saveSnapshotFile(const std::string& path)
+{
+    Lock lock(m_srrLock);
+
+    std::string snapshot = saveSnapshot();
+    SnapshotFile::write(path, snapshot);
+
+    return snapshot.size();
+}
+
+size_t AssetServer::restoreSnapshotFile(const std::string& path)
+{
+    Lock lock(m_srrLock);
+
+    SnapshotFile file(path);
+    return restoreSnapshot(file.data(), file.size());
 }
 
 } // namespace fty
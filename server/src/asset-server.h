@@ -24,6 +24,7 @@
 #include <fty_srr_dto.h>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 static constexpr const char* FTY_ASSET_MAILBOX = "FTY.Q.ASSET.QUERY";
 // new interface mailbox subjects
@@ -38,6 +39,10 @@ static constexpr const char* FTY_ASSET_SUBJECT_GET_ID      = "GET_ID";
 static constexpr const char* FTY_ASSET_SUBJECT_GET_INAME   = "GET_INAME";
 static constexpr const char* FTY_ASSET_SUBJECT_STATUS_UPD  = "STATUS_UPDATE";
 static constexpr const char* FTY_ASSET_SUBJECT_NOTIFY      = "NOTIFY";
+// one frame per iname (or UUID), reply has the assets found
+static constexpr const char* FTY_ASSET_SUBJECT_GET_BATCH         = "GET_BATCH";
+static constexpr const char* FTY_ASSET_SUBJECT_GET_BATCH_BY_UUID = "GET_BATCH_BY_UUID";
+static constexpr const char* FTY_ASSET_SUBJECT_GET_ID_BATCH      = "GET_ID_BATCH";
 
 // new interface topics
 static constexpr const char* FTY_ASSET_TOPIC_CREATED   = "FTY.T.ASSET.CREATED";
@@ -46,6 +51,7 @@ static constexpr const char* FTY_ASSET_TOPIC_UPDATED   = "FTY.T.ASSET.UPDATED";
 static constexpr const char* FTY_ASSET_TOPIC_UPDATED_L = "FTY.T.ASSET_LIGHT.UPDATED";
 static constexpr const char* FTY_ASSET_TOPIC_DELETED   = "FTY.T.ASSET.DELETED";
 static constexpr const char* FTY_ASSET_TOPIC_DELETED_L = "FTY.T.ASSET_LIGHT.DELETED";
+static constexpr const char* FTY_ASSET_TOPIC_UPDATED_D = "FTY.T.ASSET_DELTA.UPDATED";
 
 // new interface topic subjects
 static constexpr const char* FTY_ASSET_SUBJECT_CREATED   = "CREATED";
@@ -54,6 +60,7 @@ static constexpr const char* FTY_ASSET_SUBJECT_UPDATED   = "UPDATED";
 static constexpr const char* FTY_ASSET_SUBJECT_UPDATED_L = "UPDATED_LIGHT";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETED   = "DELETED";
 static constexpr const char* FTY_ASSET_SUBJECT_DELETED_L = "DELETED_LIGHT";
+static constexpr const char* FTY_ASSET_SUBJECT_UPDATED_D = "UPDATED_DELTA";
 
 
 static constexpr const char* METADATA_TRY_ACTIVATE      = "TRY_ACTIVATE";
@@ -63,9 +70,13 @@ static constexpr const char* METADATA_WITH_PARENTS_LIST = "WITH_PARENTS_LIST";
 
 // SRR
 static constexpr const char* SRR_ACTIVE_VERSION  = "1.1";
+// delta payloads of incremental save, an agent which restores them as a full save must reject them
+static constexpr const char* SRR_DELTA_VERSION   = "1.2";
 static constexpr const char* FTY_ASSET_SRR_AGENT = "asset-agent-srr";
 static constexpr const char* FTY_ASSET_SRR_NAME  = "asset-agent";
 static constexpr const char* FTY_ASSET_SRR_QUEUE = "FTY.Q.ASSET.SRR";
+// incremental save: sequence of a previous save, in the request metadata
+static constexpr const char* METADATA_SRR_SINCE = "SRR_SINCE";
 
 typedef struct _mlm_client_t mlm_client_t;
 namespace messagebus {
@@ -80,6 +91,12 @@ class AssetServer
 public:
     using MsgBusPtr = std::unique_ptr<messagebus::MessageBus>;
 
+    enum class SrrEncoding
+    {
+        Json,
+        Binary
+    };
+
     AssetServer();
     ~AssetServer() = default;
 
@@ -174,6 +191,16 @@ public:
         m_srrAgentName = agentName;
     }
 
+    SrrEncoding getSrrEncoding() const
+    {
+        return m_srrEncoding;
+    }
+
+    void setSrrEncoding(SrrEncoding encoding)
+    {
+        m_srrEncoding = encoding;
+    }
+
     void createMailboxClientNg();
     void resetMailboxClientNg();
     void connectMailboxClientNg();
@@ -183,30 +210,43 @@ public:
     void resetPublisherClientNg();
     void connectPublisherClientNg();
 
-    // notifications
-    void sendNotification(const messagebus::Message&) const;
+    // notifications, returns the change journal sequence of the notified asset (0 for light notifications)
+    uint64_t sendNotification(const messagebus::Message&) const;
 
     // SRR
     void initSrr(const std::string& queue);
     void resetSrrClient();
 
+    // binary snapshot, returns snapshot size in bytes / number of restored assets
+    size_t saveSnapshotFile(const std::string& path);
+    size_t restoreSnapshotFile(const std::string& path);
+
 private:
     void createAsset(const messagebus::Message& msg);
     void updateAsset(const messagebus::Message& msg);
     void deleteAsset(const messagebus::Message& msg);
     void getAsset(const messagebus::Message& msg, bool getFromUuid = false);
+    void getAssetBatch(const messagebus::Message& msg, bool getFromUuid = false);
     void listAsset(const messagebus::Message& msg);
     void getAssetID(const messagebus::Message& msg);
+    void getAssetIDBatch(const messagebus::Message& msg);
     void getAssetIname(const messagebus::Message& msg);
     void notifyStatusUpdate(const messagebus::Message& msg);
     void notifyAsset(const messagebus::Message& msg);
 
     // notifications
     void notifyAssetUpdate(const Asset& before, const Asset& after);
+    void notifyAssetDelta(const Asset& before, const Asset& after, uint64_t sequence);
 
     // SRR
     cxxtools::SerializationInfo saveAssets(bool saveVirtualAssets = false);
+    std::string                 saveAssetsJson(bool saveVirtualAssets = false);
+    std::string                 saveAssetsDelta(uint64_t since, bool saveVirtualAssets = false);
     void                        restoreAssets(const cxxtools::SerializationInfo& si, bool tryActivate = true);
+    void                        restoreAssetsDelta(const cxxtools::SerializationInfo& si, bool tryActivate = true);
+    void                        restoreAssets(std::vector<AssetImpl>& assetsToRestore, bool tryActivate);
+    std::string                 saveSnapshot(bool saveVirtualAssets = false);
+    size_t                      restoreSnapshot(const char* data, size_t size, bool tryActivate = true);
 
 private:
     static void destroyMlmClient(mlm_client_t* client);
@@ -233,6 +273,7 @@ private:
     MsgBusPtr   m_publisherUpdateLight;
     MsgBusPtr   m_publisherDelete;
     MsgBusPtr   m_publisherDeleteLight;
+    MsgBusPtr   m_publisherUpdateDelta;
 
     // topic handlers
     void handleAssetManipulationReq(const messagebus::Message& msg);
@@ -244,9 +285,10 @@ private:
     MsgBusPtr                   m_srrClient;
     std::mutex                  m_srrLock;
     dto::srr::SrrQueryProcessor m_srrProcessor;
+    SrrEncoding                 m_srrEncoding = SrrEncoding::Json;
 
     // SRR handlers
-    dto::srr::SaveResponse    handleSave(const dto::srr::SaveQuery& query);
+    dto::srr::SaveResponse    handleSave(const dto::srr::SaveQuery& query, std::optional<uint64_t> since = {});
     dto::srr::RestoreResponse handleRestore(const dto::srr::RestoreQuery& query);
     dto::srr::ResetResponse   handleReset(const dto::srr::ResetQuery& query);
 };
@@ -24,35 +24,31 @@
 #include <fty_log.h>
 #include <fty_security_wallet.h>
 
-std::list<CredentialMapping> getCredentialMappings(const ExtMap& extMap)
+std::list<CredentialMapping> getCredentialMappings(const fty::Asset& asset)
 {
     std::list<CredentialMapping> credentialList;
 
     log_debug("Looking for mapping entries");
 
-    auto findCredKey = [&] (const auto& el) {
-        return el.first.find(SECW_CRED_ID_KEY) != std::string::npos;
-    };
-
     // lookup for ext attributes which contains secw_credential_id in the key
-    auto found = std::find_if(extMap.begin(), extMap.end(), findCredKey);
+    asset.forEachExt([&](const std::string& key, const fty::ExtMapElement& element) {
+        if (key.find(SECW_CRED_ID_KEY) == std::string::npos) {
+            return;
+        }
 
-    // create mapping
-    while(found != extMap.end()) {
+        // create mapping
         CredentialMapping c;
-        c.credentialId = found->second.getValue();
+        c.credentialId = element.getValue();
 
         // extract protocol from element key (endpoint.XX.protocol.secw_credential_id)
-        // auto keyTokens = fty::split(found->first, ".");
+        // auto keyTokens = fty::split(key, ".");
         c.serviceId = CAM_SERVICE_ID;
         c.protocol = /* keyTokens.size() >= 3 ? keyTokens[2] : */ CAM_DEFAULT_PROTOCOL;
         c.port = CAM_DEFAULT_PORT;
         credentialList.push_back(c);
 
         log_debug("Found new credential %s : %s", c.credentialId.c_str(), c.protocol.c_str());
-
-        found = std::find_if(++found, extMap.end(), findCredKey);
-    }
+    });
 
     return credentialList;
 }
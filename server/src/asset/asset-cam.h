@@ -1,11 +1,10 @@
 #pragma once
 #include <cxxtools/serializationinfo.h>
 #include <list>
-#include <map>
 #include <string>
 
 namespace fty {
-    class ExtMapElement;
+    class Asset;
 }
 
 // cam/secw interface constants
@@ -25,8 +24,6 @@ struct CredentialMapping {
     std::string port;
 };
 
-using ExtMap = std::map<std::string, fty::ExtMapElement>;
-
-std::list<CredentialMapping> getCredentialMappings(const ExtMap& extMap);
+std::list<CredentialMapping> getCredentialMappings(const fty::Asset& asset);
 void createMappings(const std::string& assetInternalName, const std::list<CredentialMapping>& credentialList);
 void deleteMappings(const std::string& assetInternalName);
@@ -225,4 +225,60 @@ std::vector<std::string> DBTest::listAllAssets()
     return assetList;
 }
 
+void DBTest::loadAllAssets(const std::function<void(const Asset&)>& callback)
+{
+    std::cout << "DBTest::loadAllAssets" << std::endl;
+
+    for (const auto& name : listAllAssets()) {
+        Asset asset;
+        loadAsset(name, asset);
+        loadExtMap(asset);
+        loadLinkedAssets(asset);
+        callback(asset);
+    }
+}
+
+void DBTest::loadAssets(const std::vector<std::string>& inames, const std::function<void(const Asset&)>& callback)
+{
+    std::cout << "DBTest::loadAssets" << std::endl;
+
+    for (const auto& name : inames) {
+        Asset asset;
+        loadAsset(name, asset);
+        loadExtMap(asset);
+        loadLinkedAssets(asset);
+        callback(asset);
+    }
+}
+
+std::vector<std::string> DBTest::inamesByUuids(const std::vector<std::string>& uuids)
+{
+    std::cout << "DBTest::inamesByUuids" << std::endl;
+
+    std::vector<std::string> inames;
+    for (const auto& uuid : uuids) {
+        inames.push_back(inameByUuid(uuid));
+    }
+    return inames;
+}
+
+GroupRelations DBTest::listGroupRelations()
+{
+    std::cout << "DBTest::listGroupRelations" << std::endl;
+    GroupRelations relations;
+
+    relations.emplace_back("asset-1", "group-1");
+
+    return relations;
+}
+
+void DBTest::saveGroupRelations(const GroupRelations& groups)
+{
+    std::cout << "DBTest::saveGroupRelations" << std::endl;
+
+    for (const auto& relation : groups) {
+        std::cout << "\t" << relation.first << " -> " << relation.second << std::endl;
+    }
+}
+
 } // namespace fty
@@ -71,6 +71,14 @@ public:
     std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters) override;
     std::vector<std::string> listAllAssets() override;
 
+    void loadAllAssets(const std::function<void(const Asset&)>& callback) override;
+    void loadAssets(
+        const std::vector<std::string>& inames, const std::function<void(const Asset&)>& callback) override;
+    std::vector<std::string> inamesByUuids(const std::vector<std::string>& uuids) override;
+
+    GroupRelations listGroupRelations() override;
+    void           saveGroupRelations(const GroupRelations& groups) override;
+
 private:
     DBTest();
 };
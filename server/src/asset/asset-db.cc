@@ -25,6 +25,7 @@
 #include <fty_common_db_dbpath.h>
 #include <sstream>
 #include <tntdb.h>
+#include <functional>
 #include <map>
 #include <algorithm>
 #include <asset/asset-helpers.h>
@@ -53,6 +54,14 @@ DB& DB::getInstance()
     return m_instance;
 }
 
+std::unique_ptr<DB> DB::create()
+{
+    std::unique_ptr<DB> db(new DB());
+    db->m_conn = tntdb::connectCached(DBConn::url);
+
+    return db;
+}
+
 void DB::loadAsset(const std::string& nameId, Asset& asset)
 {
     tntdb::Row row;
@@ -1299,15 +1308,15 @@ void DB::saveExtMap(Asset& asset)
     std::vector<ExternalAttributeInDB> toBeRemoved;
 
 
-    for (const auto& it : asset.getExt()) {
+    asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
 
         // skip the none updated attribute
-        if (!it.second.wasUpdated()) {
-            continue;
+        if (!element.wasUpdated()) {
+            return;
         }
 
-        std::string value = it.second.getValue();
-        if (it.first == "name" && it.second.getValue().size() > 50) {
+        std::string value = element.getValue();
+        if (key == "name" && element.getValue().size() > 50) {
             if (auto norm = fty::asset::normName(value, 50, *assetID)) {
                 value = *norm;
             } else {
@@ -1317,7 +1326,7 @@ void DB::saveExtMap(Asset& asset)
         }
 
         auto found = std::find_if(existing.begin(), existing.end(), [&](const ExternalAttributeInDB& e) {
-            return std::get<1>(e) == it.first;
+            return std::get<1>(e) == key;
         });
 
 
@@ -1325,16 +1334,16 @@ void DB::saveExtMap(Asset& asset)
             // The attribute do not exist in the database
             // if it's not empty we insert it.
 
-            if (!it.second.getValue().empty()) {
+            if (!element.getValue().empty()) {
                 // clang-format off
                 auto q1 = m_conn.prepareCached(R"(
                     INSERT INTO t_bios_asset_ext_attributes (keytag, value, id_asset_element, read_only)
                     VALUES (:key, :value, :assetId, :readOnly)
                 )");
                 // clang-format on
-                q1.set("key", it.first);
+                q1.set("key", key);
                 q1.set("value", value);
-                q1.set("readOnly", it.second.isReadOnly());
+                q1.set("readOnly", element.isReadOnly());
                 q1.set("assetId", *assetID);
                 try {
                     Lock lock(m_conn_lock);
@@ -1350,7 +1359,7 @@ void DB::saveExtMap(Asset& asset)
             // The attribute exist in the database
             // if it's not empty we update it, else remove it.
 
-            if (!it.second.getValue().empty()) {
+            if (!element.getValue().empty()) {
                 // clang-format off
                 auto q1 = m_conn.prepareCached(R"(
                     UPDATE t_bios_asset_ext_attributes
@@ -1361,7 +1370,7 @@ void DB::saveExtMap(Asset& asset)
                 )");
                 // clang-format on
                 q1.set("value", value);
-                q1.set("readOnly", it.second.isReadOnly());
+                q1.set("readOnly", element.isReadOnly());
                 q1.set("extId", std::get<0>(*found));
 
                 try {
@@ -1376,7 +1385,7 @@ void DB::saveExtMap(Asset& asset)
                 toBeRemoved.push_back(*found);
             }
         }
-    }
+    });
 
     for (const auto& toRem : toBeRemoved) {
         // clang-format off
@@ -1502,4 +1511,362 @@ std::vector<std::string> DB::listAllAssets()
     return assetList;
 }
 
+// merges the rows of the asset, ext attribute and link queries, all ordered by asset id, in a single pass
+static void mergeAssetRows(const tntdb::Result& assets, const tntdb::Result& ext, const tntdb::Result& links,
+    const std::function<void(const Asset&)>& callback)
+{
+    auto extIt  = ext.begin();
+    auto linkIt = links.begin();
+
+    for (const auto& row : assets) {
+        uint32_t id = row.getUnsigned32("id");
+
+        Asset asset;
+        asset.setInternalName(row.getString("name"));
+        asset.setAssetType(row.getString("type"));
+        asset.setAssetSubtype(row.getString("subType"));
+        if (!row.isNull("parentName")) {
+            asset.setParentIname(row.getString("parentName"));
+        }
+        asset.setAssetStatus(stringToAssetStatus(row.getString("status")));
+        asset.setPriority(row.getInt("priority"));
+        if (!row.isNull("tag")) {
+            asset.setAssetTag(row.getString("tag"));
+        }
+        if (!row.isNull("idSecondary")) {
+            asset.setSecondaryID(row.getString("idSecondary"));
+        }
+
+        // ext attributes
+        for (; extIt != ext.end() && (*extIt).getUnsigned32("id") <= id; ++extIt) {
+            const auto& extRow = *extIt;
+            if (extRow.getUnsigned32("id") == id) {
+                asset.setExtEntry(
+                    extRow.getString("keytag"), extRow.getString("value"), extRow.getBool("read_only"), true);
+            }
+        }
+
+        // links, one row per link attribute
+        std::vector<AssetLink> assetLinks;
+        uint32_t               lastLinkID = 0;
+        for (; linkIt != links.end() && (*linkIt).getUnsigned32("id") <= id; ++linkIt) {
+            const auto& linkRow = *linkIt;
+            if (linkRow.getUnsigned32("id") != id) {
+                continue;
+            }
+
+            uint32_t linkID = linkRow.getUnsigned32("link_id");
+            if (assetLinks.empty() || linkID != lastLinkID) {
+                std::string srcOut, destIn;
+                // may be NULL
+                if (!linkRow.isNull("srcOut")) {
+                    linkRow.getString("srcOut", srcOut);
+                }
+                if (!linkRow.isNull("destIn")) {
+                    linkRow.getString("destIn", destIn);
+                }
+                assetLinks.emplace_back(linkRow.getString("name"), srcOut, destIn, linkRow.getInt("linkType"));
+                lastLinkID = linkID;
+            }
+            if (!linkRow.isNull("keytag")) {
+                assetLinks.back().setExtEntry(linkRow.getString("keytag"), linkRow.getString("value"),
+                    linkRow.getBool("read_only"), true);
+            }
+        }
+        asset.setLinkedAssets(assetLinks);
+
+        callback(asset);
+    }
+}
+
+void DB::loadAllAssets(const std::function<void(const Asset&)>& callback)
+{
+    // one query per table, all ordered by asset id so they can be merged in a single pass
+    // clang-format off
+    auto qAssets = m_conn.prepareCached(R"(
+        SELECT
+            a.id_asset_element AS id,
+            a.name             AS name,
+            e.name             AS type,
+            d.name             AS subType,
+            p.name             AS parentName,
+            a.status           AS status,
+            a.priority         AS priority,
+            a.asset_tag        AS tag,
+            a.id_secondary     AS idSecondary
+        FROM t_bios_asset_element AS a
+            INNER JOIN t_bios_asset_device_type AS d
+            INNER JOIN t_bios_asset_element_type AS e
+            ON a.id_type = e.id_asset_element_type AND a.id_subtype = d.id_asset_device_type
+            LEFT JOIN t_bios_asset_element AS p
+            ON a.id_parent = p.id_asset_element
+        ORDER BY a.id_asset_element
+    )");
+
+    auto qExt = m_conn.prepareCached(R"(
+        SELECT
+            id_asset_element AS id,
+            keytag,
+            value,
+            read_only
+        FROM
+            t_bios_asset_ext_attributes
+        ORDER BY id_asset_element
+    )");
+
+    auto qLinks = m_conn.prepareCached(R"(
+        SELECT
+            l.id_asset_device_dest  AS id,
+            l.id_link               AS link_id,
+            e.name                  AS name,
+            l.src_out               AS srcOut,
+            l.dest_in               AS destIn,
+            l.id_asset_link_type    AS linkType,
+            t.keytag                AS keytag,
+            t.value                 AS value,
+            t.read_only             AS read_only
+        FROM
+            t_bios_asset_link AS l
+        INNER JOIN
+            t_bios_asset_element AS e ON l.id_asset_device_src = e.id_asset_element
+        LEFT JOIN
+            t_bios_asset_link_attributes AS t ON t.id_link = l.id_link
+        ORDER BY l.id_asset_device_dest, l.id_link
+    )");
+    // clang-format on
+
+    tntdb::Result assets;
+    tntdb::Result ext;
+    tntdb::Result links;
+
+    try {
+        Lock lock(m_conn_lock);
+        assets = qAssets.select();
+        ext    = qExt.select();
+        links  = qLinks.select();
+
+    } catch (std::exception& e) {
+
+        throw std::runtime_error("database error - " + std::string(e.what()));
+    }
+
+    mergeAssetRows(assets, ext, links, [&callback](const Asset& asset) {
+        // discard rackcontroller 0
+        if (asset.getInternalName() != RC0) {
+            callback(asset);
+        }
+    });
+}
+
+// names per query, keeps the statements (and their prepared cache entries) small
+static constexpr size_t LOAD_CHUNK = 128;
+
+static std::string namesParams(size_t count)
+{
+    std::string params;
+    for (size_t i = 0; i < count; ++i) {
+        params += (i ? ", :n" : ":n") + std::to_string(i);
+    }
+    return params;
+}
+
+void DB::loadAssets(const std::vector<std::string>& inames, const std::function<void(const Asset&)>& callback)
+{
+    for (size_t start = 0; start < inames.size(); start += LOAD_CHUNK) {
+        size_t      count  = std::min(LOAD_CHUNK, inames.size() - start);
+        std::string params = namesParams(count);
+
+        // same queries as loadAllAssets, restricted to the chunk of names
+        // clang-format off
+        auto qAssets = m_conn.prepareCached(R"(
+            SELECT
+                a.id_asset_element AS id,
+                a.name             AS name,
+                e.name             AS type,
+                d.name             AS subType,
+                p.name             AS parentName,
+                a.status           AS status,
+                a.priority         AS priority,
+                a.asset_tag        AS tag,
+                a.id_secondary     AS idSecondary
+            FROM t_bios_asset_element AS a
+                INNER JOIN t_bios_asset_device_type AS d
+                INNER JOIN t_bios_asset_element_type AS e
+                ON a.id_type = e.id_asset_element_type AND a.id_subtype = d.id_asset_device_type
+                LEFT JOIN t_bios_asset_element AS p
+                ON a.id_parent = p.id_asset_element
+            WHERE a.name IN ()" + params + R"()
+            ORDER BY a.id_asset_element
+        )");
+
+        auto qExt = m_conn.prepareCached(R"(
+            SELECT
+                x.id_asset_element AS id,
+                x.keytag,
+                x.value,
+                x.read_only
+            FROM
+                t_bios_asset_ext_attributes AS x
+            INNER JOIN
+                t_bios_asset_element AS a ON x.id_asset_element = a.id_asset_element
+            WHERE a.name IN ()" + params + R"()
+            ORDER BY x.id_asset_element
+        )");
+
+        auto qLinks = m_conn.prepareCached(R"(
+            SELECT
+                l.id_asset_device_dest  AS id,
+                l.id_link               AS link_id,
+                e.name                  AS name,
+                l.src_out               AS srcOut,
+                l.dest_in               AS destIn,
+                l.id_asset_link_type    AS linkType,
+                t.keytag                AS keytag,
+                t.value                 AS value,
+                t.read_only             AS read_only
+            FROM
+                t_bios_asset_link AS l
+            INNER JOIN
+                t_bios_asset_element AS e ON l.id_asset_device_src = e.id_asset_element
+            INNER JOIN
+                t_bios_asset_element AS a ON l.id_asset_device_dest = a.id_asset_element
+            LEFT JOIN
+                t_bios_asset_link_attributes AS t ON t.id_link = l.id_link
+            WHERE a.name IN ()" + params + R"()
+            ORDER BY l.id_asset_device_dest, l.id_link
+        )");
+        // clang-format on
+
+        for (size_t i = 0; i < count; ++i) {
+            const std::string name = "n" + std::to_string(i);
+            qAssets.set(name, inames[start + i]);
+            qExt.set(name, inames[start + i]);
+            qLinks.set(name, inames[start + i]);
+        }
+
+        tntdb::Result assets;
+        tntdb::Result ext;
+        tntdb::Result links;
+
+        try {
+            Lock lock(m_conn_lock);
+            assets = qAssets.select();
+            ext    = qExt.select();
+            links  = qLinks.select();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+
+        mergeAssetRows(assets, ext, links, callback);
+    }
+}
+
+std::vector<std::string> DB::inamesByUuids(const std::vector<std::string>& uuids)
+{
+    std::vector<std::string> inames;
+
+    for (size_t start = 0; start < uuids.size(); start += LOAD_CHUNK) {
+        size_t count = std::min(LOAD_CHUNK, uuids.size() - start);
+
+        // clang-format off
+        auto q = m_conn.prepareCached(R"(
+            SELECT
+                a.name
+            FROM
+                t_bios_asset_element AS a
+            INNER JOIN
+                t_bios_asset_ext_attributes AS x ON x.id_asset_element = a.id_asset_element
+            WHERE
+                x.keytag = "uuid" AND x.value IN ()" + namesParams(count) + R"()
+        )");
+        // clang-format on
+
+        for (size_t i = 0; i < count; ++i) {
+            q.set("n" + std::to_string(i), uuids[start + i]);
+        }
+
+        tntdb::Result res;
+
+        try {
+            Lock lock(m_conn_lock);
+            res = q.select();
+
+        } catch (std::exception& e) {
+
+            throw std::runtime_error("database error - " + std::string(e.what()));
+        }
+
+        for (const auto& row : res) {
+            inames.push_back(row.getString("name"));
+        }
+    }
+
+    return inames;
+}
+
+GroupRelations DB::listGroupRelations()
+{
+    GroupRelations relations;
+
+    // clang-format off
+    auto q = m_conn.prepareCached(R"(
+        SELECT
+            a.name AS asset,
+            g.name AS grp
+        FROM t_bios_asset_group_relation AS r
+            INNER JOIN t_bios_asset_element AS a
+            ON r.id_asset_element = a.id_asset_element
+            INNER JOIN t_bios_asset_element AS g
+            ON r.id_asset_group = g.id_asset_element
+    )");
+    // clang-format on
+
+    tntdb::Result res;
+
+    try {
+        Lock lock(m_conn_lock);
+        res = q.select();
+
+    } catch (std::exception& e) {
+
+        throw std::runtime_error("database error - " + std::string(e.what()));
+    }
+
+    relations.reserve(res.size());
+    for (const auto& row : res) {
+        relations.emplace_back(row.getString("asset"), row.getString("grp"));
+    }
+
+    return relations;
+}
+
+void DB::saveGroupRelations(const GroupRelations& groups)
+{
+    // clang-format off
+    auto q = m_conn.prepareCached(R"(
+        INSERT IGNORE INTO t_bios_asset_group_relation
+            (id_asset_group, id_asset_element)
+        SELECT
+            g.id_asset_element, a.id_asset_element
+        FROM t_bios_asset_element AS g, t_bios_asset_element AS a
+        WHERE g.name = :grp AND a.name = :asset
+    )");
+    // clang-format on
+
+    try {
+        Lock lock(m_conn_lock);
+        tntdb::Transaction trans(m_conn);
+        for (const auto& relation : groups) {
+            q.set("asset", relation.first).set("grp", relation.second).execute();
+        }
+        trans.commit();
+
+    } catch (std::exception& e) {
+
+        throw std::runtime_error("database error - " + std::string(e.what()));
+    }
+}
+
 } // namespace fty
@@ -35,6 +35,9 @@ class DB : public AssetStorage
 public:
     static DB& getInstance();
 
+    /// standalone instance holding its own pooled connection, for use from worker threads
+    static std::unique_ptr<DB> create();
+
     void loadAsset(const std::string& nameId, Asset& asset);
 
     void                     loadExtMap(Asset& asset);
@@ -76,6 +79,13 @@ public:
     std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters);
     std::vector<std::string> listAllAssets();
 
+    void loadAllAssets(const std::function<void(const Asset&)>& callback);
+    void loadAssets(const std::vector<std::string>& inames, const std::function<void(const Asset&)>& callback);
+    std::vector<std::string> inamesByUuids(const std::vector<std::string>& uuids);
+
+    GroupRelations listGroupRelations();
+    void           saveGroupRelations(const GroupRelations& groups);
+
 private:
     DB();
     void makeName(std::string& name);
@@ -0,0 +1,260 @@
+/*  =========================================================================
+    asset_asset_journal - asset/asset-journal
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "asset-journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+#include <fty_log.h>
+#include <unistd.h>
+#include <vector>
+
+#include "fty-lock.h"
+
+namespace fty {
+
+static constexpr const char* JOURNAL_HEADER = "FTYJOURNAL 1";
+static constexpr const char* JOURNAL_END    = "END\n"; // last line of a journal closed on clean shutdown
+
+// rewrite the log once it holds that many times more lines than live entries
+static constexpr size_t COMPACT_RATIO = 4;
+static constexpr size_t COMPACT_MIN   = 1024;
+
+static uint64_t clockSequence()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+ChangeJournal& ChangeJournal::instance()
+{
+    static ChangeJournal journal;
+    return journal;
+}
+
+ChangeJournal::ChangeJournal()
+    : m_origin(clockSequence())
+    , m_sequence(m_origin)
+{
+}
+
+ChangeJournal::~ChangeJournal()
+{
+    close();
+}
+
+void ChangeJournal::open(const std::string& path)
+{
+    Lock lock(m_lock);
+
+    close();
+    m_path = path;
+
+    std::error_code ec;
+    auto            dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty() && !std::filesystem::create_directories(dir, ec) && ec) {
+        log_error("Cannot create journal directory %s (%s)", dir.c_str(), ec.message().c_str());
+    }
+
+    if (FILE* f = fopen(path.c_str(), "r")) {
+        load(f);
+        fclose(f);
+    }
+
+    rewrite();
+}
+
+void ChangeJournal::load(FILE* f)
+{
+    const size_t headerLen = strlen(JOURNAL_HEADER);
+    char         header[64];
+    uint64_t     origin = 0;
+    if (!fgets(header, sizeof(header), f) || strncmp(header, JOURNAL_HEADER, headerLen) != 0 ||
+        sscanf(header + headerLen, " %" SCNu64, &origin) != 1) {
+        log_error("Journal %s is not valid, starting a new one", m_path.c_str());
+        return;
+    }
+
+    std::unordered_map<std::string, Entry> entries;
+
+    uint64_t seq    = 0;
+    char     change = 0;
+    char     iname[256];
+    while (fscanf(f, "%" SCNu64 " %c %255[^\n]\n", &seq, &change, iname) == 3) {
+        Entry& entry = entries[iname];
+        if (seq > entry.sequence) {
+            entry.sequence = seq;
+            entry.change   = (change == 'D') ? Change::Deleted : Change::Updated;
+        }
+        // numbers are never reused, even from a journal which is not loaded
+        m_sequence = std::max(m_sequence, seq);
+    }
+
+    // changes of an agent which did not stop cleanly may not be recorded, the new journal starts after all
+    // numbers read
+    if (feof(f)) {
+        log_error("Journal %s was not closed, starting a new one", m_path.c_str());
+        restart();
+        return;
+    }
+
+    // changes after a bad line are lost
+    char end[8];
+    if (!fgets(end, sizeof(end), f) || strcmp(end, JOURNAL_END) != 0 || fgetc(f) != EOF) {
+        log_error("Journal %s is corrupted, starting a new one", m_path.c_str());
+        restart();
+        return;
+    }
+
+    // loaded journal covers changes since its own origin
+    m_origin = origin;
+    for (auto& it : entries) {
+        Entry& entry = m_entries[it.first];
+        if (it.second.sequence > entry.sequence) {
+            entry = it.second;
+        }
+    }
+}
+
+// numbers read are never reused
+void ChangeJournal::restart()
+{
+    m_origin   = std::max(m_sequence, m_origin) + 1;
+    m_sequence = m_origin;
+}
+
+void ChangeJournal::rewrite()
+{
+    std::vector<std::pair<std::string, Entry>> entries(m_entries.begin(), m_entries.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& l, const auto& r) {
+        return l.second.sequence < r.second.sequence;
+    });
+
+    std::string tmp = m_path + ".tmp";
+    FILE*       f   = fopen(tmp.c_str(), "w");
+    if (!f) {
+        dropFile(strerror(errno));
+        return;
+    }
+
+    bool ok = fprintf(f, "%s %" PRIu64 "\n", JOURNAL_HEADER, m_origin) > 0;
+    for (const auto& it : entries) {
+        ok = fprintf(f, "%" PRIu64 " %c %s\n", it.second.sequence, it.second.change == Change::Deleted ? 'D' : 'U',
+                 it.first.c_str()) > 0 && ok;
+    }
+
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), m_path.c_str()) != 0) {
+        int err = errno;
+        unlink(tmp.c_str());
+        dropFile(strerror(err));
+        return;
+    }
+
+    m_log = fopen(m_path.c_str(), "a");
+    if (!m_log) {
+        dropFile(strerror(errno));
+        return;
+    }
+    m_logLines = entries.size();
+}
+
+// clean shutdown: a later start can continue this journal
+void ChangeJournal::close()
+{
+    if (m_log) {
+        if (fputs(JOURNAL_END, m_log) < 0) {
+            log_error("Cannot close journal %s (%s)", m_path.c_str(), strerror(errno));
+        }
+        fclose(m_log);
+        m_log = nullptr;
+    }
+}
+
+// the file would miss the next changes: a later start must not load it
+void ChangeJournal::dropFile(const char* reason)
+{
+    log_error("Cannot write journal %s (%s), changes are kept in memory only", m_path.c_str(), reason);
+
+    if (m_log) {
+        fclose(m_log);
+        m_log = nullptr;
+    }
+    unlink(m_path.c_str());
+    m_path.clear();
+}
+
+uint64_t ChangeJournal::record(const std::string& iname, Change change)
+{
+    Lock lock(m_lock);
+
+    Entry& entry   = m_entries[iname];
+    entry.sequence = ++m_sequence;
+    entry.change   = change;
+
+    if (m_log) {
+        if (fprintf(m_log, "%" PRIu64 " %c %s\n", entry.sequence, change == Change::Deleted ? 'D' : 'U',
+                iname.c_str()) < 0 ||
+            fflush(m_log) != 0) {
+            dropFile(strerror(errno));
+        } else if (++m_logLines > std::max(COMPACT_MIN, COMPACT_RATIO * m_entries.size())) {
+            fclose(m_log);
+            m_log = nullptr;
+            rewrite();
+        }
+    }
+
+    return entry.sequence;
+}
+
+uint64_t ChangeJournal::sequence() const
+{
+    Lock lock(m_lock);
+    return m_sequence;
+}
+
+uint64_t ChangeJournal::origin() const
+{
+    Lock lock(m_lock);
+    return m_origin;
+}
+
+bool ChangeJournal::since(uint64_t sequence, Changes& changes) const
+{
+    Lock lock(m_lock);
+
+    // before the journal started, or from another journal
+    if (sequence < m_origin || sequence > m_sequence) {
+        return false;
+    }
+
+    for (const auto& it : m_entries) {
+        if (it.second.sequence > sequence) {
+            changes.emplace(it.first, it.second);
+        }
+    }
+    return true;
+}
+
+} // namespace fty
@@ -0,0 +1,94 @@
+/*  =========================================================================
+    asset_asset_journal - asset/asset-journal
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fty {
+
+/// Process-wide journal of asset changes, used by incremental SRR save
+///
+/// Every recorded change gets a new, monotonically increasing sequence number and only the last change of
+/// each asset is kept. The journal is persisted as an append-only log which is compacted when opened.
+/// The first sequence of a journal is derived from the clock, so a lost journal never reuses old numbers:
+/// changes since a sequence older than origin() are unknown and need a full save.
+/// A journal file which may miss changes (write error, corrupted content) is never loaded again: the file is
+/// removed and a new journal starts, with a new origin. The same holds for a file which was not closed on a clean
+/// shutdown (end marker missing), changes of a crashed agent may not have been recorded.
+class ChangeJournal
+{
+public:
+    enum class Change
+    {
+        Updated,
+        Deleted
+    };
+
+    struct Entry
+    {
+        uint64_t sequence = 0;
+        Change   change   = Change::Updated;
+    };
+
+    using Changes = std::map<std::string, Entry>;
+
+    /// process-wide journal, other instances are for tests
+    static ChangeJournal& instance();
+
+    ChangeJournal();
+    ~ChangeJournal();
+
+    ChangeJournal(const ChangeJournal&) = delete;
+    ChangeJournal& operator=(const ChangeJournal&) = delete;
+
+    /// open (or create) journal file and its directory, journal stays in memory only if it cannot be written
+    void open(const std::string& path);
+
+    uint64_t record(const std::string& iname, Change change);
+
+    uint64_t sequence() const;
+    uint64_t origin() const;
+
+    /// changes with sequence greater than `sequence`, returns false if journal does not cover it
+    bool since(uint64_t sequence, Changes& changes) const;
+
+private:
+    void load(FILE* f);
+    void restart();
+    void rewrite();
+    void close();
+    void dropFile(const char* reason);
+
+    mutable std::mutex                     m_lock;
+    std::string                            m_path;
+    FILE*                                  m_log      = nullptr;
+    uint64_t                               m_origin   = 0;
+    uint64_t                               m_sequence = 0;
+    size_t                                 m_logLines = 0;
+    std::unordered_map<std::string, Entry> m_entries;
+};
+
+} // namespace fty
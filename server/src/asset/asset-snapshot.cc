@@ -0,0 +1,447 @@
+/*  =========================================================================
+    asset_asset_snapshot - asset/asset-snapshot
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "asset-snapshot.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fty_log.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fty {
+
+static constexpr char     SNAPSHOT_MAGIC[8]   = {'F', 'T', 'Y', 'A', 'S', 'N', 'A', 'P'};
+static constexpr uint16_t SNAPSHOT_MAJOR      = 1;
+static constexpr uint16_t SNAPSHOT_MINOR      = 0;
+static constexpr size_t   SNAPSHOT_HEADER_LEN = 32;
+static constexpr size_t   RECORD_HEADER_LEN   = 5;
+
+enum RecordType : uint8_t
+{
+    RECORD_ASSET = 1,
+    RECORD_GROUP = 2
+};
+
+// ===========================================================================================================
+// encoding helpers
+
+static void putFixed(std::string& buf, uint64_t val, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        buf.push_back(static_cast<char>((val >> (8 * i)) & 0xff));
+    }
+}
+
+static void setFixed(std::string& buf, size_t offset, uint64_t val, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        buf[offset + i] = static_cast<char>((val >> (8 * i)) & 0xff);
+    }
+}
+
+static void putVarint(std::string& buf, uint64_t val)
+{
+    while (val >= 0x80) {
+        buf.push_back(static_cast<char>((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    buf.push_back(static_cast<char>(val));
+}
+
+static uint64_t getFixed(const char* data, size_t len)
+{
+    uint64_t val = 0;
+    for (size_t i = 0; i < len; ++i) {
+        val |= uint64_t(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return val;
+}
+
+/// bounds checked cursor over a snapshot region
+class Cursor
+{
+public:
+    Cursor(const char* data, size_t size)
+        : m_pos(data)
+        , m_end(data + size)
+    {
+    }
+
+    bool atEnd() const
+    {
+        return m_pos == m_end;
+    }
+
+    const char* take(size_t len)
+    {
+        if (size_t(m_end - m_pos) < len) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+        const char* ret = m_pos;
+        m_pos += len;
+        return ret;
+    }
+
+    uint64_t fixed(size_t len)
+    {
+        return getFixed(take(len), len);
+    }
+
+    uint64_t varint()
+    {
+        uint64_t val = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*take(1));
+            val |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return val;
+            }
+        }
+        throw std::runtime_error("Snapshot contains malformed integer");
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+// ===========================================================================================================
+
+SnapshotWriter::SnapshotWriter()
+{
+    reset();
+}
+
+void SnapshotWriter::reset()
+{
+    m_buffer.clear();
+    m_index.clear();
+    m_strings.clear();
+    m_records = 0;
+
+    m_buffer.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    putFixed(m_buffer, SNAPSHOT_MAJOR, 2);
+    putFixed(m_buffer, SNAPSHOT_MINOR, 2);
+    putFixed(m_buffer, 0, 4);  // flags
+    putFixed(m_buffer, 0, 8);  // string table offset, set by finish()
+    putFixed(m_buffer, 0, 4);  // record count, set by finish()
+    putFixed(m_buffer, 0, 4);  // reserved
+
+    intern("");
+}
+
+uint32_t SnapshotWriter::intern(const std::string& str)
+{
+    auto it = m_index.find(str);
+    if (it != m_index.end()) {
+        return it->second;
+    }
+
+    uint32_t id = uint32_t(m_strings.size());
+    it          = m_index.emplace(str, id).first;
+    m_strings.push_back(&it->first);
+    return id;
+}
+
+void SnapshotWriter::beginRecord(uint8_t type)
+{
+    m_recordStart = m_buffer.size();
+    m_buffer.push_back(static_cast<char>(type));
+    putFixed(m_buffer, 0, 4);
+}
+
+void SnapshotWriter::endRecord()
+{
+    setFixed(m_buffer, m_recordStart + 1, m_buffer.size() - m_recordStart - RECORD_HEADER_LEN, 4);
+    ++m_records;
+}
+
+void SnapshotWriter::putString(const std::string& str)
+{
+    putVarint(m_buffer, intern(str));
+}
+
+void SnapshotWriter::putExt(const std::map<std::string, ExtMapElement>& ext)
+{
+    putVarint(m_buffer, ext.size());
+    for (const auto& e : ext) {
+        putString(e.first);
+        putString(e.second.getValue());
+        m_buffer.push_back(e.second.isReadOnly() ? 1 : 0);
+    }
+}
+
+// same layout as the map one, read straight from the asset
+void SnapshotWriter::putExt(const Asset& asset)
+{
+    size_t count = 0;
+    asset.forEachExt([&](const std::string&, const ExtMapElement&) {
+        ++count;
+    });
+
+    putVarint(m_buffer, count);
+    asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+        putString(key);
+        putString(element.getValue());
+        m_buffer.push_back(element.isReadOnly() ? 1 : 0);
+    });
+}
+
+void SnapshotWriter::addAsset(const Asset& asset)
+{
+    beginRecord(RECORD_ASSET);
+
+    putString(asset.getInternalName());
+    putString(asset.getAssetType());
+    putString(asset.getAssetSubtype());
+    putString(asset.getParentIname());
+    putString(asset.getAssetTag());
+    putString(asset.getSecondaryID());
+    m_buffer.push_back(static_cast<char>(asset.getAssetStatus()));
+    putVarint(m_buffer, uint64_t(asset.getPriority()));
+
+    putExt(asset);
+
+    putVarint(m_buffer, asset.getLinkedAssets().size());
+    for (const auto& l : asset.getLinkedAssets()) {
+        putString(l.sourceId());
+        putString(l.srcOut());
+        putString(l.destIn());
+        putVarint(m_buffer, uint64_t(l.linkType()));
+        putExt(l.ext());
+    }
+
+    endRecord();
+}
+
+void SnapshotWriter::addGroupRelation(const std::string& asset, const std::string& group)
+{
+    beginRecord(RECORD_GROUP);
+    putString(asset);
+    putString(group);
+    endRecord();
+}
+
+std::string SnapshotWriter::finish()
+{
+    setFixed(m_buffer, 16, m_buffer.size(), 8);
+    setFixed(m_buffer, 24, m_records, 4);
+
+    putVarint(m_buffer, m_strings.size());
+    for (const std::string* str : m_strings) {
+        putVarint(m_buffer, str->size());
+        m_buffer.append(*str);
+    }
+
+    std::string ret = std::move(m_buffer);
+    reset();
+
+    return ret;
+}
+
+// ===========================================================================================================
+
+bool SnapshotReader::isSnapshot(const char* data, size_t size)
+{
+    return size >= sizeof(SNAPSHOT_MAGIC) && memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+SnapshotReader::SnapshotReader(const char* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+{
+    if (!isSnapshot(data, size) || size < SNAPSHOT_HEADER_LEN) {
+        throw std::runtime_error("Not an asset snapshot");
+    }
+
+    Cursor header(data + sizeof(SNAPSHOT_MAGIC), SNAPSHOT_HEADER_LEN - sizeof(SNAPSHOT_MAGIC));
+    m_major = uint16_t(header.fixed(2));
+    m_minor = uint16_t(header.fixed(2));
+    header.fixed(4); // flags
+    m_stringsOffset = size_t(header.fixed(8));
+    m_records       = uint32_t(header.fixed(4));
+
+    // newer minor versions only add record types, which are skipped
+    if (m_major > SNAPSHOT_MAJOR) {
+        throw std::runtime_error("Snapshot version " + std::to_string(m_major) + "." + std::to_string(m_minor) +
+                                 " is not supported");
+    }
+    if (m_stringsOffset < SNAPSHOT_HEADER_LEN || m_stringsOffset > size) {
+        throw std::runtime_error("Snapshot string table offset is invalid");
+    }
+
+    Cursor strings(data + m_stringsOffset, size - m_stringsOffset);
+    size_t count = size_t(strings.varint());
+    m_strings.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t len = size_t(strings.varint());
+        m_strings.emplace_back(strings.take(len), len);
+    }
+}
+
+void SnapshotReader::read(std::vector<AssetImpl>& assets, GroupRelations& groups) const
+{
+    auto str = [&](Cursor& c) -> std::string {
+        uint64_t id = c.varint();
+        if (id >= m_strings.size()) {
+            throw std::runtime_error("Snapshot references unknown string " + std::to_string(id));
+        }
+        return std::string(m_strings[id]);
+    };
+
+    auto linkExt = [&](Cursor& c, AssetLink::ExtMap& map) {
+        uint64_t count = c.varint();
+        for (uint64_t i = 0; i < count; ++i) {
+            std::string key      = str(c);
+            std::string value    = str(c);
+            bool        readOnly = *c.take(1) != 0;
+            map.emplace(std::move(key), ExtMapElement(value, readOnly));
+        }
+    };
+
+    assets.reserve(assets.size() + m_records);
+
+    Cursor records(m_data + SNAPSHOT_HEADER_LEN, m_stringsOffset - SNAPSHOT_HEADER_LEN);
+    while (!records.atEnd()) {
+        uint8_t type = static_cast<uint8_t>(*records.take(1));
+        size_t  len  = size_t(records.fixed(4));
+        Cursor  rec(records.take(len), len);
+
+        if (type == RECORD_ASSET) {
+            AssetImpl a;
+            a.setInternalName(str(rec));
+            a.setAssetType(str(rec));
+            a.setAssetSubtype(str(rec));
+            a.setParentIname(str(rec));
+            a.setAssetTag(str(rec));
+            a.setSecondaryID(str(rec));
+            a.setAssetStatus(AssetStatus(static_cast<uint8_t>(*rec.take(1))));
+            a.setPriority(int(rec.varint()));
+
+            uint64_t attributes = rec.varint();
+            for (uint64_t i = 0; i < attributes; ++i) {
+                std::string key      = str(rec);
+                std::string value    = str(rec);
+                bool        readOnly = *rec.take(1) != 0;
+                a.setExtEntry(key, value, readOnly);
+            }
+
+            uint64_t links = rec.varint();
+            for (uint64_t i = 0; i < links; ++i) {
+                std::string source   = str(rec);
+                std::string srcOut   = str(rec);
+                std::string destIn   = str(rec);
+                int         linkType = int(rec.varint());
+
+                AssetLink::ExtMap linkAttributes;
+                linkExt(rec, linkAttributes);
+
+                a.addLink(source, srcOut, destIn, linkType, linkAttributes);
+            }
+
+            assets.push_back(std::move(a));
+        } else if (type == RECORD_GROUP) {
+            std::string asset = str(rec);
+            std::string group = str(rec);
+            groups.emplace_back(std::move(asset), std::move(group));
+        } else {
+            log_debug("Skipping unknown snapshot record type %d", int(type));
+        }
+    }
+}
+
+// ===========================================================================================================
+
+SnapshotFile::SnapshotFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " + strerror(err));
+    }
+
+    m_size = size_t(st.st_size);
+    if (m_size > 0) {
+        void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " + strerror(err));
+        }
+        m_data = static_cast<const char*>(addr);
+    }
+    close(fd);
+}
+
+SnapshotFile::~SnapshotFile()
+{
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+void SnapshotFile::write(const std::string& path, const std::string& snapshot)
+{
+    std::error_code ec;
+    auto            dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty() && !std::filesystem::create_directories(dir, ec) && ec) {
+        throw std::runtime_error("Cannot create directory of " + path + ": " + ec.message());
+    }
+
+    std::string tmp = path + ".tmp";
+
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) {
+        throw std::runtime_error("Cannot open " + tmp + ": " + strerror(errno));
+    }
+
+    bool ok = fwrite(snapshot.data(), 1, snapshot.size(), f) == snapshot.size();
+    ok      = (fflush(f) == 0) && ok;
+    ok      = (fsync(fileno(f)) == 0) && ok;
+    ok      = (fclose(f) == 0) && ok;
+
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        int err = errno;
+        unlink(tmp.c_str());
+        throw std::runtime_error("Cannot write " + path + ": " + strerror(err));
+    }
+}
+
+std::string SnapshotFile::path(const std::string& dir, const std::string& name)
+{
+    if (name.empty() || name == "." || name == ".." || name.find('/') != std::string::npos) {
+        throw std::runtime_error("Invalid snapshot name '" + name + "'");
+    }
+    return dir + "/" + name;
+}
+
+} // namespace fty
@@ -0,0 +1,146 @@
+/*  =========================================================================
+    asset_asset_snapshot - asset/asset-snapshot
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+#include "asset-storage.h"
+#include "asset.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+/// Binary inventory snapshot
+///
+/// Layout (all integers little endian):
+///   header   : magic "FTYASNAP", u16 major version, u16 minor version, u32 flags, u64 string table offset,
+///              u32 record count, u32 reserved
+///   records  : u8 type, u32 payload length, payload
+///   strings  : varint count, then varint length + bytes for each string (index 0 is the empty string)
+///
+/// Record payloads reference strings by their varint index in the string table, so type, subtype and ext keys
+/// are stored once per snapshot. Unknown record types are skipped by length, which keeps older readers able
+/// to load newer snapshots of the same major version: new record types only bump the minor version, the major
+/// version changes when existing records change and readers reject newer major versions.
+class SnapshotWriter
+{
+public:
+    SnapshotWriter();
+
+    void addAsset(const Asset& asset);
+    void addGroupRelation(const std::string& asset, const std::string& group);
+
+    size_t recordCount() const
+    {
+        return m_records;
+    }
+
+    /// finalize snapshot (string table and header), the writer is reset afterwards
+    std::string finish();
+
+private:
+    void     reset();
+    uint32_t intern(const std::string& str);
+    void     beginRecord(uint8_t type);
+    void     endRecord();
+    void     putString(const std::string& str);
+    void     putExt(const std::map<std::string, ExtMapElement>& ext);
+    void     putExt(const Asset& asset);
+
+    std::string                               m_buffer;
+    size_t                                    m_recordStart = 0;
+    uint32_t                                  m_records     = 0;
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<const std::string*>           m_strings;
+};
+
+/// Reads a snapshot in place, the buffer (e.g. a mapped file) must outlive the reader
+class SnapshotReader
+{
+public:
+    SnapshotReader(const char* data, size_t size);
+
+    uint16_t majorVersion() const
+    {
+        return m_major;
+    }
+
+    uint16_t minorVersion() const
+    {
+        return m_minor;
+    }
+
+    size_t recordCount() const
+    {
+        return m_records;
+    }
+
+    void read(std::vector<AssetImpl>& assets, GroupRelations& groups) const;
+
+    /// true if buffer starts with snapshot magic
+    static bool isSnapshot(const char* data, size_t size);
+
+private:
+    const char*                   m_data;
+    size_t                        m_size;
+    uint16_t                      m_major         = 0;
+    uint16_t                      m_minor         = 0;
+    uint32_t                      m_records       = 0;
+    size_t                        m_stringsOffset = 0;
+    std::vector<std::string_view> m_strings;
+};
+
+/// Read-only memory mapping of a snapshot file
+class SnapshotFile
+{
+public:
+    explicit SnapshotFile(const std::string& path);
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    const char* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /// write snapshot atomically (temporary file + rename), missing directories are created
+    static void write(const std::string& path, const std::string& snapshot);
+
+    /// directory of the snapshots saved and loaded through the SNAPSHOT mailbox subject
+    static constexpr const char* DIR = "/var/lib/fty/fty-asset/snapshots";
+
+    /// path of snapshot `name` in `dir`, throws if name is not a plain file name
+    static std::string path(const std::string& dir, const std::string& name);
+
+private:
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+};
+
+} // namespace fty
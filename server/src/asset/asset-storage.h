@@ -21,8 +21,10 @@
 
 #pragma once
 #include <fty/expected.h>
+#include <functional>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace fty {
@@ -30,6 +32,9 @@ namespace fty {
 class Asset;
 class AssetLink;
 
+/// group membership as (asset iname, group iname) pairs
+using GroupRelations = std::vector<std::pair<std::string, std::string>>;
+
 class AssetStorage
 {
 public:
@@ -75,6 +80,17 @@ public:
 
     virtual std::vector<std::string> listAssets(std::map<std::string, std::vector<std::string>> filters) = 0;
     virtual std::vector<std::string> listAllAssets()                                                     = 0;
+
+    /// set-based load of every asset (with ext attributes and links), callback is invoked once per asset
+    virtual void loadAllAssets(const std::function<void(const Asset&)>& callback) = 0;
+    /// set-based load of the given assets, callback is invoked once per asset found
+    virtual void loadAssets(
+        const std::vector<std::string>& inames, const std::function<void(const Asset&)>& callback) = 0;
+    /// internal names of the assets with the given UUIDs, UUIDs not found are skipped
+    virtual std::vector<std::string> inamesByUuids(const std::vector<std::string>& uuids) = 0;
+
+    virtual GroupRelations listGroupRelations()                            = 0;
+    virtual void           saveGroupRelations(const GroupRelations& groups) = 0;
 };
 
 } // namespace fty
@@ -26,6 +26,7 @@
 #include "asset-storage.h"
 #include "asset/dbhelpers.h"
 #include <asset/asset-helpers.h>
+#include <fty_asset_id_resolver.h>
 #include <fty_common_mlm.h>
 #include <fty_common.h>
 #include <fty_common_db_dbpath.h>
@@ -33,6 +34,8 @@
 #include <fty/string-utils.h>
 #include <fty_common_agents.h>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #define AGENT_ASSET_ACTIVATOR "etn-licensing-credits"
 
@@ -224,19 +227,43 @@ AssetImpl& AssetImpl::operator=(const AssetImpl& a)
     return *this;
 }
 
+AssetImpl::AssetImpl(AssetImpl&& a) noexcept
+    : Asset(std::move(a))
+    , m_storage(a.m_storage)
+{
+}
+
+AssetImpl& AssetImpl::operator=(AssetImpl&& a) noexcept
+{
+    if (&a == this) {
+        return *this;
+    }
+    Asset::operator=(std::move(a));
+
+    return *this;
+}
+
 bool AssetImpl::hasLogicalAsset() const
 {
-    return getExt().find("logical_asset") != getExt().end();
+    bool found = false;
+    forEachExt([&](const std::string& key, const ExtMapElement&) {
+        found = found || key == "logical_asset";
+    });
+    return found;
 }
 
 bool AssetImpl::isVirtual() const
 {
+    return isVirtualType(getAssetTypeSymbol());
+}
 
-    return ((getAssetType() == TYPE_INFRA_SERVICE) || (getAssetType() == TYPE_CLUSTER) || (getAssetType() == TYPE_HYPERVISOR) ||
-            (getAssetType() == TYPE_VIRTUAL_MACHINE) || (getAssetType() == TYPE_STORAGE_SERVICE) ||
-            (getAssetType() == TYPE_VAPP) || (getAssetType() == TYPE_CONNECTOR) ||
-            (getAssetType() == TYPE_SERVER) || (getAssetType() == TYPE_PLANNER) ||
-            (getAssetType() == TYPE_OPERATING_SYSTEM) || (getAssetType() == TYPE_PLAN));
+bool AssetImpl::isVirtualType(const Symbol& type)
+{
+    static const std::unordered_set<Symbol> virtualTypes = {TYPE_INFRA_SERVICE, TYPE_CLUSTER, TYPE_HYPERVISOR,
+        TYPE_VIRTUAL_MACHINE, TYPE_STORAGE_SERVICE, TYPE_VAPP, TYPE_CONNECTOR, TYPE_SERVER, TYPE_PLANNER,
+        TYPE_OPERATING_SYSTEM, TYPE_PLAN};
+
+    return virtualTypes.count(type) != 0;
 }
 
 bool AssetImpl::hasLinkedAssets() const
@@ -385,7 +412,7 @@ void AssetImpl::create()
 
     // create CAM mappings
     try {
-        auto credentialList = getCredentialMappings(getExt());
+        auto credentialList = getCredentialMappings(*this);
         createMappings(getInternalName(), credentialList);
     } catch (const std::exception& e) {
         log_error("Failed to update CAM: %s", e.what());
@@ -415,7 +442,7 @@ void AssetImpl::update()
     // update CAM mappings
     try {
         deleteMappings(getInternalName());
-        auto credentialList = getCredentialMappings(getExt());
+        auto credentialList = getCredentialMappings(*this);
         createMappings(getInternalName(), credentialList);
     } catch (const std::exception& e) {
         log_error("Failed to update CAM: %s", e.what());
@@ -448,13 +475,94 @@ void AssetImpl::restore(bool restoreLinks)
 
     // create CAM mappings
     try {
-        auto credentialList = getCredentialMappings(getExt());
+        auto credentialList = getCredentialMappings(*this);
         createMappings(getInternalName(), credentialList);
     } catch (const std::exception& e) {
         log_error("Failed to update CAM: %s", e.what());
     }
 }
 
+std::vector<AssetImpl*> AssetImpl::restoreList(const std::vector<AssetImpl*>& assets)
+{
+    return restoreList(assets, getStorage());
+}
+
+std::vector<AssetImpl*> AssetImpl::restoreList(const std::vector<AssetImpl*>& assets, AssetStorage& storage)
+{
+    std::vector<AssetImpl*> restored;
+    restored.reserve(assets.size());
+
+    storage.beginTransaction();
+    try {
+        for (AssetImpl* a : assets) {
+            // restore only if asset is not already in db
+            if (storage.getID(a->getInternalName())) {
+                log_error("Asset %s already exists, restore is not possible", a->getInternalName().c_str());
+                continue;
+            }
+            try {
+                // set creation timestamp
+                a->setExtEntry(fty::EXT_CREATE_TS, generateCurrentTimestamp(), true);
+
+                storage.insert(*a);
+                storage.saveExtMap(*a);
+                restored.push_back(a);
+            } catch (const std::exception& e) {
+                log_error("Restore of asset %s failed: %s", a->getInternalName().c_str(), e.what());
+                // drop what was inserted for this asset, keep the rest of the batch
+                if (storage.getID(a->getInternalName())) {
+                    storage.removeExtMap(*a);
+                    storage.removeAsset(*a);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        storage.rollbackTransaction();
+        throw std::runtime_error(e.what());
+    }
+    storage.commitTransaction();
+
+    return restored;
+}
+
+void AssetImpl::restoreMappings(const std::vector<AssetImpl*>& assets)
+{
+    for (AssetImpl* a : assets) {
+        try {
+            auto credentialList = getCredentialMappings(*a);
+            createMappings(a->getInternalName(), credentialList);
+        } catch (const std::exception& e) {
+            log_error("Failed to update CAM: %s", e.what());
+        }
+    }
+}
+
+void AssetImpl::restoreLinksList(const std::vector<AssetImpl*>& assets, AssetStorage& storage)
+{
+    storage.beginTransaction();
+    for (AssetImpl* a : assets) {
+        if (a->getLinkedAssets().empty()) {
+            continue;
+        }
+        try {
+            storage.saveLinkedAssets(*a);
+        } catch (const std::exception& e) {
+            log_error("Restore of links of asset %s failed: %s", a->getInternalName().c_str(), e.what());
+        }
+    }
+    storage.commitTransaction();
+}
+
+std::shared_ptr<AssetStorage> AssetImpl::createStorage()
+{
+    if (g_testMode) {
+        // test storage is stateless
+        return std::shared_ptr<AssetStorage>(&DBTest::getInstance(), [](AssetStorage*) {});
+    } else {
+        return DB::create();
+    }
+}
+
 static std::vector<std::string> sendActivationReq(const std::string & command, const std::vector<std::string> & frames)
 {
     mlm::MlmSyncClient client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
@@ -532,6 +640,71 @@ void AssetImpl::activate()
     }
 }
 
+std::vector<bool> AssetImpl::isActivable(const std::vector<AssetImpl*>& assets)
+{
+    std::vector<bool> result(assets.size(), true);
+
+    if (g_testMode) {
+        return result;
+    }
+
+    std::vector<size_t>      devices;
+    std::vector<std::string> payload;
+    for (size_t i = 0; i < assets.size(); ++i) {
+        if (assets[i]->getAssetType() == TYPE_DEVICE) {
+            devices.push_back(i);
+            payload.push_back(Asset::toFullAsset(*assets[i]).toJson());
+        }
+    }
+
+    auto replies = activation::isActivable(payload);
+    for (size_t i = 0; i < devices.size(); ++i) {
+        if (replies[i]) {
+            result[devices[i]] = *replies[i];
+        } else {
+            log_info("Request failed: %s", replies[i].error().toString().c_str());
+            result[devices[i]] = false;
+        }
+    }
+
+    return result;
+}
+
+std::vector<AssetImpl*> AssetImpl::activate(const std::vector<AssetImpl*>& assets)
+{
+    std::vector<AssetImpl*> failed;
+
+    if (g_testMode) {
+        return failed;
+    }
+
+    std::vector<AssetImpl*>  devices;
+    std::vector<std::string> payload;
+    for (AssetImpl* a : assets) {
+        if (a->getAssetType() == TYPE_DEVICE) {
+            devices.push_back(a);
+            payload.push_back(Asset::toFullAsset(*a).toJson());
+        } else {
+            a->setAssetStatus(fty::AssetStatus::Active);
+            a->m_storage.update(*a);
+        }
+    }
+
+    auto replies = activation::activate(payload);
+    for (size_t i = 0; i < devices.size(); ++i) {
+        AssetImpl* a = devices[i];
+        if (replies[i]) {
+            a->setAssetStatus(fty::AssetStatus::Active);
+            a->m_storage.update(*a);
+            log_debug("Asset %s activated", a->m_internalName.c_str());
+        } else {
+            log_error("Asset %s activation failed", a->m_internalName.c_str());
+            failed.push_back(a);
+        }
+    }
+    return failed;
+}
+
 void AssetImpl::deactivate()
 {
     if (!g_testMode) {
@@ -564,16 +737,20 @@ static std::vector<fty::Asset> buildParentsList(const std::string iname)
     std::vector<fty::Asset> parents;
 
     fty::AssetImpl a(iname);
+    std::string    current = a.getInternalName();
+    std::string    parent  = a.getParentIname();
 
-    while (!a.getParentIname().empty())
+    while (!parent.empty())
     {
-        if (a.getParentIname() == a.getInternalName()) {
-            log_error("Self parent detected (%s)", a.getInternalName().c_str());
+        if (parent == current) {
+            log_error("Self parent detected (%s)", current.c_str());
             break;
         }
 
-        a = fty::AssetImpl(a.getParentIname());
-        parents.push_back(a);
+        fty::AssetImpl p(parent);
+        current = p.getInternalName();
+        parent  = p.getParentIname();
+        parents.push_back(std::move(p));
 
         // secure, avoid infinite loop
         if (parents.size() > 32) break;
@@ -587,7 +764,7 @@ void AssetImpl::updateParentsList()
     m_parentsList = buildParentsList(getInternalName());
 }
 
-void AssetImpl::assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo& si)
+void AssetImpl::assetToSrr(const Asset& asset, cxxtools::SerializationInfo& si)
 {
     // basic
     si.addMember("id") <<= asset.getInternalName();
@@ -640,11 +817,11 @@ void AssetImpl::assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo&
     cxxtools::SerializationInfo& ext = si.addMember("");
 
     cxxtools::SerializationInfo tmpSiExt;
-    for (const auto& e : asset.getExt()) {
-        cxxtools::SerializationInfo& entry = tmpSiExt.addMember(e.first);
-        entry.addMember("value") <<= e.second.getValue();
-        entry.addMember("readOnly") <<= e.second.isReadOnly();
-    }
+    asset.forEachExt([&](const std::string& key, const ExtMapElement& element) {
+        cxxtools::SerializationInfo& entry = tmpSiExt.addMember(key);
+        entry.addMember("value") <<= element.getValue();
+        entry.addMember("readOnly") <<= element.isReadOnly();
+    });
     tmpSiExt.setCategory(cxxtools::SerializationInfo::Category::Object);
     ext = tmpSiExt;
     ext.setName("ext");
@@ -748,6 +925,42 @@ std::vector<std::string> AssetImpl::listAll()
     return getStorage().listAllAssets();
 }
 
+void AssetImpl::loadAll(const std::function<void(const Asset&)>& callback)
+{
+    getStorage().loadAllAssets(callback);
+}
+
+std::vector<AssetImpl> AssetImpl::loadList(const std::vector<std::string>& inames)
+{
+    std::unordered_map<std::string, Asset> loaded;
+    getStorage().loadAssets(inames, [&loaded](const Asset& asset) {
+        loaded.emplace(asset.getInternalName(), asset);
+    });
+
+    std::vector<AssetImpl> assets;
+    assets.reserve(loaded.size());
+    for (const auto& iname : inames) {
+        auto found = loaded.find(iname);
+        if (found != loaded.end()) {
+            assets.emplace_back();
+            static_cast<Asset&>(assets.back()) = std::move(found->second);
+            // requested twice, returned once
+            loaded.erase(found);
+        }
+    }
+    return assets;
+}
+
+GroupRelations AssetImpl::listGroupRelations()
+{
+    return getStorage().listGroupRelations();
+}
+
+void AssetImpl::restoreGroupRelations(const GroupRelations& groups)
+{
+    getStorage().saveGroupRelations(groups);
+}
+
 void AssetImpl::load()
 {
     m_storage.loadAsset(getInternalName(), *this);
@@ -770,7 +983,7 @@ static void addSubTree(const std::string& internalName, std::vector<AssetImpl>&
         std::vector<std::string> children = getChildren(ref);
 
         if (next < children.size()) {
-            stack.push_back(std::make_pair(ref, next + 1));
+            stack.emplace_back(std::move(ref), next + 1);
 
             ref  = children[next];
             next = 0;
@@ -785,7 +998,7 @@ static void addSubTree(const std::string& internalName, std::vector<AssetImpl>&
             if (stack.empty()) {
                 end = true;
             } else {
-                ref  = stack.back().first;
+                ref  = std::move(stack.back().first);
                 next = static_cast<unsigned int>(stack.back().second);
                 stack.pop_back();
             }
@@ -806,7 +1019,7 @@ DeleteStatus AssetImpl::deleteList(const std::vector<std::string>& assets, bool
                 log_info("Asset %s is virtual, skipping delete...", a.getInternalName().c_str());
                 continue;
             }
-            toDel.push_back(a);
+            toDel.push_back(std::move(a));
 
             if (recursive) {
                 addSubTree(iname, toDel);
@@ -863,7 +1076,7 @@ DeleteStatus AssetImpl::deleteList(const std::vector<std::string>& assets, bool
 
         try {
             d.remove(removeLastDC);
-            deleted.push_back({d, "OK"});
+            AssetIdResolver::instance().invalidate(d.getInternalName());
 
             // remove CAM mappings
             try {
@@ -871,9 +1084,12 @@ DeleteStatus AssetImpl::deleteList(const std::vector<std::string>& assets, bool
             } catch (const std::exception& e) {
                 log_error("Failed to update CAM: %s", e.what());
             }
+
+            // toDel is not used anymore
+            deleted.emplace_back(std::move(d), "OK");
         } catch (std::exception& e) {
             log_error("Asset could not be removed: %s", e.what());
-            deleted.push_back({d, "Asset could not be removed: " + std::string(e.what())});
+            deleted.emplace_back(std::move(d), "Asset could not be removed: " + std::string(e.what()));
         }
     }
 
@@ -903,6 +1119,20 @@ uint32_t AssetImpl::getIDFromIname(const std::string& iname)
     return *id;
 }
 
+std::vector<std::string> AssetImpl::getInamesFromUuids(const std::vector<std::string>& uuids)
+{
+    return getStorage().inamesByUuids(uuids);
+}
+
+std::map<std::string, uint32_t> AssetImpl::getIDsFromInames(const std::vector<std::string>& inames)
+{
+    std::map<std::string, uint32_t> ids;
+    for (const auto& it : AssetIdResolver::instance().resolve(inames)) {
+        ids.emplace(it.first, static_cast<uint32_t>(it.second));
+    }
+    return ids;
+}
+
 /// get internal name from database index
 std::string AssetImpl::getInameFromID(const uint32_t id)
 {
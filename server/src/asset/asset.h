@@ -21,8 +21,11 @@
 
 #pragma once
 
+#include "asset-storage.h"
 #include "fty_asset_dto.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -47,8 +50,10 @@ public:
     ~AssetImpl() override;
 
     AssetImpl(const AssetImpl& a);
+    AssetImpl(AssetImpl&& a) noexcept;
 
     AssetImpl& operator=(const AssetImpl& a);
+    AssetImpl& operator=(AssetImpl&& a) noexcept;
 
     // asset operations
     bool hasLinkedAssets() const;
@@ -61,15 +66,40 @@ public:
     bool isActivable();
     void activate();
     void deactivate();
+
+    // batch variants, one licensing request for all the devices
+    static std::vector<bool> isActivable(const std::vector<AssetImpl*>& assets);
+    /// returns the assets which activation failed
+    static std::vector<AssetImpl*> activate(const std::vector<AssetImpl*>& assets);
     void unlinkAll();
 
     void updateParentsList();
 
-    static void assetToSrr(const AssetImpl& asset, cxxtools::SerializationInfo& si);
+    static bool isVirtualType(const Symbol& type);
+
+    /// insert assets (without links) in a single transaction, returns the assets actually restored
+    /// CAM mappings are not created, see restoreMappings()
+    static std::vector<AssetImpl*> restoreList(const std::vector<AssetImpl*>& assets);
+    static std::vector<AssetImpl*> restoreList(const std::vector<AssetImpl*>& assets, AssetStorage& storage);
+    /// create CAM mappings of restored assets, CAM client has a fixed name: agent thread only
+    static void restoreMappings(const std::vector<AssetImpl*>& assets);
+    /// save links of already restored assets in a single transaction
+    static void restoreLinksList(const std::vector<AssetImpl*>& assets, AssetStorage& storage);
+
+    /// storage with its own connection, to be used by a single worker thread
+    static std::shared_ptr<AssetStorage> createStorage();
+
+    static void assetToSrr(const Asset& asset, cxxtools::SerializationInfo& si);
     static void srrToAsset(const cxxtools::SerializationInfo& si, AssetImpl& asset);
 
     static std::vector<std::string> list(const AssetFilters& filters);
     static std::vector<std::string> listAll();
+    static void                     loadAll(const std::function<void(const Asset&)>& callback);
+    /// assets loaded at once, in the order of the names; names not found are skipped
+    static std::vector<AssetImpl> loadList(const std::vector<std::string>& inames);
+
+    static GroupRelations listGroupRelations();
+    static void           restoreGroupRelations(const GroupRelations& groups);
 
     static DeleteStatus deleteList(
         const std::vector<std::string>& assets, bool recursive, bool deleteVirtualAssets = true, bool removeLastDC = false);
@@ -79,6 +109,10 @@ public:
     static uint32_t    getIDFromIname(const std::string& iname);
     static std::string getInameFromID(const uint32_t id);
 
+    // batch variants, names or UUIDs not found are skipped
+    static std::vector<std::string>        getInamesFromUuids(const std::vector<std::string>& uuids);
+    static std::map<std::string, uint32_t> getIDsFromInames(const std::vector<std::string>& inames);
+
     using Asset::operator==;
 
     friend std::vector<std::string> getChildren(const AssetImpl& a);
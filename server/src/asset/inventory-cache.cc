@@ -0,0 +1,133 @@
+/*  =========================================================================
+    asset_inventory_cache - asset/inventory-cache
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "inventory-cache.h"
+#include <algorithm>
+#include <string_view>
+
+namespace fty {
+
+constexpr size_t InventoryCache::DEFAULT_MAX_ENTRIES;
+
+// FNV-1a, 64 bits on every platform (std::hash is 32 bits on armhf, too weak to skip a write on a match)
+uint64_t InventoryCache::valueHash(std::string_view value)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : value) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+InventoryCache::InventoryCache(size_t maxEntries)
+    : m_maxEntries(maxEntries)
+{
+}
+
+uint64_t InventoryCache::entryKey(const std::string& keytag, bool readOnly)
+{
+    // hashed, not interned: keytags come from the bus and are not a bounded set
+    return (valueHash(keytag) << 1) | (readOnly ? 1 : 0);
+}
+
+InventoryCache::Device* InventoryCache::find(const std::string& deviceName)
+{
+    auto found = m_index.find(deviceName);
+    if (found == m_index.end()) {
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, found->second);
+    return &*found->second;
+}
+
+bool InventoryCache::contains(
+    const std::string& deviceName, const std::string& keytag, bool readOnly, const std::string& value)
+{
+    Device* device = find(deviceName);
+    if (!device) {
+        return false;
+    }
+
+    const uint64_t key   = entryKey(keytag, readOnly);
+    auto           entry = std::lower_bound(device->entries.begin(), device->entries.end(), key,
+        [](const Entry& e, uint64_t k) {
+            return e.key < k;
+        });
+    return entry != device->entries.end() && entry->key == key && entry->valueHash == valueHash(value);
+}
+
+void InventoryCache::store(
+    const std::string& deviceName, const std::string& keytag, bool readOnly, const std::string& value)
+{
+    Device* device = find(deviceName);
+    if (!device) {
+        m_lru.push_front({deviceName, {}});
+        device = &m_lru.front();
+        m_index.emplace(device->name, m_lru.begin());
+    }
+
+    const uint64_t key   = entryKey(keytag, readOnly);
+    auto           entry = std::lower_bound(device->entries.begin(), device->entries.end(), key,
+        [](const Entry& e, uint64_t k) {
+            return e.key < k;
+        });
+    if (entry != device->entries.end() && entry->key == key) {
+        entry->valueHash = valueHash(value);
+        return;
+    }
+
+    device->entries.insert(entry, {key, valueHash(value)});
+    if (++m_entries > m_maxEntries) {
+        evict();
+    }
+}
+
+void InventoryCache::erase(const std::string& deviceName)
+{
+    auto found = m_index.find(deviceName);
+    if (found == m_index.end()) {
+        return;
+    }
+    m_entries -= found->second->entries.size();
+    m_lru.erase(found->second);
+    m_index.erase(found);
+}
+
+void InventoryCache::clear()
+{
+    m_index.clear();
+    m_lru.clear();
+    m_entries = 0;
+}
+
+void InventoryCache::evict()
+{
+    // the most recently used device stays, even if alone above the limit
+    while (m_entries > m_maxEntries && m_lru.size() > 1) {
+        Device& device = m_lru.back();
+        m_entries -= device.entries.size();
+        m_index.erase(device.name);
+        m_lru.pop_back();
+    }
+}
+
+} // namespace fty
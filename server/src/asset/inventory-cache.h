@@ -0,0 +1,101 @@
+/*  =========================================================================
+    asset_inventory_cache - asset/inventory-cache
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+/// Last inventory values written to DB, used to skip unchanged attributes
+///
+/// Two levels: device -> (keytag, read-only flag) -> hash of the value. Only hashes of keytags and values
+/// are kept, so an entry is 16 bytes whatever they are. Devices are kept in LRU
+/// order and the least recently used ones are evicted when the number of entries exceeds the limit;
+/// forgetting a device only costs a redundant write of its next inventory.
+/// Not thread safe.
+class InventoryCache
+{
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 256 * 1024;
+
+    explicit InventoryCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    /// true if value is the last one stored for this attribute
+    bool contains(const std::string& deviceName, const std::string& keytag, bool readOnly,
+        const std::string& value);
+
+    void store(const std::string& deviceName, const std::string& keytag, bool readOnly, const std::string& value);
+
+    /// forgets a device
+    void erase(const std::string& deviceName);
+
+    void clear();
+
+    /// number of attributes
+    size_t size() const
+    {
+        return m_entries;
+    }
+
+    size_t devices() const
+    {
+        return m_lru.size();
+    }
+
+    /// hash of the values kept in cache
+    static uint64_t valueHash(std::string_view value);
+
+private:
+    struct Entry
+    {
+        uint64_t key; // keytag hash << 1 | read-only
+        uint64_t valueHash;
+    };
+
+    struct Device
+    {
+        std::string        name;
+        std::vector<Entry> entries; // sorted by key
+    };
+
+    using Lru = std::list<Device>;
+
+    static uint64_t entryKey(const std::string& keytag, bool readOnly);
+
+    /// device moved to the front of the LRU list, nullptr if unknown
+    Device* find(const std::string& deviceName);
+
+    void evict();
+
+    size_t m_maxEntries;
+    size_t m_entries = 0;
+    Lru    m_lru; // most recently used first
+
+    // keys are views on Device::name, list nodes do not move
+    std::unordered_map<std::string_view, Lru::iterator> m_index;
+};
+
+} // namespace fty
@@ -0,0 +1,176 @@
+/*  =========================================================================
+    asset_inventory_writer - asset/inventory-writer
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "inventory-writer.h"
+#include "asset-journal.h"
+#include "asset/dbhelpers.h"
+#include <cstring>
+#include <fty_log.h>
+#include <vector>
+
+namespace fty {
+
+// flush before the window elapsed when that many attributes are pending
+static constexpr size_t MAX_PENDING = 4096;
+
+constexpr std::chrono::milliseconds InventoryWriter::DEFAULT_WINDOW;
+
+InventoryWriter::InventoryWriter(bool test)
+    : m_test(test)
+{
+}
+
+InventoryWriter::InventoryWriter(Write write)
+    : m_write(std::move(write))
+{
+}
+
+void InventoryWriter::setTest(bool test)
+{
+    m_test = test;
+}
+
+void InventoryWriter::setWindow(std::chrono::milliseconds window)
+{
+    m_window = window;
+}
+
+void InventoryWriter::add(const std::string& deviceName, zhash_t* extAttributes, bool readOnly)
+{
+    std::map<std::string, Pending>* device = nullptr;
+
+    for (void* it = zhash_first(extAttributes); it != NULL; it = zhash_next(extAttributes)) {
+        const char* value     = static_cast<const char*>(it);
+        const char* keytag    = zhash_cursor(extAttributes);
+        bool        readOnlyV = readOnly;
+        if (strcmp(keytag, "name") == 0 || strcmp(keytag, "description") == 0) {
+            readOnlyV = false;
+        }
+
+        if (!device) {
+            device = &m_pending[deviceName];
+        }
+
+        auto pending = device->find(keytag);
+        if (pending != device->end()) {
+            pending->second = {value, readOnlyV};
+            continue;
+        }
+
+        // unchanged since last write
+        if (m_written.contains(deviceName, keytag, readOnlyV, value)) {
+            continue;
+        }
+
+        if (m_pendingCount == 0) {
+            m_oldest = Clock::now();
+        }
+        device->emplace(keytag, Pending{value, readOnlyV});
+        ++m_pendingCount;
+    }
+
+    if (device && device->empty()) {
+        m_pending.erase(deviceName);
+    }
+}
+
+void InventoryWriter::remove(const std::string& deviceName)
+{
+    auto pending = m_pending.find(deviceName);
+    if (pending != m_pending.end()) {
+        m_pendingCount -= pending->second.size();
+        m_pending.erase(pending);
+    }
+
+    m_written.erase(deviceName);
+}
+
+int InventoryWriter::timeout() const
+{
+    if (m_pendingCount == 0) {
+        return -1;
+    }
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(m_oldest + m_window - Clock::now());
+    return left.count() > 0 ? int(left.count()) : 0;
+}
+
+void InventoryWriter::flushIfDue()
+{
+    if (m_pendingCount > 0 && (m_pendingCount >= MAX_PENDING || timeout() == 0)) {
+        flush();
+    }
+}
+
+bool InventoryWriter::flush()
+{
+    if (m_pendingCount == 0) {
+        return true;
+    }
+
+    std::vector<InventoryAttribute> attributes;
+    attributes.reserve(m_pendingCount);
+    for (const auto& device : m_pending) {
+        for (const auto& attr : device.second) {
+            // merged back to the last written value
+            if (m_written.contains(device.first, attr.first, attr.second.readOnly, attr.second.value)) {
+                continue;
+            }
+            attributes.push_back({device.first, attr.first, attr.second.value, attr.second.readOnly});
+        }
+    }
+    m_pending.clear();
+    m_pendingCount = 0;
+
+    if (attributes.empty()) {
+        return true;
+    }
+
+    std::vector<bool> written;
+    int               ret = m_write ? m_write(attributes, written) : process_insert_inventory(attributes, written, m_test);
+    if (ret != 0) {
+        log_error("Could not insert inventory data into DB");
+        return false;
+    }
+
+    // attributes are grouped by device
+    size_t count = 0;
+    for (size_t i = 0; i < attributes.size();) {
+        const std::string& deviceName = attributes[i].device_name;
+
+        bool changed = false;
+        for (; i < attributes.size() && attributes[i].device_name == deviceName; ++i) {
+            if (written[i]) {
+                const InventoryAttribute& attr = attributes[i];
+                m_written.store(deviceName, attr.keytag, attr.read_only, attr.value);
+                changed = true;
+                ++count;
+            }
+        }
+        if (changed) {
+            ChangeJournal::instance().record(deviceName, ChangeJournal::Change::Updated);
+        }
+    }
+
+    log_debug("inventory: %zu of %zu attributes written", count, attributes.size());
+    return true;
+}
+
+} // namespace fty
@@ -0,0 +1,101 @@
+/*  =========================================================================
+    asset_inventory_writer - asset/inventory-writer
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+#include "inventory-cache.h"
+#include <chrono>
+#include <czmq.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+struct InventoryAttribute;
+
+namespace fty {
+
+/// Write pipeline of the inventory actor
+///
+/// Inventory messages come in bursts, often repeating the same values. Attributes are merged per device
+/// (last value wins) for a short window, then the ones which differ from what was last written are flushed
+/// as multi-row upserts in one transaction. Each attribute is still written (or logged as failed) on its
+/// own, and written devices are recorded in the change journal after the commit, as before.
+/// Pending attributes are written when the window elapsed, when too many are pending and on flush()
+/// (actor termination); they are dropped when their device is deleted.
+/// Inventory values reach the DB up to one window after their message (1 s by default, see setWindow()). Other
+/// writers (REST, import) are not ordered with them: an attribute they change during the window is overwritten
+/// by the pending inventory value, as if the inventory message came after the change.
+/// Not thread safe, owned by the inventory actor.
+class InventoryWriter
+{
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_WINDOW{1000};
+
+    /// writes attributes in one transaction, as process_insert_inventory()
+    using Write = std::function<int(const std::vector<InventoryAttribute>& attributes, std::vector<bool>& written)>;
+
+    explicit InventoryWriter(bool test = false);
+
+    /// writes with `write` instead of the DB
+    explicit InventoryWriter(Write write);
+
+    void setTest(bool test);
+
+    /// coalescing window, 0 writes every message at once
+    void setWindow(std::chrono::milliseconds window);
+
+    /// merges the ext attributes of an inventory message with the pending ones
+    void add(const std::string& deviceName, zhash_t* extAttributes, bool readOnly);
+
+    /// forgets pending and cached attributes of a deleted device
+    void remove(const std::string& deviceName);
+
+    /// ms until the next flush is due (for zpoller_wait), -1 if nothing is pending
+    int timeout() const;
+
+    /// flushes if the window of the oldest pending attribute elapsed
+    void flushIfDue();
+
+    /// writes all pending attributes, returns false on DB error
+    bool flush();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending
+    {
+        std::string value;
+        bool        readOnly;
+    };
+
+    Write                     m_write;
+    bool                      m_test   = false;
+    std::chrono::milliseconds m_window = DEFAULT_WINDOW;
+    Clock::time_point         m_oldest;
+    size_t                    m_pendingCount = 0;
+
+    // device name -> keytag -> pending value
+    std::map<std::string, std::map<std::string, Pending>> m_pending;
+    // last written values
+    InventoryCache m_written;
+};
+
+} // namespace fty
@@ -34,6 +34,7 @@
 #include "fty_asset_server.h"
 #include <fty_log.h>
 #include <cxxtools/jsonserializer.h>
+#include <algorithm>
 
 #define INPUT_POWER_CHAIN     1
 #define AGENT_ASSET_ACTIVATOR "etn-licensing-credits"
@@ -225,65 +226,113 @@ int process_insert_inventory(
     return 0;
 }
 
+#define SQL_EXT_ATT_INVENTORY_ROWS                                                                           \
+    " INSERT INTO"                                                                                           \
+    "   t_bios_asset_ext_attributes"                                                                         \
+    "   (keytag, value, id_asset_element, read_only)"                                                        \
+    " VALUES"
+
+#define SQL_EXT_ATT_INVENTORY_UPDATE                                                                         \
+    " ON DUPLICATE KEY"                                                                                      \
+    "   UPDATE "                                                                                             \
+    "       value = VALUES (value),"                                                                         \
+    "       read_only = VALUES (read_only)"
+
+// rows of one multi-row upsert, bounds the statement size and the number of cached statements
+static constexpr size_t INVENTORY_CHUNK = 64;
+
 /**
- *  \brief Inserts ext attributes from inventory message into DB only
- *         if the new value is different from the cache map
- *         This method is not thread safe.
+ *  \brief Multi-row upsert of inventory ext attributes
  *
- *  \param[in] device_name - iname of assets
- *  \param[in] ext_attributes - recent ext attributes for this asset
- *  \param[in] read_only - whether to insert ext attributes as readonly
+ *  Row i binds :ki (keytag), :vi (value), :di (device name) and :ri (read only).
+ *
+ *  \param[in] rows - number of rows of the statement
+ */
+std::string inventory_upsert_sql(size_t rows)
+{
+    std::string sql = SQL_EXT_ATT_INVENTORY_ROWS;
+    for (size_t i = 0; i < rows; ++i) {
+        const std::string n = std::to_string(i);
+        sql += (i ? ", " : " ");
+        sql += "(:k" + n + ", :v" + n + ", (SELECT id_asset_element FROM t_bios_asset_element WHERE name=:d" + n +
+               "), :r" + n + ")";
+    }
+    return sql + SQL_EXT_ATT_INVENTORY_UPDATE;
+}
+
+/**
+ *  \brief Inserts ext attributes of several assets into DB in one transaction
+ *
+ *  Attributes are written by chunks of multi-row upserts. When a chunk fails (i.e. one of its assets
+ *  does not exist anymore), its rows are written one by one, so as with one statement per attribute
+ *  a bad attribute does not prevent the others from being written.
+ *
+ *  \param[in] attributes - ext attributes to write
+ *  \param[out] written - flag for each attribute, set if attribute was written to DB
  *  \param[in] test - unit tests indicator
- *  \param[in] map_cache -  cache map
  *
  *  \return  0 - in case of success
- *          -1 - in case of some unexpected error
+ *          -1 - in case of some unexpected error, nothing was written
  */
-int process_insert_inventory(const std::string& device_name, zhash_t* ext_attributes, bool readonly,
-    std::unordered_map<std::string, std::string>& map_cache, bool test)
+int process_insert_inventory(
+    const std::vector<InventoryAttribute>& attributes, std::vector<bool>& written, bool test)
 {
-    if (test)
+    written.assign(attributes.size(), false);
+    if (test || attributes.empty())
         return 0;
-    tntdb::Connection conn;
-    try {
-        conn = tntdb::connectCached(DBConn::url);
-    } catch (const std::exception& e) {
-        log_error("DB: cannot connect, %s", e.what());
-        return -1;
-    }
-
-    tntdb::Transaction trans(conn);
-    tntdb::Statement   st = conn.prepareCached(SQL_EXT_ATT_INVENTORY);
 
-    for (void* it = zhash_first(ext_attributes); it != NULL; it = zhash_next(ext_attributes)) {
-        const char* value     = static_cast<const char*>(it);
-        const char* keytag    = zhash_cursor(ext_attributes);
-        bool        readonlyV = readonly;
-        if (strcmp(keytag, "name") == 0 || strcmp(keytag, "description") == 0)
-            readonlyV = false;
+    // reported only once committed
+    std::vector<bool> executed(attributes.size(), false);
+    try {
+        tntdb::Connection  conn = tntdb::connectCached(DBConn::url);
+        tntdb::Transaction trans(conn);
+
+        for (size_t first = 0; first < attributes.size(); first += INVENTORY_CHUNK) {
+            const size_t count = std::min(INVENTORY_CHUNK, attributes.size() - first);
+
+            try {
+                tntdb::Statement st = conn.prepareCached(inventory_upsert_sql(count));
+                for (size_t i = 0; i < count; ++i) {
+                    const InventoryAttribute& attr = attributes[first + i];
+                    const std::string         n    = std::to_string(i);
+                    st.set("k" + n, attr.keytag)
+                        .set("v" + n, attr.value)
+                        .set("d" + n, attr.device_name)
+                        .set("r" + n, attr.read_only);
+                }
+                st.execute();
+                std::fill_n(executed.begin() + long(first), count, true);
+                continue;
+            } catch (const std::exception& e) {
+                log_debug("inventory upsert of %zu attributes failed, retry one by one: %s", count, e.what());
+            }
 
-        std::string cache_key = device_name;
-        cache_key.append(":").append(keytag).append(readonlyV ? "1" : "0");
-        auto el = map_cache.find(cache_key);
-        if (el != map_cache.end() && el->second == value)
-            continue;
-        try {
-            st.set("keytag", keytag)
-                .set("value", value)
-                .set("device_name", device_name)
-                .set("readonly", readonlyV)
-                .execute();
-            map_cache[cache_key] = value;
-        } catch (const std::exception& e) {
-            log_warning("%s:\texception on updating %s {%s, %s}\n\t%s", "", device_name.c_str(), keytag,
-                value, e.what());
-            continue;
+            tntdb::Statement st = conn.prepareCached(SQL_EXT_ATT_INVENTORY);
+            for (size_t i = first; i < first + count; ++i) {
+                const InventoryAttribute& attr = attributes[i];
+                try {
+                    st.set("keytag", attr.keytag)
+                        .set("value", attr.value)
+                        .set("device_name", attr.device_name)
+                        .set("readonly", attr.read_only)
+                        .execute();
+                    executed[i] = true;
+                } catch (const std::exception& e) {
+                    log_warning("%s:\texception on updating %s {%s, %s}\n\t%s", "", attr.device_name.c_str(),
+                        attr.keytag.c_str(), attr.value.c_str(), e.what());
+                }
+            }
         }
-    }
 
-    trans.commit();
+        trans.commit();
+    } catch (const std::exception& e) {
+        log_error("DB: cannot write inventory, %s", e.what());
+        return -1;
+    }
+    written = std::move(executed);
     return 0;
 }
+
 /**
  *  \brief Selects user-friendly name for given asset name
  *
@@ -36,6 +36,7 @@
 #include "fty_asset_inventory.h"
 
 #define DEFAULT_LOG_CONFIG "/etc/fty/ftylog.cfg"
+#define DEFAULT_JOURNAL "/var/lib/fty/fty-asset/changes.journal"
 
 static int
 s_autoupdate_timer (zloop_t * /*loop*/, int /*timer_id*/, void *output)
@@ -91,8 +92,18 @@ int main (int argc, char *argv [])
     zsock_wait (asset_server);
     zstr_sendx (asset_server, "CONNECTMAILBOX", endpoint, NULL);
     zsock_wait (asset_server);
+
+    // change journal used by incremental SRR save
+    char *journal = getenv("BIOS_ASSETS_JOURNAL");
+    zstr_sendx (asset_server, "JOURNAL", journal ? journal : DEFAULT_JOURNAL, NULL);
+
     zstr_sendx (asset_server, "REPEAT_ALL", NULL);
 
+    // SRR payload encoding (json, binary)
+    char *srr_encoding = getenv("BIOS_ASSETS_SRR_ENCODING");
+    if (srr_encoding)
+        zstr_sendx (asset_server, "SRR_ENCODING", srr_encoding, NULL);
+
     zactor_t *autoupdate_server = zactor_new (fty_asset_autoupdate_server, static_cast<void*>( const_cast<char*>("asset-autoupdate")));
     zstr_sendx (autoupdate_server, "CONNECT", endpoint, NULL);
     zsock_wait (autoupdate_server);
@@ -109,6 +120,12 @@ int main (int argc, char *argv [])
     zstr_sendx (inventory_server, "CONNECT", endpoint, NULL);
     zsock_wait (inventory_server);
     zstr_sendx (inventory_server, "CONSUMER", "ASSETS", ".*", NULL);
+    zsock_wait (inventory_server);
+
+    // coalescing window of inventory updates, msec
+    char *inventory_window = getenv("BIOS_ASSETS_INVENTORY_WINDOW");
+    if (inventory_window)
+        zstr_sendx (inventory_server, "WINDOW", inventory_window, NULL);
 
     // create regular event for autoupdate agent
     zloop_t *loop = zloop_new();
@@ -38,6 +38,7 @@
 #include "fty_log.h"
 #include "fty_proto.h"
 #include "asset/dbhelpers.h"
+#include "asset/inventory-writer.h"
 
 
 //  Structure of our class
@@ -48,15 +49,15 @@ fty_asset_inventory_server (zsock_t *pipe, void *args)
     char *name = strdup (static_cast<const char*>(args));
     mlm_client_t *client = mlm_client_new ();
     zpoller_t *poller = zpoller_new (pipe, mlm_client_msgpipe (client), NULL);
-    bool test = false;
-    std::unordered_map<std::string, std::string> ext_map_cache;
+    fty::InventoryWriter writer;
 
     zsock_signal (pipe, 0);
     log_info ("%s:\tStarted", name);
 
     while (!zsys_interrupted)
     {
-        void *which = zpoller_wait (poller, -1);
+        void *which = zpoller_wait (poller, writer.timeout ());
+        writer.flushIfDue ();
         if (!which)
             continue;
         else
@@ -95,7 +96,7 @@ fty_asset_inventory_server (zsock_t *pipe, void *args)
             if (streq (cmd, "CONSUMER")) {
                 char* stream = zmsg_popstr (msg);
                 char* pattern = zmsg_popstr (msg);
-                test = streq (stream, "ASSETS-TEST");
+                writer.setTest (streq (stream, "ASSETS-TEST"));
                 [[maybe_unused]] int rv = mlm_client_set_consumer (client, stream, pattern);
                 if (rv == -1) {
                     log_error ("%s:\tCan't set consumer on stream '%s', '%s'", name, stream, pattern);
@@ -105,6 +106,13 @@ fty_asset_inventory_server (zsock_t *pipe, void *args)
                 zsock_signal (pipe, 0);
             }
             else
+            if (streq (cmd, "WINDOW")) {
+                //  coalescing window of inventory updates, in ms
+                char* window = zmsg_popstr (msg);
+                writer.setWindow (std::chrono::milliseconds (window ? atoi (window) : 0));
+                zstr_free (&window);
+            }
+            else
             {
                 log_info ("%s:\tUnhandled command %s", name, cmd);
             }
@@ -125,23 +133,19 @@ fty_asset_inventory_server (zsock_t *pipe, void *args)
 
             if (streq (operation, "inventory")) {
                 zhash_t *ext = fty_proto_ext (proto);
-                [[maybe_unused]] int rv = process_insert_inventory (device_name, ext, true, ext_map_cache, test);
-                if (rv != 0)
-                    log_error ("Could not insert inventory data into DB");
+                writer.add (device_name, ext, true);
             } else if (streq (operation, "delete")) {
-                //  Vacuum the cache
-                //  The keys are formatted as asset_name:keytag[01]
-                device_name.append(":");
-                for (auto it = ext_map_cache.begin(); it != ext_map_cache.end(); )
-                    if (it->first.compare(0, device_name.size(), device_name) == 0)
-                        it = ext_map_cache.erase(it);
-                    else
-                        ++it;
+                //  Vacuum pending updates and the cache
+                writer.remove (device_name);
             }
             fty_proto_destroy (&proto);
+            writer.flushIfDue ();
         }
     }
 
+    //  nothing pending is lost on termination
+    writer.flush ();
+
     mlm_client_destroy (&client);
     zpoller_destroy (&poller);
     zstr_free (&name);
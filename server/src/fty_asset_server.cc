@@ -145,6 +145,28 @@
         /asset1/asset2/asset3       - republish asset information about asset1 asset2 and asset3
         /$all                       - republish information about all assets
 
+     ------------------------------------------------------------------------
+     ## SNAPSHOT
+
+     write or load a binary snapshot of the whole inventory (assets, ext attributes, links and groups):
+         subject: "SNAPSHOT"
+         message: is a multipart string message A/B
+                 A = "SAVE"/"LOAD" - mandatory
+                 B = name of the snapshot file in /var/lib/fty/fty-asset/snapshots on agent side,
+                     without directory - mandatory
+
+     reply in "OK" case:
+         subject: "SNAPSHOT"
+         message: is a multipart message A/B
+                 A = "OK" - mandatory
+                 B = snapshot size in bytes (SAVE) / number of restored assets (LOAD) - mandatory
+
+     reply in "ERROR" case:
+         subject: "SNAPSHOT"
+         message: is a multipart message A/B
+                 A = "ERROR" - mandatory
+                 B = "BAD_COMMAND"/reason - mandatory
+
      ------------------------------------------------------------------------
      ## ENAME_FROM_INAME
 
@@ -193,12 +215,15 @@
 #include "fty_asset_autoupdate.h"
 
 #include "asset-server.h"
+#include "asset/asset-journal.h"
+#include "asset/asset-snapshot.h"
 #include "asset/asset-utils.h"
 
 #include <ctime>
 #include <string>
 
 #include <fty_asset_dto.h>
+#include <fty_asset_id_resolver.h>
 #include <fty_common.h>
 #include <fty_common_db_uptime.h>
 #include <fty_common_messagebus.h>
@@ -703,6 +728,49 @@ static void s_handle_subject_assets(const fty::AssetServer& server, zmsg_t* msg)
     zmsg_destroy(&reply);
 }
 
+static void s_handle_subject_snapshot(fty::AssetServer& server, zmsg_t* msg)
+{
+    assert (msg);
+
+    const std::string& client_name = server.getAgentName();
+
+    char*       command_str = zmsg_popstr(msg);
+    char*       name_str    = zmsg_popstr(msg);
+    std::string command(command_str ? command_str : "");
+    std::string name(name_str ? name_str : "");
+    zstr_free(&command_str);
+    zstr_free(&name_str);
+
+    zmsg_t* reply = zmsg_new();
+    if (name.empty() || (command != "SAVE" && command != "LOAD")) {
+        log_error("%s:	SNAPSHOT: bad command '%s'", client_name.c_str(), command.c_str());
+        zmsg_addstr(reply, "ERROR");
+        zmsg_addstr(reply, "BAD_COMMAND");
+    } else {
+        try {
+            // any client of the mailbox may send it: only files of the snapshot directory are accessed
+            std::string path  = fty::SnapshotFile::path(fty::SnapshotFile::DIR, name);
+            size_t      count = (command == "SAVE") ? server.saveSnapshotFile(path) : server.restoreSnapshotFile(path);
+            log_info("%s:	SNAPSHOT %s '%s' done (%zu)", client_name.c_str(), command.c_str(), path.c_str(), count);
+            zmsg_addstr(reply, "OK");
+            zmsg_addstr(reply, std::to_string(count).c_str());
+        } catch (const std::exception& e) {
+            log_error("%s:	SNAPSHOT %s '%s' failed: %s", client_name.c_str(), command.c_str(), name.c_str(), e.what());
+            zmsg_addstr(reply, "ERROR");
+            zmsg_addstr(reply, e.what());
+        }
+    }
+
+    [[maybe_unused]] int rv = mlm_client_sendto(const_cast<mlm_client_t*>(server.getMailboxClient()),
+        mlm_client_sender(const_cast<mlm_client_t*>(server.getMailboxClient())), "SNAPSHOT", NULL, 5000, &reply);
+
+    if (rv == -1) {
+        log_error("%s:	SNAPSHOT: mlm_client_sendto failed", client_name.c_str());
+    }
+
+    zmsg_destroy(&reply);
+}
+
 static zmsg_t* s_publish_create_or_update_asset_msg(const std::string& client_name,
     const std::string& asset_name, const char* operation, std::string& subject, bool test_mode,
     bool /*read_only*/)
@@ -1119,6 +1187,31 @@ static void s_handle_subject_asset_manipulation(const fty::AssetServer& server,
     zmsg_destroy(&reply);
 }
 
+// changes published on the stream by other agents never go through AssetServer::sendNotification
+static void s_journal_foreign_change(const fty::AssetServer& server, fty_proto_t* msg)
+{
+    const char* sender = mlm_client_sender(const_cast<mlm_client_t*>(server.getStreamClient()));
+    if (!sender || server.getAgentName() + "-stream" == sender) {
+        return;
+    }
+
+    const char* operation = fty_proto_operation(msg);
+    if (streq(operation, FTY_PROTO_ASSET_OP_CREATE) || streq(operation, FTY_PROTO_ASSET_OP_UPDATE)) {
+        fty::ChangeJournal::instance().record(fty_proto_name(msg), fty::ChangeJournal::Change::Updated);
+    } else if (streq(operation, FTY_PROTO_ASSET_OP_DELETE)) {
+        fty::ChangeJournal::instance().record(fty_proto_name(msg), fty::ChangeJournal::Change::Deleted);
+    }
+}
+
+// assets deleted by other processes (or recreated under the same name) must not be resolved to their old id
+static void s_invalidate_asset_id(fty_proto_t* msg)
+{
+    const char* operation = fty_proto_operation(msg);
+    if (streq(operation, FTY_PROTO_ASSET_OP_DELETE) || streq(operation, FTY_PROTO_ASSET_OP_UPDATE)) {
+        fty::AssetIdResolver::instance().invalidate(fty_proto_name(msg));
+    }
+}
+
 static void s_update_topology(const fty::AssetServer& server, fty_proto_t* msg)
 {
     assert (msg);
@@ -1289,6 +1382,20 @@ void fty_asset_server(zsock_t* pipe, void* args)
 
                 zstr_free(&endpoint);
                 zsock_signal(pipe, 0);
+            } else if (streq(cmd, "SRR_ENCODING")) {
+                char* encoding = zmsg_popstr(msg);
+                if (encoding && streq(encoding, "binary")) {
+                    server.setSrrEncoding(fty::AssetServer::SrrEncoding::Binary);
+                } else {
+                    server.setSrrEncoding(fty::AssetServer::SrrEncoding::Json);
+                }
+                zstr_free(&encoding);
+            } else if (streq(cmd, "JOURNAL")) {
+                char* path = zmsg_popstr(msg);
+                if (path && *path) {
+                    fty::ChangeJournal::instance().open(path);
+                }
+                zstr_free(&path);
             } else if (streq(cmd, "REPEAT_ALL")) {
                 s_repeat_all(server);
                 log_debug("%s:\tREPEAT_ALL end", server.getAgentName().c_str());
@@ -1350,6 +1457,8 @@ void fty_asset_server(zsock_t* pipe, void* args)
                 s_handle_subject_asset_manipulation(server, &zmessage);
             } else if (subject == "ASSET_DETAIL") {
                 s_handle_subject_asset_detail(server, &zmessage);
+            } else if (subject == "SNAPSHOT") {
+                s_handle_subject_snapshot(server, zmessage);
             } else {
                 log_info("%s:\tUnexpected subject '%s'", server.getAgentName().c_str(), subject.c_str());
             }
@@ -1362,6 +1471,8 @@ void fty_asset_server(zsock_t* pipe, void* args)
             if (fty_proto_is(zmessage)) {
                 fty_proto_t* bmsg = fty_proto_decode(&zmessage);
                 if (fty_proto_id(bmsg) == FTY_PROTO_ASSET) {
+                    s_journal_foreign_change(server, bmsg);
+                    s_invalidate_asset_id(bmsg);
                     s_update_topology(server, bmsg);
                 } else if (fty_proto_id(bmsg) == FTY_PROTO_METRIC) {
                     handle_incoming_limitations(server, bmsg);
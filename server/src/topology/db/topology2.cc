@@ -150,8 +150,8 @@ void operator<<= (cxxtools::SerializationInfo &si, const Item &asset)
     si.addMember("name") <<= asset.name;
     si.addMember("id") <<= asset.id;
     si.addMember ("asset_order") <<= asset.asset_order;
-    si.addMember("type") <<= asset.type;
-    si.addMember("sub_type") <<= asset.subtype;
+    si.addMember("type") <<= asset.type.str();
+    si.addMember("sub_type") <<= asset.subtype.str();
     if (!asset.contains.empty ())
     {
         si.addMember("contains") <<= asset.contains;
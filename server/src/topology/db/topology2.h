@@ -32,6 +32,7 @@
 #include <cxxtools/serializationinfo.h>
 #include <algorithm>
 #include <fty_common.h>
+#include <fty_asset_symbol.h>
 
 #include <tntdb.h>
 
@@ -61,7 +62,7 @@ struct Item
         }
 
         void push_back (const Item &it) {
-            int typeId = persist::type_to_typeid (it.type);
+            int typeId = persist::type_to_typeid (it.type.str ());
             switch (typeId) {
                 case persist::asset_type::ROOM:
                     rooms.push_back (it);
@@ -108,8 +109,9 @@ struct Item
 
     std::string id;
     std::string name;
-    std::string subtype;
-    std::string type;
+    // interned, shared with asset DTOs
+    fty::Symbol subtype;
+    fty::Symbol type;
     Topology contains;
     int asset_order;
     friend void operator<<= (cxxtools::SerializationInfo &si, const Item &asset);
@@ -0,0 +1,117 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "inventory-cache.h"
+
+using namespace fty;
+
+TEST_CASE("Inventory cache - value hash")
+{
+    // FNV-1a 64 reference values, same on every platform
+    REQUIRE(InventoryCache::valueHash("") == 0xcbf29ce484222325ULL);
+    REQUIRE(InventoryCache::valueHash("a") == 0xaf63dc4c8601ec8cULL);
+    REQUIRE(InventoryCache::valueHash("foobar") == 0x85944171f73967e8ULL);
+}
+
+TEST_CASE("Inventory cache - values")
+{
+    InventoryCache cache;
+
+    cache.store("ups-1", "model", true, "9PX");
+    REQUIRE(cache.contains("ups-1", "model", true, "9PX"));
+    REQUIRE(!cache.contains("ups-1", "model", true, "9SX"));
+    REQUIRE(!cache.contains("ups-1", "model", false, "9PX"));
+    REQUIRE(!cache.contains("ups-1", "serial_no", true, "9PX"));
+    REQUIRE(!cache.contains("ups-2", "model", true, "9PX"));
+
+    std::string big(4096, 'x');
+    cache.store("ups-1", "description", false, big);
+    REQUIRE(cache.contains("ups-1", "description", false, big));
+
+    cache.erase("ups-1");
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.devices() == 0);
+    REQUIRE(!cache.contains("ups-1", "model", true, "9PX"));
+}
+
+TEST_CASE("Inventory cache - attributes of a known device")
+{
+    InventoryCache cache;
+
+    // new attributes go to the entries of the device, the device is not added again
+    cache.store("ups-1", "model", true, "9PX");
+    cache.store("ups-1", "serial_no", true, "G123");
+    cache.store("ups-1", "model", false, "9PX");
+    REQUIRE(cache.devices() == 1);
+    REQUIRE(cache.size() == 3);
+
+    // a new value replaces the one of the attribute
+    cache.store("ups-1", "model", true, "9SX");
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.contains("ups-1", "model", true, "9SX"));
+    REQUIRE(!cache.contains("ups-1", "model", true, "9PX"));
+    REQUIRE(cache.contains("ups-1", "model", false, "9PX"));
+}
+
+TEST_CASE("Inventory cache - LRU eviction")
+{
+    InventoryCache cache(4);
+
+    cache.store("ups-1", "model", true, "9PX");
+    cache.store("ups-1", "serial_no", true, "G1");
+    cache.store("ups-2", "model", true, "9PX");
+    cache.store("ups-2", "serial_no", true, "G2");
+    REQUIRE(cache.size() == 4);
+    REQUIRE(cache.devices() == 2);
+
+    SECTION("least recently used device is evicted")
+    {
+        cache.store("ups-3", "model", true, "9PX");
+        REQUIRE(cache.devices() == 2);
+        REQUIRE(cache.size() == 3);
+        REQUIRE(!cache.contains("ups-1", "model", true, "9PX"));
+        REQUIRE(cache.contains("ups-2", "model", true, "9PX"));
+        REQUIRE(cache.contains("ups-3", "model", true, "9PX"));
+    }
+
+    SECTION("lookup makes a device most recently used")
+    {
+        REQUIRE(cache.contains("ups-1", "model", true, "9PX"));
+        cache.store("ups-3", "model", true, "9PX");
+        REQUIRE(cache.contains("ups-1", "serial_no", true, "G1"));
+        REQUIRE(!cache.contains("ups-2", "model", true, "9PX"));
+    }
+
+    SECTION("store makes a device most recently used")
+    {
+        cache.store("ups-1", "serial_no", true, "G1");
+        cache.store("ups-3", "model", true, "9PX");
+        REQUIRE(cache.contains("ups-1", "model", true, "9PX"));
+        REQUIRE(!cache.contains("ups-2", "model", true, "9PX"));
+    }
+
+    SECTION("most recently used device stays above the limit")
+    {
+        for (int i = 0; i < 8; ++i) {
+            cache.store("epdu-1", "outlet." + std::to_string(i), true, "on");
+        }
+        REQUIRE(cache.devices() == 1);
+        REQUIRE(cache.size() == 8);
+        REQUIRE(cache.contains("epdu-1", "outlet.0", true, "on"));
+    }
+}
@@ -0,0 +1,192 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "asset/dbhelpers.h"
+#include "asset-journal.h"
+#include "inventory-writer.h"
+#include <map>
+#include <set>
+#include <thread>
+
+using namespace fty;
+
+// records the writes instead of the DB
+struct FakeDb
+{
+    std::vector<std::vector<InventoryAttribute>> writes;
+    std::set<std::string>                        failing; // keytags not written
+    bool                                         error = false;
+
+    InventoryWriter::Write write()
+    {
+        return [this](const std::vector<InventoryAttribute>& attributes, std::vector<bool>& written) {
+            written.assign(attributes.size(), false);
+            if (error) {
+                return -1;
+            }
+            writes.push_back(attributes);
+            for (size_t i = 0; i < attributes.size(); ++i) {
+                written[i] = failing.count(attributes[i].keytag) == 0;
+            }
+            return 0;
+        };
+    }
+};
+
+static void add(InventoryWriter& writer, const std::string& device, const std::map<std::string, std::string>& ext,
+    bool readOnly = true)
+{
+    zhash_t* hash = zhash_new();
+    zhash_autofree(hash);
+    for (const auto& it : ext) {
+        zhash_insert(hash, it.first.c_str(), const_cast<char*>(it.second.c_str()));
+    }
+    writer.add(device, hash, readOnly);
+    zhash_destroy(&hash);
+}
+
+TEST_CASE("Inventory writer - coalescing")
+{
+    FakeDb          db;
+    InventoryWriter writer(db.write());
+    writer.setWindow(std::chrono::milliseconds(50));
+
+    REQUIRE(writer.timeout() == -1);
+
+    add(writer, "ups-1", {{"model", "9PX"}, {"serial_no", "G1"}, {"name", "UPS 1"}});
+    REQUIRE(writer.timeout() > 0);
+    add(writer, "ups-1", {{"model", "9SX"}});
+    add(writer, "ups-2", {{"model", "9PX"}});
+
+    // window not elapsed
+    writer.flushIfDue();
+    REQUIRE(db.writes.empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    REQUIRE(writer.timeout() == 0);
+    writer.flushIfDue();
+    REQUIRE(writer.timeout() == -1);
+
+    // one write, last value of each attribute, grouped by device
+    REQUIRE(db.writes.size() == 1);
+    const auto& written = db.writes[0];
+    REQUIRE(written.size() == 4);
+    REQUIRE(written[0].device_name == "ups-1");
+    REQUIRE(written[0].keytag == "model");
+    REQUIRE(written[0].value == "9SX");
+    REQUIRE(written[0].read_only);
+    REQUIRE(written[1].keytag == "name");
+    REQUIRE(!written[1].read_only);
+    REQUIRE(written[3].device_name == "ups-2");
+
+    SECTION("unchanged values are not written again")
+    {
+        add(writer, "ups-1", {{"model", "9SX"}, {"serial_no", "G1"}});
+        REQUIRE(writer.timeout() == -1);
+        REQUIRE(writer.flush());
+        REQUIRE(db.writes.size() == 1);
+    }
+
+    SECTION("value changed back within the window is not written")
+    {
+        add(writer, "ups-1", {{"model", "9PX"}});
+        add(writer, "ups-1", {{"model", "9SX"}});
+        REQUIRE(writer.flush());
+        REQUIRE(db.writes.size() == 1);
+    }
+
+    SECTION("deleted device is forgotten")
+    {
+        add(writer, "ups-1", {{"model", "9EX"}});
+        writer.remove("ups-1");
+        REQUIRE(writer.timeout() == -1);
+
+        // written again once recreated
+        add(writer, "ups-1", {{"model", "9SX"}});
+        REQUIRE(writer.flush());
+        REQUIRE(db.writes.size() == 2);
+        REQUIRE(db.writes[1].size() == 1);
+    }
+}
+
+TEST_CASE("Inventory writer - failed writes")
+{
+    FakeDb          db;
+    InventoryWriter writer(db.write());
+
+    SECTION("attribute not written is written again")
+    {
+        db.failing = {"serial_no"};
+        add(writer, "ups-1", {{"model", "9PX"}, {"serial_no", "G1"}});
+        REQUIRE(writer.flush());
+
+        db.failing.clear();
+        add(writer, "ups-1", {{"model", "9PX"}, {"serial_no", "G1"}});
+        REQUIRE(writer.flush());
+        REQUIRE(db.writes.size() == 2);
+        REQUIRE(db.writes[1].size() == 1);
+        REQUIRE(db.writes[1][0].keytag == "serial_no");
+    }
+
+    SECTION("nothing is cached when the transaction fails")
+    {
+        db.error = true;
+        add(writer, "ups-1", {{"model", "9PX"}});
+        REQUIRE(!writer.flush());
+        REQUIRE(writer.timeout() == -1);
+
+        db.error = false;
+        add(writer, "ups-1", {{"model", "9PX"}});
+        REQUIRE(writer.flush());
+        REQUIRE(db.writes.size() == 1);
+    }
+}
+
+TEST_CASE("Inventory writer - journal")
+{
+    FakeDb          db;
+    InventoryWriter writer(db.write());
+
+    db.failing = {"model"};
+    add(writer, "ups-1", {{"model", "9PX"}});
+    add(writer, "ups-2", {{"model", "9PX"}, {"serial_no", "G2"}});
+
+    uint64_t before = ChangeJournal::instance().sequence();
+    REQUIRE(writer.flush());
+
+    // only devices with attributes written are recorded, once
+    ChangeJournal::Changes changes;
+    REQUIRE(ChangeJournal::instance().since(before, changes));
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes.count("ups-2") == 1);
+    REQUIRE(ChangeJournal::instance().sequence() == before + 1);
+}
+
+TEST_CASE("Inventory writer - multi-row upsert")
+{
+    REQUIRE(inventory_upsert_sql(1).find("VALUES "
+                                         "(:k0, :v0, (SELECT id_asset_element FROM t_bios_asset_element "
+                                         "WHERE name=:d0), :r0) ON DUPLICATE KEY") != std::string::npos);
+
+    const std::string sql = inventory_upsert_sql(3);
+    for (const char* row : {"(:k0, :v0, ", "), (:k1, :v1, ", "), (:k2, :v2, "}) {
+        REQUIRE(sql.find(row) != std::string::npos);
+    }
+    REQUIRE(sql.find(":k3") == std::string::npos);
+    REQUIRE(sql.find("UPDATE") != std::string::npos);
+}
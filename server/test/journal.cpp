@@ -0,0 +1,168 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "asset-journal.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+using namespace fty;
+
+namespace fs = std::filesystem;
+
+static fs::path journalDir()
+{
+    return fs::temp_directory_path() / ("fty-asset-journal-" + std::to_string(getpid()));
+}
+
+TEST_CASE("Journal - changes since a sequence")
+{
+    ChangeJournal journal;
+
+    uint64_t start = journal.sequence();
+    REQUIRE(start == journal.origin());
+
+    uint64_t first = journal.record("ups-1", ChangeJournal::Change::Updated);
+    uint64_t mid   = journal.sequence();
+    journal.record("ups-2", ChangeJournal::Change::Updated);
+    journal.record("ups-1", ChangeJournal::Change::Deleted);
+
+    REQUIRE(first > start);
+    REQUIRE(journal.sequence() == start + 3);
+
+    ChangeJournal::Changes changes;
+    REQUIRE(journal.since(start, changes));
+    REQUIRE(changes.size() == 2);
+    CHECK(changes.at("ups-1").change == ChangeJournal::Change::Deleted);
+    CHECK(changes.at("ups-2").change == ChangeJournal::Change::Updated);
+
+    changes.clear();
+    REQUIRE(journal.since(mid, changes));
+    REQUIRE(changes.size() == 2);
+
+    changes.clear();
+    REQUIRE(journal.since(journal.sequence(), changes));
+    CHECK(changes.empty());
+
+    // not covered: before the journal, or after its last change (another journal)
+    CHECK(!journal.since(start - 1, changes));
+    CHECK(!journal.since(journal.sequence() + 1, changes));
+}
+
+TEST_CASE("Journal - file")
+{
+    fs::path dir = journalDir();
+    fs::remove_all(dir);
+
+    // missing directories are created
+    std::string path = (dir / "sub" / "changes.journal").string();
+
+    uint64_t origin   = 0;
+    uint64_t sequence = 0;
+    {
+        ChangeJournal journal;
+        journal.open(path);
+        REQUIRE(fs::exists(path));
+
+        origin = journal.origin();
+        journal.record("ups-1", ChangeJournal::Change::Updated);
+        sequence = journal.record("ups-2", ChangeJournal::Change::Deleted);
+    }
+
+    SECTION("reloaded")
+    {
+        ChangeJournal journal;
+        journal.open(path);
+
+        REQUIRE(journal.origin() == origin);
+        REQUIRE(journal.sequence() >= sequence);
+
+        ChangeJournal::Changes changes;
+        REQUIRE(journal.since(origin, changes));
+        REQUIRE(changes.size() == 2);
+        CHECK(changes.at("ups-1").change == ChangeJournal::Change::Updated);
+        CHECK(changes.at("ups-2").change == ChangeJournal::Change::Deleted);
+
+        REQUIRE(journal.record("ups-3", ChangeJournal::Change::Updated) > sequence);
+    }
+
+    SECTION("not closed")
+    {
+        // agent stopped without closing its journal: last line is not the end marker
+        std::string content;
+        {
+            std::ifstream in(path);
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        REQUIRE(content.size() > 4);
+        REQUIRE(content.compare(content.size() - 4, 4, "END\n") == 0);
+        {
+            std::ofstream out(path, std::ios::trunc);
+            out << content.substr(0, content.size() - 4);
+        }
+
+        ChangeJournal journal;
+        journal.open(path);
+
+        REQUIRE(journal.origin() > sequence);
+
+        ChangeJournal::Changes changes;
+        CHECK(!journal.since(origin, changes));
+        CHECK(!journal.since(sequence, changes));
+        CHECK(journal.since(journal.sequence(), changes));
+        CHECK(changes.empty());
+    }
+
+    SECTION("corrupted")
+    {
+        {
+            std::ofstream out(path, std::ios::app);
+            out << "garbage\n";
+            out << sequence + 1 << " U ups-3\n";
+        }
+
+        // changes after the bad line may be missing: a new journal starts after all known numbers
+        ChangeJournal journal;
+        journal.open(path);
+
+        REQUIRE(journal.origin() > sequence + 1);
+
+        ChangeJournal::Changes changes;
+        CHECK(!journal.since(origin, changes));
+        CHECK(!journal.since(sequence, changes));
+        CHECK(journal.since(journal.sequence(), changes));
+        CHECK(changes.empty());
+    }
+
+    SECTION("not a journal")
+    {
+        {
+            std::ofstream out(path, std::ios::trunc);
+            out << "something else\n";
+        }
+
+        ChangeJournal journal;
+        journal.open(path);
+
+        ChangeJournal::Changes changes;
+        CHECK(!journal.since(origin, changes));
+    }
+
+    fs::remove_all(dir);
+}
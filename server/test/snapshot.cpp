@@ -0,0 +1,163 @@
+/*  ========================================================================
+    Copyright (C) 2020 Eaton
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    ========================================================================
+*/
+
+#include <catch2/catch.hpp>
+
+#include "asset-snapshot.h"
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace fty;
+
+static Asset snapshotSample(int i)
+{
+    Asset asset;
+    asset.setInternalName("epdu-" + std::to_string(i));
+    asset.setAssetStatus(AssetStatus::Active);
+    asset.setAssetType(TYPE_DEVICE);
+    asset.setAssetSubtype(SUB_EPDU);
+    asset.setParentIname("rack-1");
+    asset.setAssetTag("tag-" + std::to_string(i));
+    asset.setSecondaryID("secondary");
+    asset.setPriority(3);
+    asset.setExtEntry("name", "ePDU " + std::to_string(i), false);
+    asset.setExtEntry("model", "G3", true);
+
+    AssetLink::ExtMap linkExt;
+    linkExt.emplace("label", ExtMapElement("A", true));
+    asset.addLink("ups-1", "2", "", 1, linkExt);
+    asset.addLink("feed-1", "", "", -1, {});
+    return asset;
+}
+
+static void requireSameAsset(const Asset& l, const Asset& r)
+{
+    REQUIRE(l.getInternalName() == r.getInternalName());
+    REQUIRE(l.getAssetStatus() == r.getAssetStatus());
+    REQUIRE(l.getAssetType() == r.getAssetType());
+    REQUIRE(l.getAssetSubtype() == r.getAssetSubtype());
+    REQUIRE(l.getParentIname() == r.getParentIname());
+    REQUIRE(l.getAssetTag() == r.getAssetTag());
+    REQUIRE(l.getSecondaryID() == r.getSecondaryID());
+    REQUIRE(l.getPriority() == r.getPriority());
+    REQUIRE(l.getExt() == r.getExt());
+    REQUIRE(l.getLinkedAssets() == r.getLinkedAssets());
+    for (size_t i = 0; i < l.getLinkedAssets().size(); ++i) {
+        REQUIRE(l.getLinkedAssets()[i].ext() == r.getLinkedAssets()[i].ext());
+    }
+}
+
+static std::string sampleSnapshot()
+{
+    SnapshotWriter writer;
+    writer.addAsset(snapshotSample(1));
+    writer.addAsset(snapshotSample(2));
+    writer.addGroupRelation("epdu-1", "group-1");
+    REQUIRE(writer.recordCount() == 3);
+    return writer.finish();
+}
+
+TEST_CASE("Snapshot - round trip")
+{
+    g_testMode = true;
+
+    const std::string snapshot = sampleSnapshot();
+
+    auto check = [](const char* data, size_t size) {
+        SnapshotReader reader(data, size);
+        REQUIRE(reader.majorVersion() == 1);
+        REQUIRE(reader.minorVersion() == 0);
+        REQUIRE(reader.recordCount() == 3);
+
+        std::vector<AssetImpl> assets;
+        GroupRelations         groups;
+        reader.read(assets, groups);
+
+        REQUIRE(assets.size() == 2);
+        requireSameAsset(assets[0], snapshotSample(1));
+        requireSameAsset(assets[1], snapshotSample(2));
+        REQUIRE(groups == GroupRelations{{"epdu-1", "group-1"}});
+    };
+
+    SECTION("buffer")
+    {
+        REQUIRE(SnapshotReader::isSnapshot(snapshot.data(), snapshot.size()));
+        check(snapshot.data(), snapshot.size());
+    }
+
+    SECTION("file")
+    {
+        namespace fs = std::filesystem;
+
+        // missing directories are created
+        fs::path dir = fs::temp_directory_path() / ("fty-asset-snapshot-" + std::to_string(getpid()));
+        fs::remove_all(dir);
+        std::string path = SnapshotFile::path((dir / "sub").string(), "inventory.snap");
+
+        SnapshotFile::write(path, snapshot);
+        {
+            SnapshotFile file(path);
+            REQUIRE(file.size() == snapshot.size());
+            check(file.data(), file.size());
+        }
+        REQUIRE(!fs::exists(path + ".tmp"));
+
+        fs::remove_all(dir);
+    }
+}
+
+TEST_CASE("Snapshot - versions")
+{
+    g_testMode = true;
+
+    std::string snapshot = sampleSnapshot();
+
+    // header: magic, u16 major, u16 minor
+    SECTION("newer minor version is read")
+    {
+        snapshot[10] = 7;
+        SnapshotReader reader(snapshot.data(), snapshot.size());
+        REQUIRE(reader.minorVersion() == 7);
+
+        std::vector<AssetImpl> assets;
+        GroupRelations         groups;
+        reader.read(assets, groups);
+        REQUIRE(assets.size() == 2);
+    }
+
+    SECTION("newer major version is rejected")
+    {
+        snapshot[8] = 2;
+        REQUIRE_THROWS_AS(SnapshotReader(snapshot.data(), snapshot.size()), std::runtime_error);
+    }
+
+    SECTION("not a snapshot")
+    {
+        REQUIRE(!SnapshotReader::isSnapshot("FTYASSET", 8));
+        REQUIRE_THROWS_AS(SnapshotReader(snapshot.data(), 16), std::runtime_error);
+    }
+}
+
+TEST_CASE("Snapshot - file names")
+{
+    REQUIRE(SnapshotFile::path("/var/lib/snapshots", "inventory.snap") == "/var/lib/snapshots/inventory.snap");
+    REQUIRE(SnapshotFile::path("/var/lib/snapshots", "..snap") == "/var/lib/snapshots/..snap");
+
+    for (const char* name : {"", ".", "..", "../etc/passwd", "sub/inventory.snap", "/etc/passwd"}) {
+        REQUIRE_THROWS_AS(SnapshotFile::path("/var/lib/snapshots", name), std::runtime_error);
+    }
+}